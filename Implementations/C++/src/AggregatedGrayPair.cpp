@@ -6,7 +6,7 @@ AggregatedGrayPair::AggregatedGrayPair() {
     frequency = 0;
 }
 
-AggregatedGrayPair::AggregatedGrayPair(grayLevelType i, frequencyType freq){
+AggregatedGrayPair::AggregatedGrayPair(aggregatedGrayLevelType i, frequencyType freq){
     grayLevel = i;
     frequency = freq;
 }
@@ -18,7 +18,7 @@ void AggregatedGrayPair::printPair() const {
 }
 
 /* Extracting pairs */
-grayLevelType AggregatedGrayPair::getAggregatedGrayLevel() const{
+aggregatedGrayLevelType AggregatedGrayPair::getAggregatedGrayLevel() const{
     return grayLevel;
 }
 
@@ -4,7 +4,11 @@
 // Custom types for easy future correction
 // Unsigned shorts half the memory footprint of the application
 typedef unsigned short grayLevelType;
-typedef unsigned short frequencyType;
+// The sum of 2 gray levels of 16 bits needs 17 bits; the padding of the
+// frequency makes it free
+typedef unsigned int aggregatedGrayLevelType;
+// Cubic windows of volumes can have more than 2^16 equal pairs
+typedef unsigned int frequencyType;
 
 /**
  * This class represent two possible type of elements:
@@ -23,7 +27,7 @@ public:
      * @param level: gray level of the object
      * @param frequency: frequency of the object
      */
-    AggregatedGrayPair(grayLevelType level, frequencyType frequency);
+    AggregatedGrayPair(aggregatedGrayLevelType level, frequencyType frequency);
     /**
      * show textual representation with level and frequency
      */
@@ -32,7 +36,7 @@ public:
      * Getter
      * @return the grayLevel of the object
      */
-    grayLevelType getAggregatedGrayLevel() const;
+    aggregatedGrayLevelType getAggregatedGrayLevel() const;
     /**
      * Getter
      * @return the frequency of the object
@@ -65,7 +69,7 @@ public:
         return *this;
     }
 private:
-    grayLevelType grayLevel;
+    aggregatedGrayLevelType grayLevel;
     frequencyType frequency;
 
 };
@@ -0,0 +1,617 @@
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <unistd.h>
+#include "GLCMFeatures.h"
+#include "GLCM.h"
+#include "FeatureComputer.h"
+#include "Direction.h"
+#include "TextFeatureWriter.h"
+#include "NpyWriter.h"
+#include "Utils.h"
+
+using namespace std;
+using namespace chrono;
+
+/*
+ * Microbenchmarks of the stages of the computation: reading the pixels
+ * (with borders and quantization), building the GLCM of a window, each
+ * group of features, the whole extraction and the writers of the results.
+ * They run on synthetic images that look like the ones the tool is used
+ * for, and the results are saved as JSON to follow them between releases.
+ * Usage: GLCMBench [-o results.json] [-r repetitions] [--size side]
+ * [--quick] [--filter name] [--work-dir folder]
+ */
+
+/**
+ * Gray levels of the 16 bit images: MRI scanners store 12 bit values in
+ * 16 bit pixels
+ */
+const int SYNTHETIC_16_BIT_MAX = 4095;
+/**
+ * Most windows measured for each image by the glcm and features benchmarks;
+ * they are spread over the whole image
+ */
+const int MAX_SAMPLED_WINDOWS = 4096;
+
+struct BenchOptions {
+    string outputPath;
+    string workFolder;
+    string filter;
+    int repetitions;
+    int imageSide;
+    bool quick;
+};
+
+/**
+ * Image made by generateImage, with its pixels
+ */
+struct SyntheticImage {
+    /**
+     * Pattern and depth, ex. phantom-16
+     */
+    string name;
+    int bitsPerPixel;
+    int side;
+    vector<unsigned char> bytes;
+
+    PixelBuffer getBuffer() const {
+        PixelBuffer buffer = {bytes.data(), bitsPerPixel, side, side,
+                              (size_t) side * (bitsPerPixel / 8)};
+        return buffer;
+    }
+};
+
+/**
+ * Outcome of a benchmark; the parameters that don't apply are -1
+ */
+struct BenchResult {
+    string name;
+    string image;
+    int window;
+    int distance;
+    int threads;
+    /**
+     * Pixels, windows or values processed by each run
+     */
+    size_t items;
+    /**
+     * Bytes written by each run of the writers
+     */
+    size_t bytes;
+    double bestMilliseconds;
+    double meanMilliseconds;
+};
+
+struct Measure {
+    double bestMilliseconds;
+    double meanMilliseconds;
+};
+
+// Keeps the compiler from dropping computations whose results are unused
+volatile double benchSink;
+
+/**
+ * Run a job many times
+ * @param repetitions: how many times the job is timed
+ * @param job: returns the milliseconds of the work to measure, so that it
+ * can leave out its own preparation
+ * @return the fastest and the average time of the job
+ */
+template <typename Job>
+Measure measure(int repetitions, Job job){
+    Measure result = {0, 0};
+    for (int i = 0; i < repetitions; ++i) {
+        double elapsed = job();
+        if((i == 0) || (elapsed < result.bestMilliseconds))
+            result.bestMilliseconds = elapsed;
+        result.meanMilliseconds += elapsed / repetitions;
+    }
+    return result;
+}
+
+/**
+ * Utility method
+ * @param start: when the measured work began
+ * @return the milliseconds passed since start
+ */
+double millisecondsSince(high_resolution_clock::time_point start){
+    duration<double, milli> elapsed = high_resolution_clock::now() - start;
+    return elapsed.count();
+}
+
+/**
+ * Intensity, between 0 and 1, of a pixel of an elliptic phantom: a bright
+ * rim, textured tissue with a brighter lesion inside and a dark background
+ * @param x: horizontal position, between -1 and 1
+ * @param y: vertical position, between -1 and 1
+ * @param random: source of the acquisition noise
+ */
+double phantomIntensity(double x, double y, mt19937& random){
+    normal_distribution<double> noise(0, 0.03);
+    double radius = sqrt((x * x) / (0.85 * 0.85) + (y * y) / (0.7 * 0.7));
+    if(radius > 1)
+        return fabs(noise(random)) / 2;
+    if(radius > 0.92)
+        return 0.9 + noise(random);
+    double texture = 0.15 * sin(2 * M_PI * 8 * x) * sin(2 * M_PI * 6 * y);
+    double lesionX = (x - 0.3) / 0.15;
+    double lesionY = (y + 0.2) / 0.12;
+    double lesion = (lesionX * lesionX + lesionY * lesionY < 1) ? 0.2 : 0;
+    return 0.45 + texture + lesion + noise(random);
+}
+
+/**
+ * Create a synthetic image
+ * @param pattern: noise (every pixel independent), gradient (smooth
+ * ramp), phantom (textured ellipse filling the image) or background (small
+ * phantom in an image that is mostly 0)
+ * @param bitsPerPixel: 8 or 16
+ * @param side: rows and columns of the image
+ * @return the image; the same arguments always give the same pixels
+ */
+SyntheticImage generateImage(const string& pattern, int bitsPerPixel, int side){
+    SyntheticImage image;
+    image.name = pattern + "-" + to_string(bitsPerPixel);
+    image.bitsPerPixel = bitsPerPixel;
+    image.side = side;
+    image.bytes.resize((size_t) side * side * (bitsPerPixel / 8));
+    int maxGrayLevel = (bitsPerPixel == 16) ? SYNTHETIC_16_BIT_MAX : 255;
+
+    mt19937 random(side);
+    uniform_real_distribution<double> uniform(0, 1);
+    for (int row = 0; row < side; ++row) {
+        for (int column = 0; column < side; ++column) {
+            double x = 2.0 * column / (side - 1) - 1;
+            double y = 2.0 * row / (side - 1) - 1;
+            double intensity;
+            if(pattern == "noise")
+                intensity = uniform(random);
+            else if(pattern == "gradient")
+                intensity = 0.1 + 0.4 * (x + y + 2) / 2
+                        + 0.1 * sin(M_PI * x) * cos(M_PI * y);
+            else if(pattern == "phantom")
+                intensity = phantomIntensity(x, y, random);
+            else // background: the phantom covers a fifth of the image
+                intensity = ((x * x + y * y) < 0.25)
+                        ? phantomIntensity(2 * x, 2 * y, random) : 0;
+            intensity = min(max(intensity, 0.0), 1.0);
+            unsigned int level = (unsigned int) lround(intensity * maxGrayLevel);
+            size_t index = (size_t) row * side + column;
+            if(bitsPerPixel == 16)
+                ((uint16_t*) image.bytes.data())[index] = (uint16_t) level;
+            else
+                image.bytes[index] = (unsigned char) level;
+        }
+    }
+    return image;
+}
+
+/**
+ * Tell if a benchmark was requested
+ * @param options: the filter given by the user
+ * @param name: name of the benchmark
+ */
+bool isSelected(const BenchOptions& options, const string& name){
+    return options.filter.empty() || (name.find(options.filter) != string::npos);
+}
+
+/**
+ * Print the result and keep it for the JSON
+ */
+void addResult(vector<BenchResult>& results, const BenchResult& result){
+    cout << "* " << result.name << " " << result.image;
+    if(result.window > 0)
+        cout << " w" << result.window;
+    if(result.distance > 0)
+        cout << " d" << result.distance;
+    if(result.threads > 0)
+        cout << " j" << result.threads;
+    cout << ": " << result.bestMilliseconds << " ms";
+    if(result.items > 0)
+        cout << ", " << result.bestMilliseconds * 1e6 / result.items << " ns/item";
+    cout << " *" << endl;
+    results.push_back(result);
+}
+
+/**
+ * Reading the pixels of the image: plain, with a symmetric border and with
+ * quantization, as GLCMFeatures does before computing
+ */
+void benchLoad(const BenchOptions& options, const vector<SyntheticImage>& images,
+        vector<BenchResult>& results){
+    for (size_t i = 0; i < images.size(); ++i) {
+        PixelBuffer input = images[i].getBuffer();
+        size_t pixels = (size_t) input.rows * input.columns;
+        for (int variant = 0; variant < 3; ++variant) {
+            string name = (variant == 0) ? "load"
+                    : (variant == 1) ? "load_border" : "load_quantized";
+            if(!isSelected(options, name))
+                continue;
+            short int borderType = (variant == 1) ? 2 : 0;
+            int borderSize = (variant == 1) ? 9 : 0;
+            bool quantitize = (variant == 2);
+            Measure time = measure(options.repetitions, [&](){
+                high_resolution_clock::time_point start = high_resolution_clock::now();
+                Image band = GLCMFeatures::readBand(input, 0, input.rows, 0,
+                        borderType, borderSize, quantitize, 63);
+                double elapsed = millisecondsSince(start);
+                benchSink = band.getRows();
+                return elapsed;
+            });
+            BenchResult result = {name, images[i].name, -1, -1, 1, pixels, 0,
+                                  time.bestMilliseconds, time.meanMilliseconds};
+            addResult(results, result);
+        }
+    }
+}
+
+/**
+ * Building the GLCM of windows, and extracting each group of features from
+ * it, for every window side and distance
+ */
+void benchWindows(const BenchOptions& options, const vector<SyntheticImage>& images,
+        const vector<int>& windowSides, const vector<int>& distances,
+        vector<BenchResult>& results){
+    const char* groupNames[] = {"features_autonomous", "features_sum_aggregated",
+                                "features_diff_aggregated", "features_marginal"};
+    void (*groups[])(const GLCM&, double*) = {
+            FeatureComputer::extractAutonomousFeatures,
+            FeatureComputer::extractSumAggregatedFeatures,
+            FeatureComputer::extractDiffAggregatedFeatures,
+            FeatureComputer::extractMarginalFeatures};
+    bool glcmSelected = isSelected(options, "glcm");
+    bool featuresSelected = false;
+    for (int g = 0; g < 4; ++g)
+        featuresSelected |= isSelected(options, groupNames[g]);
+    if(!glcmSelected && !featuresSelected)
+        return;
+
+    for (size_t i = 0; i < images.size(); ++i) {
+        PixelBuffer input = images[i].getBuffer();
+        Image image = GLCMFeatures::readBand(input, 0, input.rows, 0, 0, 0,
+                false, 0);
+        const unsigned int* pixels = image.getPixels();
+        ImageData imgData(image, 0);
+        for (size_t w = 0; w < windowSides.size(); ++w) {
+            int side = windowSides[w];
+            if(side > input.rows)
+                continue;
+            // Windows spread over the image, as many as MAX_SAMPLED_WINDOWS
+            int positions = input.rows - side;
+            int step = 1;
+            while((positions / step) * (positions / step) > MAX_SAMPLED_WINDOWS)
+                step++;
+            vector<pair<int, int>> origins;
+            for (int row = 0; row < positions; row += step)
+                for (int column = 0; column < positions; column += step)
+                    origins.push_back(make_pair(row, column));
+
+            for (size_t d = 0; d < distances.size(); ++d) {
+                int distance = distances[d];
+                if(distance >= side)
+                    continue;
+                Window window(side, distance, 1, false);
+                Direction direction(1);
+                window.setDirectionShifts(direction.shiftRows, direction.shiftColumns);
+                WorkArea wa = WorkArea::allocate(side * (side - distance), NULL);
+
+                if(glcmSelected){
+                    Measure time = measure(options.repetitions, [&](){
+                        int grayPairs = 0;
+                        high_resolution_clock::time_point start = high_resolution_clock::now();
+                        for (size_t o = 0; o < origins.size(); ++o) {
+                            window.setSpacialOffsets(origins[o].first, origins[o].second);
+                            GLCM glcm(pixels, imgData, window, wa);
+                            grayPairs += glcm.effectiveNumberOfGrayPairs;
+                        }
+                        double elapsed = millisecondsSince(start);
+                        benchSink = grayPairs;
+                        return elapsed;
+                    });
+                    BenchResult result = {"glcm", images[i].name, side, distance,
+                                          1, origins.size(), 0,
+                                          time.bestMilliseconds, time.meanMilliseconds};
+                    addResult(results, result);
+                }
+
+                if(featuresSelected){
+                    // The glcm of each window is built outside of the timings
+                    vector<Measure> times(4, Measure{0, 0});
+                    for (int r = 0; r < options.repetitions; ++r) {
+                        double elapsed[4] = {0, 0, 0, 0};
+                        for (size_t o = 0; o < origins.size(); ++o) {
+                            window.setSpacialOffsets(origins[o].first, origins[o].second);
+                            GLCM glcm(pixels, imgData, window, wa);
+                            double features[IMOC + 1];
+                            for (int g = 0; g < 4; ++g) {
+                                high_resolution_clock::time_point start = high_resolution_clock::now();
+                                groups[g](glcm, features);
+                                elapsed[g] += millisecondsSince(start);
+                            }
+                            benchSink = features[IMOC];
+                        }
+                        for (int g = 0; g < 4; ++g) {
+                            if((r == 0) || (elapsed[g] < times[g].bestMilliseconds))
+                                times[g].bestMilliseconds = elapsed[g];
+                            times[g].meanMilliseconds += elapsed[g] / options.repetitions;
+                        }
+                    }
+                    for (int g = 0; g < 4; ++g) {
+                        if(!isSelected(options, groupNames[g]))
+                            continue;
+                        BenchResult result = {groupNames[g], images[i].name, side,
+                                              distance, 1, origins.size(), 0,
+                                              times[g].bestMilliseconds,
+                                              times[g].meanMilliseconds};
+                        addResult(results, result);
+                    }
+                }
+                wa.release();
+            }
+        }
+    }
+}
+
+/**
+ * The whole extraction of an image, as the library users call it
+ */
+void benchExtract(const BenchOptions& options, const vector<SyntheticImage>& images,
+        const vector<int>& windowSides, const vector<int>& distances,
+        const vector<int>& threadCounts, vector<BenchResult>& results){
+    if(!isSelected(options, "extract"))
+        return;
+    int maxThreads = ThreadPool::getAvailableCores();
+    for (size_t t = 0; t < threadCounts.size(); ++t) {
+        GLCMFeatures glcmFeatures(threadCounts[t]);
+        bool allCores = (threadCounts[t] == maxThreads);
+        for (size_t i = 0; i < images.size(); ++i) {
+            /* The whole image is slow to compute: every window side and
+             * distance only for the phantoms with all the cores; the middle
+             * side and the first distance for the other images and the
+             * other thread counts */
+            bool phantom = (images[i].name.find("phantom") == 0);
+            if(!allCores && !phantom)
+                continue;
+            PixelBuffer input = images[i].getBuffer();
+            vector<double> output(GLCMFeatures::getOutputSize(input));
+            for (size_t w = 0; w < windowSides.size(); ++w) {
+                for (size_t d = 0; d < distances.size(); ++d) {
+                    bool sweep = allCores && phantom;
+                    if(!sweep && ((w != windowSides.size() / 2) || (d != 0)))
+                        continue;
+                    GLCMParameters parameters = {(short) windowSides[w],
+                                                 (short) distances[d], 1, false,
+                                                 0, false, 0};
+                    if((parameters.windowSize > input.rows)
+                        || (parameters.distance >= parameters.windowSize))
+                        continue;
+                    /* The first run also allocates the work areas; the best
+                     * of the runs leaves it out */
+                    Measure time = measure(options.repetitions, [&](){
+                        high_resolution_clock::time_point start = high_resolution_clock::now();
+                        glcmFeatures.extract(input, parameters, output.data());
+                        return millisecondsSince(start);
+                    });
+                    BenchResult result = {"extract", images[i].name,
+                                          parameters.windowSize, parameters.distance,
+                                          threadCounts[t],
+                                          (size_t) input.rows * input.columns, 0,
+                                          time.bestMilliseconds, time.meanMilliseconds};
+                    addResult(results, result);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Saving all the feature planes of an image with each writer
+ */
+void benchWriters(const BenchOptions& options, const SyntheticImage& image,
+        vector<BenchResult>& results){
+    const char* writerNames[] = {"write_text", "write_text_precise", "write_npy"};
+    bool selected = false;
+    for (int k = 0; k < 3; ++k)
+        selected |= isSelected(options, writerNames[k]);
+    if(!selected)
+        return;
+
+    PixelBuffer input = image.getBuffer();
+    vector<double> output(GLCMFeatures::getOutputSize(input));
+    GLCMParameters parameters = {9, 1, 1, false, 2, false, 0};
+    GLCMFeatures glcmFeatures(0);
+    glcmFeatures.extract(input, parameters, output.data());
+
+    string folder = options.workFolder + "/glcmbench-" + to_string(getpid());
+    Utils::createFolder(folder);
+    vector<string> fileNames = Features::getAllFeaturesFileNames();
+    size_t planeSize = (size_t) input.rows * input.columns;
+    for (int k = 0; k < 3; ++k) {
+        if(!isSelected(options, writerNames[k]))
+            continue;
+        string extension = (k == 2) ? ".npy" : ".txt";
+        TextFeatureWriter textWriter((k == 1) ? TextFeatureWriter::MAX_PRECISION
+                : TextFeatureWriter::DEFAULT_PRECISION, false);
+        size_t bytes = 0;
+        Measure time = measure(options.repetitions, [&](){
+            high_resolution_clock::time_point start = high_resolution_clock::now();
+            for (size_t f = 0; f < fileNames.size(); ++f) {
+                string path = folder + "/" + fileNames[f];
+                const double* plane = output.data() + f * planeSize;
+                bool saved = (k == 2)
+                        ? NpyWriter::savePlane(path, plane, planeSize,
+                                input.rows, input.columns, false)
+                        : textWriter.savePlane(path, plane, planeSize,
+                                input.columns, false);
+                if(!saved){
+                    cerr << "ERROR! Can't write in " << folder << endl;
+                    exit(-1);
+                }
+            }
+            double elapsed = millisecondsSince(start);
+            bytes = 0;
+            for (size_t f = 0; f < fileNames.size(); ++f)
+                bytes += Utils::getFileSize(folder + "/" + fileNames[f] + extension);
+            return elapsed;
+        });
+        for (size_t f = 0; f < fileNames.size(); ++f)
+            remove((folder + "/" + fileNames[f] + extension).c_str());
+        BenchResult result = {writerNames[k], image.name, parameters.windowSize,
+                              parameters.distance, 1, planeSize * fileNames.size(),
+                              bytes, time.bestMilliseconds, time.meanMilliseconds};
+        addResult(results, result);
+    }
+    rmdir(folder.c_str());
+}
+
+/**
+ * Save all the results, with what is needed to compare them with the ones
+ * of other runs
+ */
+void writeJson(const BenchOptions& options, const vector<BenchResult>& results){
+    ofstream out(options.outputPath.c_str());
+    if(!out){
+        cerr << "ERROR! Can't write the results to " << options.outputPath << endl;
+        exit(-1);
+    }
+    char date[32];
+    time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    out.precision(6);
+    out << "{" << endl
+        << "  \"date\": \"" << date << "\"," << endl
+        << "  \"hardware_threads\": " << ThreadPool::getAvailableCores() << "," << endl
+        << "  \"image_side\": " << options.imageSide << "," << endl
+        << "  \"repetitions\": " << options.repetitions << "," << endl
+        << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        out << ((i == 0) ? "" : ",") << endl << "    {\"name\": ";
+        out << Utils::toJsonString(result.name);
+        out << ", \"image\": ";
+        out << Utils::toJsonString(result.image);
+        if(result.window > 0)
+            out << ", \"window\": " << result.window;
+        if(result.distance > 0)
+            out << ", \"distance\": " << result.distance;
+        if(result.threads > 0)
+            out << ", \"threads\": " << result.threads;
+        out << ", \"items\": " << result.items;
+        if(result.bytes > 0)
+            out << ", \"bytes\": " << result.bytes;
+        out << ", \"best_ms\": " << result.bestMilliseconds
+            << ", \"mean_ms\": " << result.meanMilliseconds
+            << ", \"ns_per_item\": " << result.bestMilliseconds * 1e6 / max(result.items, (size_t) 1)
+            << "}";
+    }
+    out << endl << "  ]" << endl << "}" << endl;
+}
+
+void printBenchUsage(){
+    cout << "Usage: GLCMBench [-o results.json] [-r repetitions] [--size side] "
+            "[--quick] [--filter name] [--work-dir folder]" << endl
+         << "  -o: where the JSON results are saved (default GLCMBench.json)" << endl
+         << "  -r: timed runs of each benchmark; the best and the mean are kept (default 3)" << endl
+         << "  --size: side of the synthetic images (default 128)" << endl
+         << "  --quick: fewer window sides, distances and thread counts" << endl
+         << "  --filter: only the benchmarks whose name contains the text "
+            "(load, glcm, features, extract, write)" << endl
+         << "  --work-dir: where the writers save their files (default /tmp)" << endl;
+    exit(2);
+}
+
+BenchOptions parseBenchOptions(int argc, char* argv[]){
+    BenchOptions options = {"GLCMBench.json", "/tmp", "", 3, 128, false};
+    enum LongOnlyOptions {
+        SIZE_OPTION = 1000,
+        QUICK_OPTION,
+        FILTER_OPTION,
+        WORK_DIR_OPTION
+    };
+    static struct option longOptions[] = {
+            {"size", required_argument, NULL, SIZE_OPTION},
+            {"quick", no_argument, NULL, QUICK_OPTION},
+            {"filter", required_argument, NULL, FILTER_OPTION},
+            {"work-dir", required_argument, NULL, WORK_DIR_OPTION},
+            {NULL, 0, NULL, 0}
+    };
+    int opt;
+    while((opt = getopt_long(argc, argv, "o:r:h", longOptions, NULL)) != -1){
+        switch(opt){
+            case 'o':
+                options.outputPath = optarg;
+                break;
+            case 'r':
+                options.repetitions = atoi(optarg);
+                if(options.repetitions < 1){
+                    cerr << "ERROR! The repetitions must be >= 1" << endl;
+                    printBenchUsage();
+                }
+                break;
+            case SIZE_OPTION:
+                options.imageSide = atoi(optarg);
+                if(options.imageSide < 16){
+                    cerr << "ERROR! The side of the images must be >= 16" << endl;
+                    printBenchUsage();
+                }
+                break;
+            case QUICK_OPTION:
+                options.quick = true;
+                break;
+            case FILTER_OPTION:
+                options.filter = optarg;
+                break;
+            case WORK_DIR_OPTION:
+                options.workFolder = optarg;
+                break;
+            default:
+                printBenchUsage();
+        }
+    }
+    if(optind < argc)
+        printBenchUsage();
+    return options;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options = parseBenchOptions(argc, argv);
+
+    vector<SyntheticImage> images;
+    const char* patterns[] = {"noise", "gradient", "phantom", "background"};
+    for (int p = 0; p < 4; ++p) {
+        images.push_back(generateImage(patterns[p], 8, options.imageSide));
+        images.push_back(generateImage(patterns[p], 16, options.imageSide));
+    }
+
+    vector<int> windowSides = options.quick ? vector<int>{5, 9}
+            : vector<int>{3, 5, 9, 15};
+    vector<int> distances = options.quick ? vector<int>{1}
+            : vector<int>{1, 2, 4};
+    // Powers of 2 up to the cores, and all the cores
+    int maxThreads = ThreadPool::getAvailableCores();
+    vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        if(!options.quick || (threads == 1))
+            threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    vector<BenchResult> results;
+    benchLoad(options, images, results);
+    benchWindows(options, images, windowSides, distances, results);
+    benchExtract(options, images, windowSides, distances, threadCounts, results);
+    // The 8 bit phantom
+    benchWriters(options, images[4], results);
+
+    writeJson(options, results);
+    cout << endl << "- Results saved in " << options.outputPath << endl;
+    return 0;
+}
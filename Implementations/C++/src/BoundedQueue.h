@@ -0,0 +1,69 @@
+#ifndef FEATUREEXTRACTOR_BOUNDEDQUEUE_H
+#define FEATUREEXTRACTOR_BOUNDEDQUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+/**
+ * Queue with a maximum number of elements that links a producer thread to
+ * a consumer thread. The producer waits when the queue is full, so a slow
+ * consumer limits how much memory the waiting elements take
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    /**
+     * Create the queue
+     * @param capacity: maximum elements waiting in the queue (at least 1)
+     */
+    explicit BoundedQueue(size_t capacity)
+            : capacity(capacity < 1 ? 1 : capacity), closed(false) {}
+    /**
+     * Add an element, waiting until there is space for it
+     * @param element: what will be handed to the consumer
+     */
+    void push(const T& element){
+        unique_lock<mutex> lock(queueLock);
+        notFull.wait(lock, [this]{ return elements.size() < capacity; });
+        elements.push_back(element);
+        notEmpty.notify_one();
+    }
+    /**
+     * Take the oldest element, waiting until one is available
+     * @param element: where the element will be put
+     * @return false if the queue was closed and no more elements will come
+     */
+    bool pop(T& element){
+        unique_lock<mutex> lock(queueLock);
+        notEmpty.wait(lock, [this]{ return !elements.empty() || closed; });
+        if(elements.empty())
+            return false;
+        element = elements.front();
+        elements.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+    /**
+     * Tell the consumer that no more elements will be added; the ones
+     * already in the queue are still delivered
+     */
+    void close(){
+        lock_guard<mutex> lock(queueLock);
+        closed = true;
+        notEmpty.notify_all();
+    }
+
+private:
+    deque<T> elements;
+    size_t capacity;
+    bool closed;
+    mutex queueLock;
+    condition_variable notEmpty;
+    condition_variable notFull;
+};
+
+
+#endif //FEATUREEXTRACTOR_BOUNDEDQUEUE_H
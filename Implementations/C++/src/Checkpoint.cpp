@@ -0,0 +1,133 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <dirent.h>
+#include <unistd.h>
+#include "Checkpoint.h"
+#include "Utils.h"
+
+#define SIDECAR_NAME "checkpoint.txt"
+#define SIDECAR_VERSION "GLCM-CHECKPOINT 1"
+
+Checkpoint::Checkpoint(const string& outputFolder, const string& key)
+        : outputFolder(outputFolder), key(key){}
+
+string Checkpoint::getSidecarPath() const{
+    return outputFolder + "/" + SIDECAR_NAME;
+}
+
+/**
+ * Find the files and the folders inside a folder
+ * @param folderPath
+ * @param files: where the names of the files are added
+ * @param folders: where the names of the folders are added
+ */
+static void listFolder(const string& folderPath, vector<string>& files,
+        vector<string>& folders){
+    DIR* folder = opendir(folderPath.c_str());
+    if(folder == NULL)
+        return;
+    struct dirent* item;
+    while((item = readdir(folder)) != NULL){
+        string name = item->d_name;
+        if((name == ".") || (name == ".."))
+            continue;
+        if(Utils::isDirectory(folderPath + "/" + name))
+            folders.push_back(name);
+        else
+            files.push_back(name);
+    }
+    closedir(folder);
+}
+
+vector<string> Checkpoint::listResultFiles() const{
+    vector<string> files;
+    vector<string> folders;
+    listFolder(outputFolder, files, folders);
+    // The sidecar itself is not a result
+    files.erase(remove_if(files.begin(), files.end(), [](const string& name){
+        return name.compare(0, strlen(SIDECAR_NAME), SIDECAR_NAME) == 0;
+    }), files.end());
+
+    // The results are at most 1 folder below the output folder
+    for (size_t i = 0; i < folders.size(); ++i) {
+        vector<string> folderFiles;
+        vector<string> subFolders;
+        listFolder(outputFolder + "/" + folders[i], folderFiles, subFolders);
+        for (size_t j = 0; j < folderFiles.size(); ++j) {
+            files.push_back(folders[i] + "/" + folderFiles[j]);
+        }
+    }
+    return files;
+}
+
+void Checkpoint::save(const int completedRows){
+    ostringstream sidecar;
+    sidecar << SIDECAR_VERSION << endl;
+    sidecar << "key " << key << endl;
+    sidecar << "rows " << completedRows << endl;
+    vector<string> files = listResultFiles();
+    for (size_t i = 0; i < files.size(); ++i) {
+        struct stat info;
+        if(stat((outputFolder + "/" + files[i]).c_str(), &info) == 0)
+            sidecar << "file " << info.st_size << " " << files[i] << endl;
+    }
+
+    // A crash while writing leaves the previous checkpoint intact
+    string temporaryPath = getSidecarPath() + ".tmp";
+    ofstream file(temporaryPath.c_str(), ios::trunc);
+    file << sidecar.str();
+    file.close();
+    if(file.fail() || (rename(temporaryPath.c_str(), getSidecarPath().c_str()) != 0))
+        cerr << "Couldn't save the checkpoint: " << getSidecarPath() << endl;
+}
+
+int Checkpoint::restore(){
+    ifstream file(getSidecarPath().c_str());
+    if(!file.is_open()){
+        cout << endl << "WARNING! No checkpoint found in " << outputFolder
+             << "; the image is computed from the beginning" << endl;
+        return 0;
+    }
+
+    string line;
+    getline(file, line);
+    if(line != SIDECAR_VERSION){
+        cerr << "ERROR! " << getSidecarPath() << " is not a checkpoint" << endl;
+        exit(-1);
+    }
+    string field, savedKey;
+    int completedRows = -1;
+    file >> field >> savedKey;
+    if((field != "key") || (savedKey != key)){
+        cerr << "ERROR! The checkpoint in " << outputFolder << " was made with "
+                "a different image or different parameters; use the same "
+                "ones or another output folder" << endl;
+        exit(-1);
+    }
+    file >> field >> completedRows;
+    if((field != "rows") || (completedRows < 0)){
+        cerr << "ERROR! " << getSidecarPath() << " is damaged" << endl;
+        exit(-1);
+    }
+
+    // Values written after the checkpoint are thrown away
+    long long size;
+    while((file >> field >> size) && (field == "file")){
+        string relativePath;
+        getline(file, relativePath);
+        relativePath.erase(0, relativePath.find_first_not_of(' '));
+        string path = outputFolder + "/" + relativePath;
+        if(truncate(path.c_str(), size) != 0){
+            cout << endl << "WARNING! The result file " << path << " of the "
+                    "checkpoint is missing; the image is computed from the beginning" << endl;
+            return 0;
+        }
+    }
+    return completedRows;
+}
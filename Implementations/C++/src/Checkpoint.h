@@ -0,0 +1,55 @@
+#ifndef FEATUREEXTRACTOR_CHECKPOINT_H
+#define FEATUREEXTRACTOR_CHECKPOINT_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * This class keeps, in a sidecar file of the output folder, how many rows of
+ * windows of an image computed by bands were already saved and how long
+ * each result file was at that moment.
+ * A run that stopped (crash, preemption) can then be resumed: the files are
+ * cut back to their length at the last checkpoint and only the bands after
+ * it are computed again
+ */
+class Checkpoint {
+public:
+    /**
+     * Initialize the checkpoint of a run
+     * @param outputFolder: folder of the results; the sidecar is put there
+     * @param key: identifies the image and every parameter that changes the
+     * results, so that a run is never resumed with different ones
+     */
+    Checkpoint(const string& outputFolder, const string& key);
+    /**
+     * Bring the output folder back to the last checkpoint of a previous run
+     * @return how many rows of windows were already saved; 0 if the run
+     * needs to start from the beginning
+     */
+    int restore();
+    /**
+     * Record that some rows of windows were saved, with the length of all
+     * the result files
+     * @param completedRows: rows of windows saved in the files
+     */
+    void save(int completedRows);
+
+private:
+    string outputFolder;
+    string key;
+    /**
+     * Utility method
+     * @return path of the sidecar file
+     */
+    string getSidecarPath() const;
+    /**
+     * Find the result files in the output folder and in its sub-folders
+     * @return the paths of the files, relative to the output folder
+     */
+    vector<string> listResultFiles() const;
+};
+
+
+#endif //FEATUREEXTRACTOR_CHECKPOINT_H
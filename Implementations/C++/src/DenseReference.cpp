@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include "DenseReference.h"
+#include "Direction.h"
+
+DenseReference::DenseReference(const vector<unsigned int>& voxels,
+        const int slices, const int rows, const int columns,
+        const int bitsPerPixel, const GLCMParameters& parameters,
+        const bool volumetric): voxels(voxels), slices(slices), rows(rows),
+        columns(columns), maxGrayLevel((bitsPerPixel == 16) ? 65535 : 255),
+        parameters(parameters), volumetric(volumetric){
+}
+
+unsigned int DenseReference::getMaxGrayLevel() const{
+    return maxGrayLevel;
+}
+
+unsigned int DenseReference::getLevel(const int slice, const int row,
+        const int column) const{
+    bool outside = (slice < 0) || (slice >= slices) || (row < 0)
+            || (row >= rows) || (column < 0) || (column >= columns);
+    if(outside && (parameters.borderType == 1))
+        return 0;
+    // Replicated border: the nearest voxel of the image
+    int z = min(max(slice, 0), slices - 1);
+    int y = min(max(row, 0), rows - 1);
+    int x = min(max(column, 0), columns - 1);
+    unsigned long long level = voxels[((size_t) z * rows + y) * columns + x];
+    if(parameters.quantitize){
+        unsigned long long quantizationMax = min((unsigned int) parameters.quantitizationMax,
+                maxGrayLevel);
+        level = level * quantizationMax / maxGrayLevel;
+    }
+    return (unsigned int) level;
+}
+
+vector<unsigned int> DenseReference::getBorderedVoxels(const int borderSize) const{
+    int sliceBorder = volumetric ? borderSize : 0;
+    int paddedSlices = slices + 2 * sliceBorder;
+    int paddedRows = rows + 2 * borderSize;
+    int paddedColumns = columns + 2 * borderSize;
+    vector<unsigned int> bordered;
+    bordered.reserve((size_t) paddedSlices * paddedRows * paddedColumns);
+    for (int z = 0; z < paddedSlices; ++z) {
+        for (int y = 0; y < paddedRows; ++y) {
+            for (int x = 0; x < paddedColumns; ++x) {
+                bordered.push_back(getLevel(z - sliceBorder, y - borderSize,
+                        x - borderSize));
+            }
+        }
+    }
+    return bordered;
+}
+
+void DenseReference::computeAllFeatures(vector<double>& values,
+        vector<double>& magnitudes) const{
+    size_t planeSize = (size_t) slices * rows * columns;
+    values.assign(planeSize * (IMOC + 1), 0);
+    magnitudes.assign(planeSize * (IMOC + 1), 0);
+
+    // Without borders, only the windows whose pixels are all in the image
+    int side = parameters.windowSize;
+    int computedSlices = slices;
+    int computedRows = rows;
+    int computedColumns = columns;
+    if(parameters.borderType == 0){
+        if(volumetric)
+            computedSlices = max(0, slices - side);
+        computedRows = max(0, rows - side);
+        computedColumns = max(0, columns - side);
+    }
+
+    for (int z = 0; z < computedSlices; ++z) {
+        for (int y = 0; y < computedRows; ++y) {
+            for (int x = 0; x < computedColumns; ++x) {
+                double features[IMOC + 1];
+                double featureMagnitudes[IMOC + 1];
+                computeWindowFeatures(z, y, x, features, featureMagnitudes);
+                size_t offset = ((size_t) z * rows + y) * columns + x;
+                for (int f = 0; f <= IMOC; ++f) {
+                    values[f * planeSize + offset] = features[f];
+                    magnitudes[f * planeSize + offset] = featureMagnitudes[f];
+                }
+            }
+        }
+    }
+}
+
+void DenseReference::computeWindowFeatures(const int slice, const int row,
+        const int column, double* features, double* magnitudes) const{
+    int side = parameters.windowSize;
+    int depth = volumetric ? side : 1;
+    Direction direction(parameters.directionType);
+    int distance = parameters.distance;
+
+    // The gray levels of the window are the rows and columns of the matrix
+    vector<unsigned int> levels;
+    for (int z = 0; z < depth; ++z) {
+        for (int y = 0; y < side; ++y) {
+            for (int x = 0; x < side; ++x) {
+                levels.push_back(getLevel(slice + z, row + y, column + x));
+            }
+        }
+    }
+    sort(levels.begin(), levels.end());
+    levels.erase(unique(levels.begin(), levels.end()), levels.end());
+    size_t numberOfLevels = levels.size();
+    vector<double> counts(numberOfLevels * numberOfLevels, 0);
+
+    // Every voxel of the window whose neighbor is in the window too
+    int numberOfPairs = 0;
+    for (int z = 0; z < depth; ++z) {
+        for (int y = 0; y < side; ++y) {
+            for (int x = 0; x < side; ++x) {
+                int neighborZ = z + distance * direction.shiftSlices;
+                int neighborY = y + distance * direction.shiftRows;
+                int neighborX = x + distance * direction.shiftColumns;
+                if((neighborZ < 0) || (neighborZ >= depth) || (neighborY < 0)
+                    || (neighborY >= side) || (neighborX < 0) || (neighborX >= side))
+                    continue;
+                unsigned int reference = getLevel(slice + z, row + y, column + x);
+                unsigned int neighbor = getLevel(slice + neighborZ,
+                        row + neighborY, column + neighborX);
+                if(parameters.symmetric && (reference > neighbor))
+                    swap(reference, neighbor);
+                size_t i = lower_bound(levels.begin(), levels.end(), reference) - levels.begin();
+                size_t j = lower_bound(levels.begin(), levels.end(), neighbor) - levels.begin();
+                counts[i * numberOfLevels + j]++;
+                numberOfPairs++;
+            }
+        }
+    }
+    if(parameters.symmetric)
+        numberOfPairs *= 2;
+
+    vector<double> probabilities(counts.size());
+    for (size_t k = 0; k < counts.size(); ++k) {
+        probabilities[k] = counts[k] / numberOfPairs;
+    }
+    computeMatrixFeatures(levels, probabilities, features, magnitudes);
+}
+
+void DenseReference::computeMatrixFeatures(const vector<unsigned int>& levels,
+        const vector<double>& probabilities, double* features,
+        double* magnitudes) const{
+    size_t numberOfLevels = levels.size();
+    fill(features, features + IMOC + 1, 0.0);
+    fill(magnitudes, magnitudes + IMOC + 1, 0.0);
+    // Add a term to a feature and its magnitude
+    auto add = [&](FeatureNames feature, double term, double magnitude){
+        features[feature] += term;
+        magnitudes[feature] += fabs(magnitude);
+    };
+
+    // Marginal probabilities and means
+    vector<double> xMarginal(numberOfLevels, 0);
+    vector<double> yMarginal(numberOfLevels, 0);
+    double mean = 0;
+    double muX = 0;
+    double muY = 0;
+    for (size_t a = 0; a < numberOfLevels; ++a) {
+        for (size_t b = 0; b < numberOfLevels; ++b) {
+            double p = probabilities[a * numberOfLevels + b];
+            double i = levels[a];
+            double j = levels[b];
+            xMarginal[a] += p;
+            yMarginal[b] += p;
+            mean += i * j * p;
+            muX += i * p;
+            muY += j * p;
+        }
+    }
+    double sigmaX = 0;
+    double sigmaY = 0;
+    for (size_t a = 0; a < numberOfLevels; ++a) {
+        for (size_t b = 0; b < numberOfLevels; ++b) {
+            double p = probabilities[a * numberOfLevels + b];
+            sigmaX += pow(levels[a] - muX, 2) * p;
+            sigmaY += pow(levels[b] - muY, 2) * p;
+        }
+    }
+    sigmaX = sqrt(sigmaX);
+    sigmaY = sqrt(sigmaY);
+
+    // Sums and differences of the gray levels of the cells
+    map<unsigned int, double> sums;
+    map<unsigned int, double> differences;
+    double hxy1 = 0;
+    for (size_t a = 0; a < numberOfLevels; ++a) {
+        for (size_t b = 0; b < numberOfLevels; ++b) {
+            double p = probabilities[a * numberOfLevels + b];
+            // Cells without pairs add nothing (0 log 0 = 0)
+            if(p == 0)
+                continue;
+            double i = levels[a];
+            double j = levels[b];
+            double difference = fabs(i - j);
+            double shifted = i + j - muX - muY;
+            // Terms that use the means are checked also against their errors
+            double shiftedBound = fabs(shifted) + 1;
+
+            add(ASM, p * p, p * p);
+            add(AUTOCORRELATION, i * j * p, i * j * p);
+            add(ENTROPY, -p * log(p), p * log(p));
+            features[MAXPROB] = max(features[MAXPROB], p);
+            magnitudes[MAXPROB] = features[MAXPROB];
+            add(HOMOGENEITY, p / (1 + difference), p / (1 + difference));
+            add(CONTRAST, difference * difference * p, difference * difference * p);
+            add(DISSIMILARITY, difference * p, difference * p);
+            add(IDM, p / (1 + difference / maxGrayLevel), p / (1 + difference / maxGrayLevel));
+            add(CLUSTERPROMINENCE, pow(shifted, 4) * p, pow(shiftedBound, 4) * p);
+            add(CLUSTERSHADE, pow(shifted, 3) * p, pow(shiftedBound, 3) * p);
+            add(SUMOFSQUARES, pow(i - mean, 2) * p, pow(fabs(i - mean) + 1, 2) * p);
+            add(CORRELATION, ((i - muX) * (j - muY) * p) / (sigmaX * sigmaY),
+                    ((fabs(i - muX) + 1) * (fabs(j - muY) + 1) * p) / (sigmaX * sigmaY));
+
+            sums[levels[a] + levels[b]] += p;
+            differences[(unsigned int) difference] += p;
+            hxy1 -= p * log(xMarginal[a] * yMarginal[b]);
+            magnitudes[IMOC] += fabs(p * log(xMarginal[a] * yMarginal[b]));
+        }
+    }
+
+    for (map<unsigned int, double>::const_iterator it = sums.begin(); it != sums.end(); ++it) {
+        double p = it->second;
+        add(SUMAVERAGE, it->first * p, it->first * p);
+        add(SUMENTROPY, -p * log(p), p * log(p));
+    }
+    for (map<unsigned int, double>::const_iterator it = sums.begin(); it != sums.end(); ++it) {
+        double p = it->second;
+        add(SUMVARIANCE, pow(it->first - features[SUMENTROPY], 2) * p,
+                pow(fabs(it->first - features[SUMENTROPY]) + 1, 2) * p);
+    }
+    for (map<unsigned int, double>::const_iterator it = differences.begin(); it != differences.end(); ++it) {
+        double p = it->second;
+        add(DIFFENTROPY, -p * log(p), p * log(p));
+        add(DIFFVARIANCE, pow(it->first, 2) * p, pow(it->first, 2) * p);
+    }
+
+    // Information measure of correlation
+    double hx = 0;
+    double hy = 0;
+    for (size_t a = 0; a < numberOfLevels; ++a) {
+        if(xMarginal[a] > 0)
+            hx -= xMarginal[a] * log(xMarginal[a]);
+        if(yMarginal[a] > 0)
+            hy -= yMarginal[a] * log(yMarginal[a]);
+    }
+    double hxy = features[ENTROPY];
+    features[IMOC] = (hxy - hxy1) / max(hx, hy);
+    magnitudes[IMOC] = (magnitudes[IMOC] + magnitudes[ENTROPY]
+            + fabs(hxy - hxy1)) / max(hx, hy);
+
+    // Windows of a single level (in a direction) have no correlation: the
+    // rounding errors of the means make their deviations 0 or tiny, and the
+    // value arbitrary. Otherwise a deviation is at least 1 / sqrt(pairs)
+    const double singleLevelDeviation = 1e-4;
+    if((min(sigmaX, sigmaY) < singleLevelDeviation) || !isfinite(magnitudes[CORRELATION]))
+        magnitudes[CORRELATION] = INFINITY;
+    if((max(hx, hy) == 0) || !isfinite(magnitudes[IMOC]))
+        magnitudes[IMOC] = INFINITY;
+}
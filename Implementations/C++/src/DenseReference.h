@@ -0,0 +1,99 @@
+#ifndef FEATUREEXTRACTOR_DENSEREFERENCE_H
+#define FEATUREEXTRACTOR_DENSEREFERENCE_H
+
+#include <vector>
+#include "GLCMParameters.h"
+#include "Features.h"
+
+using namespace std;
+
+/**
+ * Naive computation of the features, written to be obviously correct
+ * instead of fast, against which the computers of the library are checked
+ * (GLCMCheck). As Implementations/Matlab/GLCM_Features1.m, for each window
+ * it builds the whole co-occurrence matrix, dense over the gray levels of
+ * the window, and each feature is a sum over all its cells. The features
+ * are the ones of FeatureComputer, quirks included: symmetric windows
+ * count <i,j> and <j,i> in the same cell while the pairs are doubled, and
+ * the IDM is normalized by the maximum gray level of the depth of the image
+ */
+class DenseReference {
+public:
+    /**
+     * Initialize the class
+     * @param voxels: gray levels of the image, or of the volume slice after
+     * slice, without borders and before the quantization
+     * @param slices: 1 for images
+     * @param rows
+     * @param columns
+     * @param bitsPerPixel: 8 or 16
+     * @param parameters: windows, pairs, borders and quantization; in
+     * volumes the direction is in [1, 13]
+     * @param volumetric: the windows are cubes instead of squares
+     */
+    DenseReference(const vector<unsigned int>& voxels, int slices, int rows,
+            int columns, int bitsPerPixel, const GLCMParameters& parameters,
+            bool volumetric);
+    /**
+     * Compute the features of every window
+     * @param values: where the planes of the features are put, (slices *
+     * rows) x columns values each, in the order of FeatureNames; windows
+     * that are not computed without borders are 0
+     * @param magnitudes: for each value, the sum of the absolute values of
+     * the terms it was added from; the rounding errors of any order of the
+     * sums are proportional to it. Infinite for the values that are not
+     * defined (correlation and imoc of windows of a single level)
+     */
+    void computeAllFeatures(vector<double>& values,
+            vector<double>& magnitudes) const;
+    /**
+     * Utility method
+     * @param borderSize: border to apply on each side (also of the slices in
+     * volumes)
+     * @return the gray levels, quantized, with the border of the parameters
+     */
+    vector<unsigned int> getBorderedVoxels(int borderSize) const;
+    /**
+     * Getter
+     * @return the maximum gray level of the depth of the image
+     */
+    unsigned int getMaxGrayLevel() const;
+
+private:
+    vector<unsigned int> voxels;
+    int slices;
+    int rows;
+    int columns;
+    unsigned int maxGrayLevel;
+    GLCMParameters parameters;
+    bool volumetric;
+
+    /**
+     * Gray level of a voxel, quantized; outside the image it is 0 or the
+     * one of the nearest voxel, as the border requires
+     */
+    unsigned int getLevel(int slice, int row, int column) const;
+    /**
+     * Compute the features of the window with the given first voxel
+     * @param features: where the values are put
+     * @param magnitudes: where the sums of the absolute values of their
+     * terms are put
+     */
+    void computeWindowFeatures(int slice, int row, int column,
+            double* features, double* magnitudes) const;
+    /**
+     * Compute the features of a co-occurrence matrix
+     * @param levels: gray level of each row (and column) of the matrix
+     * @param probabilities: levels x levels cells, reference level on the
+     * rows
+     * @param features: where the values are put
+     * @param magnitudes: where the sums of the absolute values of their
+     * terms are put
+     */
+    void computeMatrixFeatures(const vector<unsigned int>& levels,
+            const vector<double>& probabilities, double* features,
+            double* magnitudes) const;
+};
+
+
+#endif //FEATUREEXTRACTOR_DENSEREFERENCE_H
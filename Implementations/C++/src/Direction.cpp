@@ -1,8 +1,20 @@
 #include <iostream>
 #include <cstring>
+#include <cstdio>
 #include "Direction.h"
 
+/**
+ * (slices, rows, columns) shifts of the directions that reach the next slice
+ */
+static const int SLICE_DIRECTIONS_SHIFTS[Direction::VOLUME_DIRECTIONS
+        - Direction::PLANE_DIRECTIONS][3] = {
+        {1, 0, 0}, {1, 0, 1}, {1, -1, 1}, {1, -1, 0}, {1, -1, -1},
+        {1, 0, -1}, {1, 1, -1}, {1, 1, 0}, {1, 1, 1}
+};
+
 Direction::Direction(int directionNumber) {
+    // Directions of the plane stay in the same slice
+    shiftSlices = 0;
     switch (directionNumber){
         case 1:{
             char templabel[20] = "Direction 0°";
@@ -36,9 +48,18 @@ Direction::Direction(int directionNumber) {
             shiftColumns = -1;
             break;
         }
-        default:
-            fprintf(stderr, "Unrecognized direction");
-            exit(-1);
+        default:{
+            if((directionNumber <= PLANE_DIRECTIONS) || (directionNumber > VOLUME_DIRECTIONS)){
+                fprintf(stderr, "Unrecognized direction");
+                exit(-1);
+            }
+            const int* shifts = SLICE_DIRECTIONS_SHIFTS[directionNumber - PLANE_DIRECTIONS - 1];
+            shiftSlices = shifts[0];
+            shiftRows = shifts[1];
+            shiftColumns = shifts[2];
+            snprintf(this->label, sizeof(this->label), "Direction (%d,%d,%d)",
+                    shiftSlices, shiftRows, shiftColumns);
+        }
     }
 }
 
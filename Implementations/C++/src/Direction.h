@@ -7,6 +7,10 @@
  * it embeds values for locating reference-neighbor pixel pairs
  * Supported directions with their number associated:
  * 0°[1], 45°[2], 90° [3], 135° [4]
+ * Volumes also support the 9 directions that reach the next slice, as
+ * (slices, rows, columns) shifts:
+ * (1,0,0)[5], (1,0,1)[6], (1,-1,1)[7], (1,-1,0)[8], (1,-1,-1)[9],
+ * (1,0,-1)[10], (1,1,-1)[11], (1,1,0)[12], (1,1,1)[13]
 */
 
 class Direction {
@@ -14,7 +18,7 @@ public:
     /**
      * Constructs the class putting into it the correct values
      * @param directionNumber: the number associated with the direction:
-     * 0°[1], 45°[2], 90° [3], 135° [4]
+     * 0°[1], 45°[2], 90° [3], 135° [4], 5-13 for the 3D ones
      */
     Direction(int directionNumber);
     /**
@@ -32,6 +36,20 @@ public:
      * shift on the x axis to locate the neighbor pixel
      */
     int shiftColumns;
+    /**
+     * shift on the z axis (slices of a volume) to locate the neighbor pixel
+     */
+    int shiftSlices;
+
+    /**
+     * Directions of a plane
+     */
+    static const int PLANE_DIRECTIONS = 4;
+    /**
+     * Unique directions of a volume: the ones of a plane and the ones that
+     * reach the next slice
+     */
+    static const int VOLUME_DIRECTIONS = 13;
 };
 
 
@@ -0,0 +1,196 @@
+
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "ImageLoader.h"
+#include "FeatureSaver.h"
+#include "Utils.h"
+#include "SharedMemory.h"
+#include "ServeProtocol.h"
+
+using namespace std;
+using namespace chrono;
+using namespace cv;
+
+/*
+ * Local client of the server of FeatureExtractor (--serve): it sends each
+ * image given with -i or --batch to the server, through shared memory, and
+ * saves the results like FeatureExtractor would. Without images it asks
+ * the server to stop.
+ * Usage: FeatureClient --serve socketPath [-i imagePath | --batch listOrFolder]
+ * [the options of FeatureExtractor that decide the features and the output]
+ */
+
+/**
+ * Connect to the server
+ * @param socketPath: where the server listens
+ * @return the connected socket
+ */
+int connectToServer(const string& socketPath){
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(socketPath.size() >= sizeof(address.sun_path)){
+        cerr << "ERROR! The socket path (--serve) is too long" << endl;
+        exit(-1);
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if((server < 0) || (connect(server, (sockaddr*) &address, sizeof(address)) != 0)){
+        cerr << "ERROR! Can't connect to the server on " << socketPath << ": "
+             << strerror(errno) << endl;
+        exit(-1);
+    }
+    return server;
+}
+
+/**
+ * Send a request and wait for its reply
+ * @param server: connected socket
+ * @param request: the request
+ * @param reply: where the reply is put
+ */
+void exchange(int server, const ServeProtocol::Request& request,
+        ServeProtocol::Reply& reply){
+    if(!ServeProtocol::sendMessage(server, &request, sizeof(request))
+        || !ServeProtocol::receiveMessage(server, &reply, sizeof(reply))
+        || (reply.magic != ServeProtocol::MAGIC)){
+        cerr << "ERROR! The server closed the connection" << endl;
+        exit(-1);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    ProgramArguments pa = ProgramArguments::checkOptions(argc, argv);
+    if(pa.servePath.empty()){
+        cerr << "ERROR! Missing the socket of the server (--serve)" << endl;
+        ProgramArguments::printProgramUsage();
+    }
+    int server = connectToServer(pa.servePath);
+
+    ServeProtocol::Request request;
+    memset(&request, 0, sizeof(request));
+    request.magic = ServeProtocol::MAGIC;
+    if(pa.imagePath.empty() && pa.batchPath.empty()){
+        // Nothing to compute: stop the server
+        ServeProtocol::Reply reply;
+        request.type = ServeProtocol::SHUTDOWN_REQUEST;
+        exchange(server, request, reply);
+        close(server);
+        return 0;
+    }
+    request.type = ServeProtocol::JOB_REQUEST;
+
+    vector<string> imagePaths;
+    if(pa.batchPath.empty())
+        imagePaths.push_back(pa.imagePath);
+    else{
+        // Each image of the batch has its own folder inside the output one
+        imagePaths = Utils::listBatchImages(pa.batchPath);
+        Utils::createFolder(pa.outputFolder);
+    }
+
+    // Only the results are saved here, without workers
+    ProgramArguments imageArgs = pa;
+    FeatureSaver saver(imageArgs, NULL);
+
+    SharedMemory memory;
+    int generation = 0;
+    int sentImages = 0;
+    int failedImages = 0;
+    double totalMilliseconds = 0;
+    for (size_t i = 0; i < imagePaths.size(); ++i) {
+        Mat image;
+        if(!ImageLoader::tryReadImage(imagePaths[i], image)){
+            cerr << "Could not open or find the image: " << imagePaths[i] << endl;
+            failedImages++;
+            continue;
+        }
+        GLCMParameters parameters = pa.getGLCMParameters();
+        int imageSmallestSide = min(image.rows, image.cols);
+        if(parameters.windowSize > imageSmallestSide){
+            cout << "WARNING! The window side exceeds the smallest dimension ("
+                 << imageSmallestSide << ") of " << imagePaths[i]
+                 << "; corrected to " << imageSmallestSide << endl;
+            parameters.windowSize = imageSmallestSide;
+        }
+
+        // Pixels first, then the results, aligned for doubles
+        int bitsPerPixel = (image.depth() == CV_16UC1) ? 16 : 8;
+        size_t stride = (size_t) image.cols * (bitsPerPixel / 8);
+        size_t pixelsBytes = stride * image.rows;
+        size_t outputOffset = (pixelsBytes + sizeof(double) - 1)
+                / sizeof(double) * sizeof(double);
+        size_t outputBytes = (size_t) image.rows * image.cols
+                * Features::getSupportedFeaturesCount() * sizeof(double);
+        if(outputOffset + outputBytes > memory.getSize()){
+            // A new name, so the server never mixes it with the old object
+            string name = "/glcm-client-" + to_string(getpid()) + "-"
+                    + to_string(generation++);
+            if(!memory.create(name, outputOffset + outputBytes))
+                exit(-1);
+        }
+        for (int row = 0; row < image.rows; ++row) {
+            memcpy(memory.getData() + row * stride, image.ptr(row), stride);
+        }
+
+        strncpy(request.shmName, memory.getName().c_str(),
+                ServeProtocol::SHM_NAME_LENGTH - 1);
+        request.shmSize = memory.getSize();
+        request.pixelsOffset = 0;
+        request.outputOffset = outputOffset;
+        request.rows = image.rows;
+        request.columns = image.cols;
+        request.bitsPerPixel = bitsPerPixel;
+        request.stride = stride;
+        request.windowSize = parameters.windowSize;
+        request.distance = parameters.distance;
+        request.directionType = parameters.directionType;
+        request.symmetric = parameters.symmetric;
+        request.borderType = parameters.borderType;
+        request.quantitize = parameters.quantitize;
+        request.quantitizationMax = parameters.quantitizationMax;
+
+        ServeProtocol::Reply reply;
+        high_resolution_clock::time_point start = high_resolution_clock::now();
+        exchange(server, request, reply);
+        duration<double, milli> elapsed = high_resolution_clock::now() - start;
+        if(reply.status != ServeProtocol::JOB_DONE){
+            cerr << "ERROR! The server could not compute " << imagePaths[i]
+                 << " (status " << reply.status << ")" << endl;
+            failedImages++;
+            continue;
+        }
+        sentImages++;
+        totalMilliseconds += elapsed.count();
+        cout << "* " << imagePaths[i] << ": " << elapsed.count() << " ms, "
+             << reply.microseconds / 1000.0 << " ms on the server *" << endl;
+
+        // The results are read where the server wrote them
+        FeaturePlanes featurePlanes((double*) (memory.getData() + outputOffset),
+                image.rows, image.cols, 1);
+        string outputFolder = pa.outputFolder;
+        if(!pa.batchPath.empty())
+            outputFolder += "/" + Utils::removeExtension(Utils::basename(imagePaths[i]));
+        // The options the image was computed with
+        imageArgs.imagePath = imagePaths[i];
+        imageArgs.windowSize = parameters.windowSize;
+        saver.saveFeaturesToFiles(featurePlanes, 0, image.rows, outputFolder, 0);
+        if(pa.createImages)
+            saver.saveAllFeatureImages(featurePlanes, outputFolder, false);
+    }
+    close(server);
+
+    cout << endl << "- Images computed: " << sentImages;
+    if(sentImages > 0)
+        cout << endl << "- Average time of each image: "
+             << totalMilliseconds / sentImages << " ms";
+    if(failedImages > 0)
+        cout << endl << "- Images that could not be computed: " << failedImages;
+    cout << endl;
+    return 0;
+}
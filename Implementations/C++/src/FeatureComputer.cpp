@@ -2,23 +2,22 @@
 #include <cmath>
 #include <assert.h>
 #include "FeatureComputer.h"
+#include "PhaseTimes.h"
 
 using namespace std;
 
 FeatureComputer::FeatureComputer(const unsigned int * pixels, const ImageData& img,
         const int shiftRows, const int shiftColumns,
-        const Window& wd, WorkArea& wa)
+        const Window& wd, WorkArea& wa, const int directionIndex)
                                  : pixels(pixels), image(img),
-                                 windowData(wd), workArea(wa) {
+                                 windowData(wd), workArea(wa),
+                                 directionIndex(directionIndex) {
     // Each direction has 2 shift used for addressing each pixel
     windowData.setDirectionShifts(shiftRows, shiftColumns);
 
     /* Deduct what window this thread is computing for saving the results
      * in the right memory location */
     computeOutputWindowFeaturesIndex();
-    int featuresCount = Features::getSupportedFeaturesCount();
-    int actualWindowOffset = outputWindowOffset * featuresCount; // consider space for each feature
-    featureOutput = workArea.output + actualWindowOffset; // where results will be saved
     // Compute features
     computeDirectionalFeatures();
 }
@@ -30,10 +29,11 @@ FeatureComputer::FeatureComputer(const unsigned int * pixels, const ImageData& i
  * window set of the image
  */
 void FeatureComputer::computeOutputWindowFeaturesIndex(){
-    // If bordered, the original image is at the center
+    /* If bordered, the original image is at the center; the rows of the
+     * planes can be longer than the ones of the image (halo of a tile) */
     int rowOffset = windowData.imageRowsOffset - image.getBorderSize();
     int colOffset = windowData.imageColumnsOffset - image.getBorderSize();
-    outputWindowOffset = (rowOffset * (image.getColumns() - 2 * image.getBorderSize()))
+    outputWindowOffset = ((size_t) rowOffset * workArea.output->getColumns())
             + colOffset;
     assert(rowOffset < image.getRows() - 2 * image.getBorderSize());
     assert(colOffset < image.getColumns() - 2 * image.getBorderSize());
@@ -41,22 +41,64 @@ void FeatureComputer::computeOutputWindowFeaturesIndex(){
 }
 
 /** Computes all the features supported.
- * The results will be saved in the array of the work area given to this thread
+ * The results will be saved in the planes of the work area given to this thread
  */
 void FeatureComputer::computeDirectionalFeatures() {
+    uint64_t start = workArea.timed ? PhaseTimes::now() : 0;
+    PerfCounters* counters = workArea.perfCounters;
+    uint64_t startEvents[NUMBER_OF_PERF_EVENTS];
+    if(counters != NULL)
+        counters->read(startEvents);
     // Generate the 5 needed array of representations
     GLCM glcm(pixels, image, windowData, workArea);
     //glcm.printGLCM(); // Print data and grayPairs for debugging
+    uint64_t built = workArea.timed ? PhaseTimes::now() : 0;
+    uint64_t builtEvents[NUMBER_OF_PERF_EVENTS];
+    if(counters != NULL)
+        counters->read(builtEvents);
+
+    double features[IMOC + 1];
+    extractFeatures(glcm, features);
+
+    saveFeatures(features);
+    if(workArea.timed){
+        workArea.glcmNanoseconds += built - start;
+        workArea.featuresNanoseconds += PhaseTimes::now() - built;
+    }
+    if(counters != NULL){
+        uint64_t endEvents[NUMBER_OF_PERF_EVENTS];
+        counters->read(endEvents);
+        for (int i = 0; i < NUMBER_OF_PERF_EVENTS; ++i) {
+            workArea.perfCounts[GLCM_COUNTED][i] += builtEvents[i] - startEvents[i];
+            workArea.perfCounts[FEATURES_COUNTED][i] += endEvents[i] - builtEvents[i];
+        }
+        workArea.countedWindows++;
+        workArea.countedPairs += glcm.getNumberOfPairs();
+    }
+}
 
+void FeatureComputer::extractFeatures(const GLCM& glcm, double* features){
     // Features computable from glcm Elements
-    extractAutonomousFeatures(glcm, featureOutput);
+    extractAutonomousFeatures(glcm, features);
 
     // Feature computable from aggregated glcm pairs
-    extractSumAggregatedFeatures(glcm, featureOutput);
-    extractDiffAggregatedFeatures(glcm, featureOutput);
+    extractSumAggregatedFeatures(glcm, features);
+    extractDiffAggregatedFeatures(glcm, features);
 
     // Imoc
-    extractMarginalFeatures(glcm, featureOutput);
+    extractMarginalFeatures(glcm, features);
+}
+
+/**
+ * Each feature has its own plane; the window has the same position in
+ * all of them
+ */
+void FeatureComputer::saveFeatures(const double* features){
+    FeaturePlanes* planes = workArea.output;
+    for (int i = 0; i <= IMOC; ++i) {
+        FeatureNames feature = static_cast<FeatureNames>(i);
+        planes->getPlane(feature, directionIndex)[outputWindowOffset] = features[i];
+    }
 }
 
 
@@ -99,7 +141,7 @@ inline double computeDissimilarityStep(const uint i, const uint j, const double
 // IDM
 inline double computeInverceDifferenceMomentStep(const uint i, const uint j,
     const double pairProbability, const uint maxGrayLevel) {
-    double diff = i - j; // avoids casting value errors of uint(negative number)
+    double diff = (double) i - j; // avoids casting value errors of uint(negative number)
     diff = diff < 0 ? -diff : diff; // absolute value
     double temp = diff;
     return (pairProbability / (1 + fabs(temp) / maxGrayLevel));
@@ -212,7 +254,7 @@ void FeatureComputer::extractAutonomousFeatures(const GLCM& glcm, double* featur
         idm += computeInverceDifferenceMomentStep(i, j, actualPairProbability, glcm.getMaxGrayLevel());
 
         // intemediate values
-        mean += (i * j * actualPairProbability);
+        mean += ((double) i * j * actualPairProbability);
         muX += (i * actualPairProbability);
         muY += (j * actualPairProbability);
     }
@@ -284,7 +326,7 @@ void FeatureComputer::extractSumAggregatedFeatures(const GLCM& glcm, double* fea
     int length = glcm.numberOfSummedPairs;
     for (int i = 0; i < length; ++i) {
         AggregatedGrayPair actualPair = glcm.summedPairs[i];
-        grayLevelType k = actualPair.getAggregatedGrayLevel();
+        aggregatedGrayLevelType k = actualPair.getAggregatedGrayLevel();
         double actualPairProbability = ((double) actualPair.getFrequency()) / numberOfPairs;
 
         sumavg += computeSumAverageStep(k, actualPairProbability);
@@ -296,7 +338,7 @@ void FeatureComputer::extractSumAggregatedFeatures(const GLCM& glcm, double* fea
 
     for (int i = 0; i < length; ++i) {
         AggregatedGrayPair actualPair = glcm.summedPairs[i];
-        grayLevelType k = actualPair.getAggregatedGrayLevel();
+        aggregatedGrayLevelType k = actualPair.getAggregatedGrayLevel();
         double actualPairProbability = ((double) actualPair.getFrequency()) / numberOfPairs;
 
         sumvariance += computeSumVarianceStep(k, actualPairProbability, sumentropy);
@@ -319,7 +361,7 @@ void FeatureComputer::extractDiffAggregatedFeatures(const GLCM& glcm, double* fe
     int length = glcm.numberOfSubtractedPairs;
     for (int i = 0; i < length; ++i) {
         AggregatedGrayPair actualPair = glcm.subtractedPairs[i];
-        grayLevelType k = actualPair.getAggregatedGrayLevel();
+        aggregatedGrayLevelType k = actualPair.getAggregatedGrayLevel();
         double actualPairProbability = ((double) actualPair.getFrequency()) / numberOfPairs;
 
         diffentropy += computeDiffEntropyStep(actualPairProbability);
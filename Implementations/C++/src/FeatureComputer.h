@@ -25,10 +25,55 @@ public:
      * point in the image, etc.)
      * @param wa: memory location where this object will create the arrays of
      * representation needed for computing its features
+     * @param directionIndex: index, among the directions computed, of the
+     * plane where the results will be saved
      */
     FeatureComputer(const unsigned int * pixels, const ImageData& img,
             int shiftRows, int shiftColumns, const Window& windowData,
-            WorkArea& wa);
+            WorkArea& wa, int directionIndex);
+    /**
+     * Compute all the features supported from the elements of a GLCM
+     * @param glcm: object of class GLCM that will provide gray pairs
+     * @param features: where to store the results, indexed by FeatureNames
+     */
+    static void extractFeatures(const GLCM& glcm, double* features);
+    // Groups of features that extractFeatures computes, in its order
+    /**
+     * Compute the features that can be extracted from the GLCM of the image;
+     * this method will store the results automatically
+     * @param metaGLCM: object of class GLCM that will provide gray pairs
+     * @param features: where to store the results; this pointer is obtained
+     * from the work area
+     */
+    static void extractAutonomousFeatures(const GLCM& metaGLCM, double* features);
+    /**
+     * Compute the features that can be extracted from the AggregatedPairs
+     * obtained by adding gray levels of the pixel pairs.
+     * this method will store the results automatically
+     * @param metaGLCM: object of class GLCM that will provide gray pairs
+     * @param features: where to store the results; this pointer is obtained
+     * from the work area
+     */
+    static void extractSumAggregatedFeatures(const GLCM& metaGLCM, double* features);
+    /**
+     * Compute the features that can be extracted from the AggregatedPairs
+     * obtained by subtracting gray levels of the pixel pairs.
+     * this method will store the results automatically
+     * @param metaGLCM: object of class GLCM that will provide gray pairs
+     * @param features: where to store the results; this pointer is obtained
+     * from the work area
+     */
+    static void extractDiffAggregatedFeatures(const GLCM& metaGLCM, double* features);
+    /**
+     * Compute the features that can be extracted from the AggregatedPairs
+     * obtained by computing the marginal frequency of the gray levels of the
+     * reference/neighbor pixels.
+     * this method will store the results automatically
+     * @param metaGLCM: object of class GLCM that will provide gray pairs
+     * @param features: where to store the results; this pointer is obtained
+     * from the work area. It must already have the ENTROPY of the window
+     */
+    static void extractMarginalFeatures(const GLCM& metaGLCM, double* features);
 private:
     // given data to initialize related GLCM
     /**
@@ -48,15 +93,16 @@ private:
      */
     WorkArea& workArea;
     /**
-     * Where to put results
+     * Index of the direction among the ones computed; it identifies the
+     * planes where results are put
      */
-    double * featureOutput;
+    int directionIndex;
     /**
      * offset to identify the window that is being computed by yhe
      * object; this information will be used for storing the results in the
      * correct memory location
      */
-    int outputWindowOffset;
+    size_t outputWindowOffset;
     /**
      * Compute the offset to identify the window that is being computed by yhe
      * object; this information will be used for storing the results in the
@@ -69,42 +115,11 @@ private:
      */
     void computeDirectionalFeatures();
     /**
-     * Compute the features that can be extracted from the GLCM of the image;
-     * this method will store the results automatically
-     * @param metaGLCM: object of class GLCM that will provide gray pairs
-     * @param features: where to store the results; this pointer is obtained
-     * from the work area
-     */
-    void extractAutonomousFeatures(const GLCM& metaGLCM, double* features);
-    /**
-     * Compute the features that can be extracted from the AggregatedPairs
-     * obtained by adding gray levels of the pixel pairs.
-     * this method will store the results automatically
-     * @param metaGLCM: object of class GLCM that will provide gray pairs
-     * @param features: where to store the results; this pointer is obtained
-     * from the work area
-     */
-    void extractSumAggregatedFeatures(const GLCM& metaGLCM, double* features);
-    /**
-     * Compute the features that can be extracted from the AggregatedPairs
-     * obtained by subtracting gray levels of the pixel pairs.
-     * this method will store the results automatically
-     * @param metaGLCM: object of class GLCM that will provide gray pairs
-     * @param features: where to store the results; this pointer is obtained
-     * from the work area
-     */
-    void extractDiffAggregatedFeatures(const GLCM& metaGLCM, double* features);
-    /**
-     * Compute the features that can be extracted from the AggregatedPairs
-     * obtained by computing the marginal frequency of the gray levels of the
-     * reference/neighbor pixels.
-     * this method will store the results automatically
-     * @param metaGLCM: object of class GLCM that will provide gray pairs
-     * @param features: where to store the results; this pointer is obtained
-     * from the work area
+     * Copy the features of the window in the right cell of each plane of
+     * the work area
+     * @param features: all the features computed for the window
      */
-    void extractMarginalFeatures(const GLCM& metaGLCM, double* features);
-
+    void saveFeatures(const double* features);
 };
 
 #endif //FEATUREEXTRACTOR_FEATURECOMPUTER_H
@@ -0,0 +1,54 @@
+#include <cstdlib>
+#include <new>
+#include "FeaturePlanes.h"
+
+FeaturePlanes::FeaturePlanes(const int rows, const int columns,
+        const int numberOfDirections): ownsValues(true), rows(rows),
+        columns(columns), numberOfDirections(numberOfDirections){
+    size_t numberOfValues = getPlaneSize() * numberOfDirections
+            * Features::getSupportedFeaturesCount();
+    /* Zeroed because the windows excluded without borders are never
+     * written */
+    values = (double*) calloc(numberOfValues, sizeof(double));
+    if((values == NULL) && (numberOfValues > 0))
+        throw bad_alloc();
+}
+
+FeaturePlanes::FeaturePlanes(double* values, const int rows, const int columns,
+        const int numberOfDirections): values(values), ownsValues(false),
+        rows(rows), columns(columns), numberOfDirections(numberOfDirections){}
+
+FeaturePlanes::FeaturePlanes(FeaturePlanes&& other): values(other.values),
+        ownsValues(other.ownsValues), rows(other.rows), columns(other.columns),
+        numberOfDirections(other.numberOfDirections){
+    other.values = NULL;
+}
+
+FeaturePlanes::~FeaturePlanes(){
+    if(ownsValues)
+        free(values);
+}
+
+double* FeaturePlanes::getPlane(const FeatureNames feature, const int directionIndex){
+    return values + (((size_t) feature * numberOfDirections) + directionIndex) * getPlaneSize();
+}
+
+const double* FeaturePlanes::getPlane(const FeatureNames feature, const int directionIndex) const{
+    return values + (((size_t) feature * numberOfDirections) + directionIndex) * getPlaneSize();
+}
+
+size_t FeaturePlanes::getPlaneSize() const{
+    return (size_t) rows * columns;
+}
+
+int FeaturePlanes::getRows() const{
+    return rows;
+}
+
+int FeaturePlanes::getColumns() const{
+    return columns;
+}
+
+int FeaturePlanes::getNumberOfDirections() const{
+    return numberOfDirections;
+}
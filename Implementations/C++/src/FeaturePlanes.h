@@ -0,0 +1,84 @@
+#ifndef FEATUREEXTRACTOR_FEATUREPLANES_H
+#define FEATUREEXTRACTOR_FEATUREPLANES_H
+
+#include <cstddef>
+#include "Features.h"
+
+using namespace std;
+
+/**
+ * This class owns all the feature values computed for an image (or for a
+ * band of rows of it) in a single pre-allocated buffer.
+ * Values are feature-major: for each feature, one contiguous plane of
+ * rows x columns values for each direction computed, in the same order of
+ * the windows of the image
+ */
+class FeaturePlanes {
+public:
+    /**
+     * Allocate all the planes; every value is initially 0
+     * @param rows: rows of windows of each plane
+     * @param columns: columns of windows of each plane
+     * @param numberOfDirections: how many directions are computed for each
+     * window
+     * @throws bad_alloc if the memory is not available
+     */
+    FeaturePlanes(int rows, int columns, int numberOfDirections);
+    /**
+     * Use memory of the caller for the planes, with the values it already
+     * has; it is not released by this instance
+     * @param values: room for all the values of the planes
+     * @param rows: rows of windows of each plane
+     * @param columns: columns of windows of each plane
+     * @param numberOfDirections: how many directions are computed for each
+     * window
+     */
+    FeaturePlanes(double* values, int rows, int columns, int numberOfDirections);
+    FeaturePlanes(FeaturePlanes&& other);
+    ~FeaturePlanes();
+    /**
+     * Getter
+     * @param feature: feature of interest
+     * @param directionIndex: index of the direction among the ones computed
+     * @return first value of the plane of the feature in that direction
+     */
+    double* getPlane(FeatureNames feature, int directionIndex);
+    const double* getPlane(FeatureNames feature, int directionIndex) const;
+    /**
+     * Getter
+     * @return how many values each plane has (rows x columns)
+     */
+    size_t getPlaneSize() const;
+    /**
+     * Getter
+     * @return how many rows of windows each plane has
+     */
+    int getRows() const;
+    /**
+     * Getter
+     * @return how many columns of windows each plane has
+     */
+    int getColumns() const;
+    /**
+     * Getter
+     * @return how many directions were computed for each window
+     */
+    int getNumberOfDirections() const;
+
+private:
+    // Planes can be huge; they are never copied
+    FeaturePlanes(const FeaturePlanes& other);
+    FeaturePlanes& operator=(const FeaturePlanes& other);
+
+    double* values;
+    /**
+     * The values were allocated by this instance
+     */
+    bool ownsValues;
+    int rows;
+    int columns;
+    int numberOfDirections;
+};
+
+
+#endif //FEATUREEXTRACTOR_FEATUREPLANES_H
@@ -0,0 +1,315 @@
+#include <iostream>
+#include <fstream>
+#include <atomic>
+
+#include "FeatureSaver.h"
+#include "ImageLoader.h"
+#include "NpyWriter.h"
+#include "Direction.h"
+#include "Utils.h"
+
+using namespace cv;
+
+FeatureSaver::FeatureSaver(const ProgramArguments& progArg, ThreadPool* workers)
+        : progArg(&progArg), workers(workers), phaseTimes(NULL){
+    if(progArg.textOutput)
+        textWriters.assign((workers != NULL) ? workers->getNumberOfThreads() : 1,
+                TextFeatureWriter(progArg.textPrecision, progArg.textRowLayout));
+}
+
+void FeatureSaver::setProgramArguments(const ProgramArguments& progArg){
+    this->progArg = &progArg;
+}
+
+void FeatureSaver::setPhaseTimes(PhaseTimes* times){
+    phaseTimes = times;
+}
+
+/**
+ * This method will save on different folders, all the features values
+ * computed for each directions of the image
+ * @param featurePlanes: all the values computed
+ * @param firstRow: first row of windows of the image that the planes
+ * have; the values of bands after the first are appended to the files
+ * @param totalRows: how many rows of windows the whole image has
+ * @param outFolder: folder of the results of the image
+ * @param saverIndex: text writer used for saving all the files; -1 for
+ * spreading the files among all the workers
+ * @return false if any file couldn't be written
+ */
+bool FeatureSaver::saveFeaturesToFiles(const FeaturePlanes& featurePlanes,
+        const int firstRow, const int totalRows, const string& outFolder,
+        const int saverIndex){
+    bool append = (firstRow > 0);
+    int dirType = progArg->directionType;
+
+    Utils::createFolder(outFolder);
+    string foldersPath[] ={ "/Values0/", "/Values45/", "/Values90/", "/Values135/"};
+
+    // First create the the folder
+    string outputDirectionPath = outFolder + foldersPath[dirType -1];
+    Utils::createFolder(outputDirectionPath);
+    bool saved = true;
+    if(progArg->textOutput)
+        saved = saveDirectedFeaturesToFiles(featurePlanes, 0, outputDirectionPath,
+                append, saverIndex);
+    if(progArg->npyOutput){
+        if(!append)
+            saved = saveFeaturesMetadata(featurePlanes.getColumns(), totalRows, 1,
+                    outputDirectionPath) && saved;
+        saved = saveDirectedFeaturesToNpy(featurePlanes, 0, outputDirectionPath,
+                append, totalRows) && saved;
+    }
+    return saved;
+}
+
+/**
+ * This method will save into the given folder, as .npy files, all the
+ * values of all the features computed for 1 direction
+ * @param featurePlanes: all the values computed
+ * @param directionIndex: index of the direction among the ones computed
+ * @param outputFolderPath
+ * @param append: add the values at the end of the files already present
+ * @param totalRows: how many rows of windows the whole image has
+ * @return false if any file couldn't be written
+ */
+bool FeatureSaver::saveDirectedFeaturesToNpy(const FeaturePlanes& featurePlanes,
+        const int directionIndex, const string& outputFolderPath,
+        const bool append, const int totalRows){
+    vector<string> fileDestinations = Features::getAllFeaturesFileNames();
+    bool allSaved = true;
+
+    // for each feature, the whole plane with a single write
+    for(int i = 0; i < fileDestinations.size(); i++) {
+        const double* plane = featurePlanes.getPlane((FeatureNames) i, directionIndex);
+        PhaseTimer npyTimer(phaseTimes, NPY_WRITE_PHASE);
+        bool saved = NpyWriter::savePlane(outputFolderPath + fileDestinations[i],
+                plane, featurePlanes.getPlaneSize(), totalRows,
+                featurePlanes.getColumns(), append);
+        npyTimer.stop();
+        if(!saved){
+            cerr << "Couldn't save the feature values to file" << endl;
+            allSaved = false;
+        }
+        else if(phaseTimes){
+            size_t headerSize = append ? 0 : NpyWriter::createHeader(totalRows,
+                    featurePlanes.getColumns()).size();
+            phaseTimes->addBytes(headerSize
+                    + featurePlanes.getPlaneSize() * sizeof(double));
+        }
+    }
+    return allSaved;
+}
+
+/**
+ * This method will save into the given folder the description of the .npy
+ * files: their dimensions, dtype, the order of the features, the direction
+ * and all the parameters used for computing them
+ * @param columns: columns of windows of each plane
+ * @param rows: rows of windows of each plane
+ * @param slices: slices of windows of each volume; 1 for images
+ * @param outputFolderPath
+ * @return false if the file couldn't be written
+ */
+bool FeatureSaver::saveFeaturesMetadata(const int columns,
+        const int rows, const int slices, const string& outputFolderPath){
+    int directionDegrees[] = {0, 45, 90, 135};
+    vector<string> featureNames = Features::getAllFeaturesFileNames();
+
+    ofstream file;
+    file.open((outputFolderPath + "features.json").c_str());
+    if(!file.is_open()){
+        cerr << "Couldn't save the feature metadata to file" << endl;
+        return false;
+    }
+    file << "{" << endl;
+    file << "  \"image\": " << Utils::toJsonString(progArg->imagePath) << "," << endl;
+    if(progArg->volumetric)
+        file << "  \"slices\": " << slices << "," << endl;
+    file << "  \"rows\": " << rows << "," << endl;
+    file << "  \"columns\": " << columns << "," << endl;
+    file << "  \"dtype\": \"" << NpyWriter::getDoubleDescription() << "\"," << endl;
+    if(progArg->volumetric){
+        // Directions of the space as shifts on (slices, rows, columns)
+        Direction direction(progArg->directionType);
+        file << "  \"direction\": [" << direction.shiftSlices << ", "
+             << direction.shiftRows << ", " << direction.shiftColumns << "]," << endl;
+    }
+    else
+        file << "  \"direction\": " << directionDegrees[progArg->directionType - 1] << "," << endl;
+    file << "  \"features\": [";
+    for (size_t i = 0; i < featureNames.size(); ++i) {
+        if(i > 0)
+            file << ", ";
+        file << "\"" << featureNames[i] << "\"";
+    }
+    file << "]," << endl;
+    file << "  \"parameters\": {" << endl;
+    file << "    \"windowSize\": " << progArg->windowSize << "," << endl;
+    file << "    \"distance\": " << progArg->distance << "," << endl;
+    file << "    \"symmetric\": " << (progArg->symmetric ? "true" : "false") << "," << endl;
+    file << "    \"borderType\": " << progArg->borderType << "," << endl;
+    file << "    \"quantitize\": " << (progArg->quantitize ? "true" : "false") << "," << endl;
+    file << "    \"quantitizationMax\": " << (progArg->quantitize ? progArg->quantitizationMax : 0) << endl;
+    file << "  }" << endl;
+    file << "}" << endl;
+    file.close();
+    if(file.fail()){
+        cerr << "Couldn't save the feature metadata to file" << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * This method will save into the given folder, alle the values of all
+ * the features computed for 1  directions
+ * @param featurePlanes: all the values computed
+ * @param directionIndex: index of the direction among the ones computed
+ * @param outputFolderPath
+ * @param append: add the values at the end of the files already present
+ * @param saverIndex: text writer used for saving all the files; -1 for
+ * spreading the files among all the workers
+ * @return false if any file couldn't be written
+ */
+bool FeatureSaver::saveDirectedFeaturesToFiles(const FeaturePlanes& featurePlanes,
+        const int directionIndex, const string& outputFolderPath, const bool append,
+        const int saverIndex){
+    vector<string> fileDestinations = Features::getAllFeaturesFileNames();
+
+    /* The workers are busy (computing the next band or other slices): the
+     * caller writes the files alone */
+    if(saverIndex >= 0){
+        bool allSaved = true;
+        for(int i = 0; i < fileDestinations.size(); i++) {
+            const double* plane = featurePlanes.getPlane((FeatureNames) i, directionIndex);
+            bool saved = saveTextPlane(saverIndex, outputFolderPath + fileDestinations[i],
+                    plane, featurePlanes, append);
+            if(!saved){
+                cerr << "Couldn't save the feature values to file" << endl;
+                allSaved = false;
+            }
+        }
+        return allSaved;
+    }
+
+    // Each idle worker takes the next feature and writes its whole file
+    atomic<int> nextFeature(0);
+    atomic<bool> failed(false);
+    workers->run([&](int workerIndex){
+        int feature;
+        while((feature = nextFeature++) < (int) fileDestinations.size()){
+            const double* plane = featurePlanes.getPlane((FeatureNames) feature, directionIndex);
+            bool saved = saveTextPlane(workerIndex,
+                    outputFolderPath + fileDestinations[feature], plane,
+                    featurePlanes, append);
+            if(!saved)
+                failed = true;
+        }
+    });
+    if(failed)
+        cerr << "Couldn't save the feature values to file" << endl;
+    return !failed;
+}
+
+/**
+ * Save a plane of values with a text writer, measuring the time and the
+ * bytes written
+ * @param writerIndex: text writer to use
+ * @param filePath: path of the file, without extension
+ * @param plane: the values to save
+ * @param featurePlanes: planes the values belong to
+ * @param append: add the values at the end of the file already present
+ * @return false if the file couldn't be written
+ */
+bool FeatureSaver::saveTextPlane(const int writerIndex,
+        const string& filePath, const double* plane,
+        const FeaturePlanes& featurePlanes, const bool append){
+    TextFeatureWriter& writer = textWriters[writerIndex];
+    PhaseTimer textTimer(phaseTimes, TEXT_WRITE_PHASE);
+    size_t writtenBytes = writer.getWrittenBytes();
+    bool saved = writer.savePlane(filePath, plane, featurePlanes.getPlaneSize(),
+            featurePlanes.getColumns(), append);
+    if(phaseTimes)
+        phaseTimes->addBytes(writer.getWrittenBytes() - writtenBytes);
+    return saved;
+}
+
+// IMAGING
+/**
+ * This method will produce and save all the images associated with each feature
+ * for each direction
+ * @param featurePlanes: all the values computed; each plane becomes an image
+ * @param outFolder: folder of the results of the image
+ * @param parallel: the workers encode the images; only when they aren't
+ * computing
+ */
+void FeatureSaver::saveAllFeatureImages(const FeaturePlanes& featurePlanes,
+        const string& outFolder, const bool parallel){
+    int dirType = progArg->directionType;
+
+    string foldersPath[] ={ "/Images0/", "/Images45/", "/Images90/", "/Images135/"};
+    string outputDirectionPath = outFolder + foldersPath[dirType -1];
+    Utils::createFolder(outputDirectionPath);
+    // For each direction computed
+    saveAllFeatureDirectedImages(featurePlanes, 0, outputDirectionPath, parallel);
+}
+
+/**
+ * This method will produce and save all the images associated with
+ * each feature in 1 direction
+ * @param featurePlanes: all the values computed
+ * @param directionIndex: index of the direction among the ones computed
+ * @param outputFolderPath: where to save the image
+ * @param parallel: the workers encode the images; only when they aren't
+ * computing
+ */
+void FeatureSaver::saveAllFeatureDirectedImages(const FeaturePlanes& featurePlanes,
+        const int directionIndex, const string& outputFolderPath, const bool parallel){
+
+    vector<string> fileDestinations = Features::getAllFeaturesFileNames();
+
+    /* The workers are busy (computing the next band or other slices): the
+     * caller encodes the images alone */
+    if(!parallel){
+        for(int i = 0; i < fileDestinations.size(); i++) {
+            string newFileName(outputFolderPath);
+            const double* plane = featurePlanes.getPlane((FeatureNames) i, directionIndex);
+            saveFeatureImage(featurePlanes.getRows(), featurePlanes.getColumns(),
+                    plane, newFileName.append(fileDestinations[i]));
+        }
+        return;
+    }
+
+    // Each idle worker takes the next feature and encodes its whole image
+    atomic<int> nextFeature(0);
+    workers->run([&](int workerIndex){
+        int feature;
+        while((feature = nextFeature++) < (int) fileDestinations.size()){
+            const double* plane = featurePlanes.getPlane((FeatureNames) feature, directionIndex);
+            saveFeatureImage(featurePlanes.getRows(), featurePlanes.getColumns(),
+                    plane, outputFolderPath + fileDestinations[feature]);
+        }
+    });
+}
+
+/**
+ * This method will produce and save on the filesystem the image associated with
+ * a feature in 1 direction
+ * @param rowNumber: how many rows the image will have
+ * @param colNumber: how many columns the image will have
+ * @param featureValues: plane of values that will be the intensities
+ * values of the image
+ * @param outputFilePath: where to save the image
+ */
+void FeatureSaver::saveFeatureImage(const int rowNumber,
+        const int colNumber, const double* featureValues, const string& filePath){
+    /* Wrap the plane of values in a 2d matrix, without copying it: it is
+     * converted straight to the pixels of the image */
+    Mat_<double> imageFeature = ImageLoader::createDoubleMat(rowNumber, colNumber, featureValues);
+    ImageLoader::saveImage(imageFeature, filePath, progArg->stretchImages,
+            phaseTimes, progArg->imageDepth);
+    if(phaseTimes)
+        phaseTimes->addBytes(Utils::getFileSize(filePath
+                + ImageLoader::getImageExtension(progArg->imageDepth)));
+}
@@ -0,0 +1,161 @@
+#ifndef FEATUREEXTRACTOR_FEATURESAVER_H
+#define FEATUREEXTRACTOR_FEATURESAVER_H
+
+#include <string>
+#include <vector>
+#include "FeaturePlanes.h"
+#include "ProgramArguments.h"
+#include "TextFeatureWriter.h"
+#include "ThreadPool.h"
+#include "PhaseTimes.h"
+
+using namespace std;
+
+/**
+ * This class saves the values computed for an image as the options ask:
+ * text and .npy files of the features, their metadata and the feature
+ * images. It computes nothing, so the threads that only save the results
+ * (the saver of a batch, the client of the server) need no workers
+ */
+class FeatureSaver {
+public:
+    /**
+     * Initialize the class
+     * @param progArg: options of the results; they must outlive the saver
+     * @param workers: pool that can spread the files of an image; NULL if
+     * the caller always saves alone
+     */
+    FeatureSaver(const ProgramArguments& progArg, ThreadPool* workers);
+    /**
+     * Save the next results with other options
+     * @param progArg: options of the results; they must outlive the saver
+     * or the next call
+     */
+    void setProgramArguments(const ProgramArguments& progArg);
+    /**
+     * Measure the time and the bytes of every file saved
+     * @param times: where to add them; NULL for not measuring
+     */
+    void setPhaseTimes(PhaseTimes* times);
+
+    /**
+     * This method will save on different folders, all the features values
+     * computed for each directions of the image
+     * @param featurePlanes: all the values computed
+     * @param firstRow: first row of windows of the image that the planes
+     * have; when the image is computed by bands, the values of bands after
+     * the first are appended to the files
+     * @param totalRows: how many rows of windows the whole image has
+     * @param outFolder: folder of the results of the image
+     * @param saverIndex: text writer used for saving all the files; -1 for
+     * spreading the files among all the workers
+     * @return false if any file couldn't be written
+     */
+    bool saveFeaturesToFiles(const FeaturePlanes& featurePlanes,
+            int firstRow, int totalRows, const string& outFolder, int saverIndex);
+    /**
+     * This method will save into the given folder, alle the values of all
+     * the features computed for 1  directions
+     * @param featurePlanes: all the values computed
+     * @param directionIndex: index of the direction among the ones computed
+     * @param outputFolderPath
+     * @param append: add the values at the end of the files already present
+     * @param saverIndex: text writer used for saving all the files; -1 for
+     * spreading the files among all the workers
+     * @return false if any file couldn't be written
+     */
+    bool saveDirectedFeaturesToFiles(const FeaturePlanes& featurePlanes,
+            int directionIndex, const string& outputFolderPath, bool append,
+            int saverIndex);
+    /**
+     * This method will save into the given folder the description of the
+     * .npy files: dimensions, dtype, order of the features, direction and
+     * parameters used for computing them
+     * @param columns: columns of windows of each plane
+     * @param rows: rows of windows of each plane
+     * @param slices: slices of windows of each volume; 1 for images
+     * @param outputFolderPath
+     * @return false if the file couldn't be written
+     */
+    bool saveFeaturesMetadata(int columns, int rows, int slices,
+            const string& outputFolderPath);
+
+    // IMAGING
+    /**
+     * This method will produce and save all the images associated with each feature
+     * for each direction
+     * @param featurePlanes: all the values computed; each plane becomes an image
+     * @param outFolder: folder of the results of the image
+     * @param parallel: the workers encode the images; only when they
+     * aren't computing
+     */
+    void saveAllFeatureImages(const FeaturePlanes& featurePlanes,
+            const string& outFolder, bool parallel);
+
+private:
+    const ProgramArguments* progArg;
+    /**
+     * Pool whose idle workers save the files; NULL if there is none
+     */
+    ThreadPool* workers;
+    /**
+     * Text formatters, 1 for each worker, each with its own buffer; they
+     * are reused for every file
+     */
+    vector<TextFeatureWriter> textWriters;
+    /**
+     * Time and bytes of the files saved; NULL if not measured
+     */
+    PhaseTimes* phaseTimes;
+
+    /**
+     * Save a plane of values with a text writer, measuring the time and the
+     * bytes written
+     * @param writerIndex: text writer to use
+     * @param filePath: path of the file, without extension
+     * @param plane: the values to save
+     * @param featurePlanes: planes the values belong to
+     * @param append: add the values at the end of the file already present
+     * @return false if the file couldn't be written
+     */
+    bool saveTextPlane(int writerIndex, const string& filePath,
+            const double* plane, const FeaturePlanes& featurePlanes, bool append);
+    /**
+     * This method will save into the given folder, as .npy files, all the
+     * values of all the features computed for 1 direction
+     * @param featurePlanes: all the values computed
+     * @param directionIndex: index of the direction among the ones computed
+     * @param outputFolderPath
+     * @param append: add the values at the end of the files already present
+     * @param totalRows: how many rows of windows the whole image has
+     * @return false if any file couldn't be written
+     */
+    bool saveDirectedFeaturesToNpy(const FeaturePlanes& featurePlanes,
+            int directionIndex, const string& outputFolderPath, bool append,
+            int totalRows);
+    /**
+     * This method will produce and save all the images associated with
+     * each feature in 1 direction
+     * @param featurePlanes: all the values computed
+     * @param directionIndex: index of the direction among the ones computed
+     * @param outputFolderPath: where to save the image
+     * @param parallel: the workers encode the images; only when they
+     * aren't computing
+     */
+    void saveAllFeatureDirectedImages(const FeaturePlanes& featurePlanes,
+            int directionIndex, const string& outputFolderPath, bool parallel);
+    /**
+     * This method will produce and save on the filesystem the image associated with
+     * a feature in 1 direction
+     * @param rowNumber: how many rows the image will have
+     * @param colNumber: how many columns the image will have
+     * @param featureValues: plane of values that will be the intensities
+     * values of the image
+     * @param outputFilePath: where to save the image
+     */
+    void saveFeatureImage(int rowNumber,  int colNumber,
+            const double* featureValues, const string& outputFilePath);
+};
+
+
+#endif //FEATUREEXTRACTOR_FEATURESAVER_H
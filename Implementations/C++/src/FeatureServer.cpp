@@ -0,0 +1,218 @@
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <climits>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "FeatureServer.h"
+
+using namespace chrono;
+
+// Set by SIGINT/SIGTERM; the server stops at the end of the actual job
+static volatile sig_atomic_t interrupted = 0;
+
+static void stopServing(int){
+    interrupted = 1;
+}
+
+FeatureServer::FeatureServer(const ProgramArguments& progArg)
+        : progArg(progArg), glcmFeatures(progArg.numberOfThreads),
+        numberOfJobs(0), totalMilliseconds(0), shuttingDown(false){}
+
+int FeatureServer::openSocket(){
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(progArg.servePath.size() >= sizeof(address.sun_path)){
+        cerr << "ERROR! The socket path (--serve) is too long" << endl;
+        exit(-1);
+    }
+    strcpy(address.sun_path, progArg.servePath.c_str());
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listener < 0){
+        cerr << "ERROR! Can't create the socket: " << strerror(errno) << endl;
+        exit(-1);
+    }
+    // A socket left by a previous server that didn't stop cleanly
+    unlink(progArg.servePath.c_str());
+    if((bind(listener, (sockaddr*) &address, sizeof(address)) != 0)
+        || (listen(listener, SOMAXCONN) != 0)){
+        cerr << "ERROR! Can't listen on " << progArg.servePath << ": "
+             << strerror(errno) << endl;
+        exit(-1);
+    }
+    return listener;
+}
+
+void FeatureServer::serve(){
+    int listener = openSocket();
+
+    // Interruptions end the wait of poll() instead of restarting it
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stopServing;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    cout << endl << "- Serving on: " << progArg.servePath;
+    cout << endl << "- Threads: " << glcmFeatures.getWorkers().getNumberOfThreads()
+         << endl;
+
+    while(!interrupted && !shuttingDown){
+        // The listener first, then a slot for each client
+        vector<pollfd> sockets(connections.size() + 1);
+        sockets[0].fd = listener;
+        sockets[0].events = POLLIN;
+        for (size_t i = 0; i < connections.size(); ++i) {
+            sockets[i + 1].fd = connections[i].socket;
+            sockets[i + 1].events = POLLIN;
+        }
+        if(poll(sockets.data(), sockets.size(), -1) < 0){
+            if(errno == EINTR)
+                continue;
+            cerr << "ERROR! Waiting for the clients: " << strerror(errno) << endl;
+            break;
+        }
+
+        // Requests of the clients already connected; disconnected ones are removed
+        vector<Connection> stillConnected;
+        for (size_t i = 0; i < connections.size(); ++i) {
+            bool connected = true;
+            if(sockets[i + 1].revents != 0)
+                connected = handleRequest(connections[i]);
+            if(connected)
+                stillConnected.push_back(connections[i]);
+            else
+                close(connections[i].socket);
+        }
+        connections.swap(stillConnected);
+
+        if(sockets[0].revents & POLLIN){
+            int client = accept(listener, NULL, NULL);
+            if(client >= 0){
+                Connection connection = {client,
+                        shared_ptr<SharedMemory>(new SharedMemory())};
+                connections.push_back(connection);
+                if(progArg.verbose)
+                    cout << "* Client connected *" << endl;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < connections.size(); ++i) {
+        close(connections[i].socket);
+    }
+    connections.clear();
+    close(listener);
+    unlink(progArg.servePath.c_str());
+
+    cout << endl << "- Jobs computed: " << numberOfJobs;
+    if(numberOfJobs > 0)
+        cout << endl << "- Average time of each job: "
+             << totalMilliseconds / numberOfJobs << " ms";
+    cout << endl;
+}
+
+bool FeatureServer::handleRequest(Connection& connection){
+    ServeProtocol::Request request;
+    if(!ServeProtocol::receiveMessage(connection.socket, &request, sizeof(request)))
+        return false;
+    high_resolution_clock::time_point start = high_resolution_clock::now();
+
+    ServeProtocol::Reply reply = {ServeProtocol::MAGIC, ServeProtocol::JOB_DONE, 0};
+    if(request.magic != ServeProtocol::MAGIC){
+        cerr << "ERROR! Unknown message from a client" << endl;
+        return false;
+    }
+    if(request.type == ServeProtocol::SHUTDOWN_REQUEST){
+        cout << "* Shutdown requested by a client *" << endl;
+        shuttingDown = true;
+    }
+    else if(request.type == ServeProtocol::JOB_REQUEST){
+        reply.status = computeJob(request, *connection.memory);
+        duration<double, milli> elapsed = high_resolution_clock::now() - start;
+        reply.microseconds = (uint64_t) (elapsed.count() * 1000);
+        if(reply.status == ServeProtocol::JOB_DONE){
+            numberOfJobs++;
+            totalMilliseconds += elapsed.count();
+            cout << "* Job " << numberOfJobs << ": " << request.rows << "x"
+                 << request.columns << " pixels in " << elapsed.count()
+                 << " ms *" << endl;
+        }
+    }
+    else
+        reply.status = ServeProtocol::JOB_INVALID;
+    return ServeProtocol::sendMessage(connection.socket, &reply, sizeof(reply));
+}
+
+int FeatureServer::computeJob(const ServeProtocol::Request& request,
+        SharedMemory& memory){
+    if(memchr(request.shmName, '\0', sizeof(request.shmName)) == NULL)
+        return ServeProtocol::JOB_INVALID;
+    if((request.rows < 1) || (request.columns < 1)
+        || ((request.bitsPerPixel != 8) && (request.bitsPerPixel != 16))){
+        cerr << "ERROR! Job with an unsupported image layout" << endl;
+        return ServeProtocol::JOB_INVALID;
+    }
+    // Where pixels and results are, checked against the size of the object
+    uint64_t bytesPerPixel = request.bitsPerPixel / 8;
+    uint64_t pixelsBytes = request.stride * (request.rows - 1)
+            + request.columns * bytesPerPixel;
+    uint64_t numberOfValues = (uint64_t) request.rows * request.columns
+            * Features::getSupportedFeaturesCount();
+    uint64_t outputBytes = numberOfValues * sizeof(double);
+    if((request.stride < request.columns * bytesPerPixel)
+        || (request.stride > request.shmSize)
+        || (request.pixelsOffset > request.shmSize)
+        || (pixelsBytes > request.shmSize - request.pixelsOffset)
+        || (request.outputOffset > request.shmSize)
+        || (numberOfValues > request.shmSize)
+        || (outputBytes > request.shmSize - request.outputOffset)
+        || (request.pixelsOffset % bytesPerPixel != 0)
+        || (request.outputOffset % sizeof(double) != 0)){
+        cerr << "ERROR! Job with pixels or results outside the shared memory"
+             << endl;
+        return ServeProtocol::JOB_INVALID;
+    }
+    // The results must not overwrite the pixels
+    if((request.pixelsOffset < request.outputOffset + outputBytes)
+        && (request.outputOffset < request.pixelsOffset + pixelsBytes)){
+        cerr << "ERROR! Job with results over its pixels" << endl;
+        return ServeProtocol::JOB_INVALID;
+    }
+    if((request.windowSize > SHRT_MAX) || (request.distance > SHRT_MAX)
+        || (request.directionType > SHRT_MAX) || (request.borderType > SHRT_MAX)){
+        cerr << "ERROR! Job with parameters out of range" << endl;
+        return ServeProtocol::JOB_INVALID;
+    }
+
+    // Mapped again only when the client moves to another object
+    if(!memory.open(request.shmName, request.shmSize))
+        return ServeProtocol::JOB_MEMORY_ERROR;
+
+    PixelBuffer input = {memory.getData() + request.pixelsOffset,
+            request.bitsPerPixel, request.rows, request.columns,
+            (size_t) request.stride};
+    GLCMParameters parameters = {(short int) request.windowSize,
+            (short int) request.distance, (short int) request.directionType,
+            request.symmetric != 0, (short int) request.borderType,
+            request.quantitize != 0, request.quantitizationMax};
+    double* output = (double*) (memory.getData() + request.outputOffset);
+    try{
+        if(!glcmFeatures.extract(input, parameters, output)){
+            cerr << "ERROR! " << glcmFeatures.getLastError() << endl;
+            return ServeProtocol::JOB_INVALID;
+        }
+    }
+    catch (bad_alloc& e) {
+        // The next jobs can still fit
+        cerr << "ERROR! Not enough memory for the job" << endl;
+        return ServeProtocol::JOB_OUT_OF_MEMORY;
+    }
+    return ServeProtocol::JOB_DONE;
+}
@@ -0,0 +1,79 @@
+#ifndef FEATUREEXTRACTOR_FEATURESERVER_H
+#define FEATUREEXTRACTOR_FEATURESERVER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "ProgramArguments.h"
+#include "GLCMFeatures.h"
+#include "SharedMemory.h"
+#include "ServeProtocol.h"
+
+using namespace std;
+
+/**
+ * Server of the --serve mode: it keeps the workers and their memory warm
+ * and computes the images that local clients send through a Unix domain
+ * socket, with pixels and results in POSIX shared memory.
+ * Jobs of all the connected clients are computed one at a time, each with
+ * all the workers
+ */
+class FeatureServer {
+public:
+    /**
+     * Initialize the server
+     * @param progArg: parameters of the problem; the socket path and the
+     * number of threads are used, the features parameters come with each job
+     */
+    explicit FeatureServer(const ProgramArguments& progArg);
+    /**
+     * Listen on the socket and compute the jobs until a client asks for
+     * the shutdown or the process is interrupted (SIGINT/SIGTERM)
+     */
+    void serve();
+
+private:
+    /**
+     * A connected client, with the shared memory it used last
+     */
+    struct Connection {
+        int socket;
+        shared_ptr<SharedMemory> memory;
+    };
+
+    ProgramArguments progArg;
+    /**
+     * Computation of the windows; the work areas are reused by every job
+     * with the same window
+     */
+    GLCMFeatures glcmFeatures;
+    vector<Connection> connections;
+    /**
+     * Jobs computed since the start
+     */
+    unsigned long numberOfJobs;
+    double totalMilliseconds;
+    bool shuttingDown;
+
+    /**
+     * Create the socket and bind it to its path
+     * @return the listening socket
+     */
+    int openSocket();
+    /**
+     * Read a request of a client and reply to it
+     * @param connection: client with a request waiting
+     * @return false if the client disconnected
+     */
+    bool handleRequest(Connection& connection);
+    /**
+     * Compute the features of a job in its shared memory
+     * @param request: the job
+     * @param memory: mapping of the shared memory of the client
+     * @return status of the reply
+     */
+    int computeJob(const ServeProtocol::Request& request, SharedMemory& memory);
+};
+
+
+#endif //FEATUREEXTRACTOR_FEATURESERVER_H
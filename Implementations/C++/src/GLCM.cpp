@@ -24,6 +24,24 @@ GLCM::GLCM(const unsigned int * pixels, const ImageData& image,
     initializeGlcmElements();
 }
 
+GLCM::GLCM(const GrayPair* countedPairs, const int numberOfCountedPairs,
+        const int numberOfPairs, const ImageData& image, Window& windowData,
+        WorkArea& wa): pixels(NULL), image(image), windowData(windowData),
+        workArea(wa), grayPairs(wa.grayPairs), summedPairs(wa.summedPairs),
+        subtractedPairs(wa.subtractedPairs), xMarginalPairs(wa.xMarginalPairs),
+        yMarginalPairs(wa.yMarginalPairs), numberOfPairs(numberOfPairs)
+        {
+    // Replacing dirty memory with items that represent "available memory"
+    workArea.cleanup();
+    // The pairs were already found; only the other representations are needed
+    for (int i = 0; i < numberOfCountedPairs; ++i) {
+        grayPairs[i] = countedPairs[i];
+    }
+    effectiveNumberOfGrayPairs = numberOfCountedPairs;
+    codifyAggregatedPairs();
+    codifyMarginalPairs();
+}
+
 
 // Set the working area to initial condition
 GLCM::~GLCM(){
@@ -90,14 +108,14 @@ inline int GLCM::computeWindowRowOffset()
  * @return the index of the pixel in the array of pixels (linearized) of
  * the window
  */
-inline int GLCM::getReferenceIndex(const int i, const int j,
+inline size_t GLCM::getReferenceIndex(const int i, const int j,
                                    const int initialWindowRowOffset, const int initialWindowColumnOffset){
     int row = (i + windowData.imageRowsOffset) // starting point in the image
               + (initialWindowRowOffset * windowData.distance); // add direction shift
     int col = (j + windowData.imageColumnsOffset) + // starting point in the image
               (initialWindowColumnOffset * windowData.distance); // add direction shift
-    int index = ( row * image.getColumns()) + col;
-    assert(index >= 0);
+    assert((row >= 0) && (col >= 0));
+    size_t index = ((size_t) row * image.getColumns()) + col;
     return index;
 }
 
@@ -109,14 +127,14 @@ inline int GLCM::getReferenceIndex(const int i, const int j,
  * @return the index of the pixel in the array of pixels (linearized) of
  * the window
  */
-inline int GLCM::getNeighborIndex(const int i, const int j,
+inline size_t GLCM::getNeighborIndex(const int i, const int j,
                                   const int initialWindowColumnOffset){
     int row = (i + windowData.imageRowsOffset); // starting point in the image
     int col = (j + windowData.imageColumnsOffset) + // starting point in the image
               (initialWindowColumnOffset * windowData.distance) +  // add 135* right-shift
               (windowData.shiftColumns * windowData.distance); // add direction shift
-    int index = (row * image.getColumns()) + col;
-    assert(index >= 0);
+    assert((row >= 0) && (col >= 0));
+    size_t index = ((size_t) row * image.getColumns()) + col;
     return index;
 }
 
@@ -128,17 +146,13 @@ inline int GLCM::getNeighborIndex(const int i, const int j,
 inline void GLCM::insertElement(GrayPair* elements, const GrayPair actualPair,
         uint& lastInsertionPosition, bool symmetricity){
     int position = 0;
-    // Find if the element was already inserted, and where
-    while((!elements[position].compareTo(actualPair, symmetricity)) && (position < numberOfPairs))
+    /* Find if the element was already inserted, and where; only the
+     * inserted elements are searched, the rest is available memory */
+    while((position < lastInsertionPosition) && (!elements[position].compareTo(actualPair, symmetricity)))
         position++;
     // If found
-    if((lastInsertionPosition > 0) // 0,0 as first element will increase insertion position
-        && (position != numberOfPairs)){ // if the item was already inserted
+    if(position < lastInsertionPosition){ // if the item was already inserted
         elements[position].operator++();
-        if((actualPair.getGrayLevelI() == 0) && (actualPair.getGrayLevelJ() == 0)
-            && (elements[position].getFrequency() == actualPair.getFrequency()))
-            // corner case, inserted pair 0,0 that matches with every empty field
-            lastInsertionPosition++;
     }
     else
     {
@@ -164,11 +178,11 @@ void GLCM::initializeGlcmElements() {
         for (int j = 0; j < getWindowColsBorder(); j++)
         {
             // Extract the two pixels in the pair
-            int referenceIndex = getReferenceIndex(i, j,
+            size_t referenceIndex = getReferenceIndex(i, j,
                     initialWindowRowOffset, initialWindowColumnOffset);
             // Application limit: only up to 2^16 gray levels
             referenceGrayLevel = pixels[referenceIndex]; // should be safe
-            int neighborIndex = getNeighborIndex(i, j,
+            size_t neighborIndex = getNeighborIndex(i, j,
                     initialWindowColumnOffset);
             // Application limit: only up to 2^16 gray levels
             neighborGrayLevel = pixels[neighborIndex];  // should be safe
@@ -196,17 +210,13 @@ void GLCM::initializeGlcmElements() {
  */
 inline void GLCM::insertElement(AggregatedGrayPair* elements, const AggregatedGrayPair actualPair, uint& lastInsertionPosition){
     int position = 0;
-    // Find if the element was already inserted, and where
-    while((!elements[position].compareTo(actualPair)) && (position < numberOfPairs))
+    /* Find if the element was already inserted, and where; only the
+     * inserted elements are searched, the rest is available memory */
+    while((position < lastInsertionPosition) && (!elements[position].compareTo(actualPair)))
         position++;
     // If found
-    if((lastInsertionPosition > 0) && // corner case 0 as first elment
-        (position != numberOfPairs)){ // if the item was already inserted
+    if(position < lastInsertionPosition){ // if the item was already inserted
             elements[position].increaseFrequency(actualPair.getFrequency());
-        if((actualPair.getAggregatedGrayLevel() == 0) && // corner case 0 as regular element
-        (elements[position].getFrequency() == actualPair.getFrequency()))
-            // corner case, inserted 0 that matches with every empty field
-            lastInsertionPosition++;
     }
     else
     {
@@ -225,7 +235,7 @@ void GLCM::codifyAggregatedPairs() {
     // summed pairs first
     for(int i = 0 ; i < effectiveNumberOfGrayPairs; i++){
         // Create summed pairs first
-        grayLevelType k= grayPairs[i].getGrayLevelI() + grayPairs[i].getGrayLevelJ();
+        aggregatedGrayLevelType k= grayPairs[i].getGrayLevelI() + grayPairs[i].getGrayLevelJ();
         AggregatedGrayPair summedElement(k, grayPairs[i].getFrequency());
 
         insertElement(summedPairs, summedElement, lastInsertPosition);
@@ -236,7 +246,7 @@ void GLCM::codifyAggregatedPairs() {
     lastInsertPosition = 0;
     for(int i = 0 ; i < effectiveNumberOfGrayPairs; i++){
         int diff = grayPairs[i].getGrayLevelI() - grayPairs[i].getGrayLevelJ();
-        grayLevelType k= static_cast<uint>(abs(diff));
+        aggregatedGrayLevelType k= static_cast<uint>(abs(diff));
         AggregatedGrayPair element(k, grayPairs[i].getFrequency());
 
         insertElement(subtractedPairs, element, lastInsertPosition);
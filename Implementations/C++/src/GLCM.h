@@ -86,6 +86,23 @@ public:
      * representation needed for computing its features
       */
     GLCM(const unsigned int * pixels, const ImageData& image, Window& windowData, WorkArea& wa);
+    /**
+     * Constructor of the GLCM of a window whose gray pairs were already
+     * counted (ex. incrementally, while sliding the window on a volume); it
+     * generates all the other elements needed for extracting the features
+     * @param countedPairs: the different gray pairs of the window, each with
+     * its frequency
+     * @param numberOfCountedPairs: how many different gray pairs were found
+     * @param numberOfPairs: pixel pairs of the window (doubled if symmetric);
+     * at most the number of elements of the work area
+     * @param image: metadata about the image (maxGrayLevel)
+     * @param windowData: metadata about this window of interest
+     * @param wa: memory location where this object will create the arrays of
+     * representation needed for computing its features
+     */
+    GLCM(const GrayPair* countedPairs, int numberOfCountedPairs,
+         int numberOfPairs, const ImageData& image, Window& windowData,
+         WorkArea& wa);
     ~GLCM();
 
     // Getters method exposed for feature computer class
@@ -161,7 +178,7 @@ private:
      * @return the index of the pixel in the array of pixels (linearized) of
      * the window
      */
-    int getReferenceIndex(int row, int col, int initialRowOffset, int initialColumnOffset);
+    size_t getReferenceIndex(int row, int col, int initialRowOffset, int initialColumnOffset);
     /**
      * Addressing methods to get the neighbor pixel in each pair of the glcm
      * @param row in the sub-window of the neighbor pixel
@@ -170,7 +187,7 @@ private:
      * @return the index of the pixel in the array of pixels (linearized) of
      * the window
      */
-    int getNeighborIndex(int row, int col, int initialColumnOffset);
+    size_t getNeighborIndex(int row, int col, int initialColumnOffset);
     /**
      * Method that inserts a GrayPair in the pre-allocated memory
      * Uses that convention that GrayPair ( i=0, j=0, frequency=0) means
@@ -0,0 +1,459 @@
+#include <algorithm>
+#include <string>
+#include <cstdint>
+#include "GLCMFeatures.h"
+#include "Window.h"
+#include "WindowFeatureComputer.h"
+
+#define IMG16MAXGRAYLEVEL 65535
+#define IMG8MAXGRAYLEVEL 255
+
+GLCMFeatures::GLCMFeatures(const int numberOfThreads): workers(numberOfThreads),
+        phaseTimes(NULL), perfTotals(NULL), progress(NULL){
+    // Allocated by the first computation of each worker
+    workAreas.assign(workers.getNumberOfThreads(),
+            WorkArea(0, NULL, NULL, NULL, NULL, NULL, NULL));
+}
+
+GLCMFeatures::~GLCMFeatures(){
+    for (size_t i = 0; i < workAreas.size(); ++i) {
+        workAreas[i].release();
+    }
+}
+
+bool GLCMFeatures::extract(const PixelBuffer& input,
+        const GLCMParameters& parameters, double* output){
+    if(!checkInput(input, parameters, lastError))
+        return false;
+    lastError.clear();
+
+    /* The pixels of the previous image leave their memory to these ones;
+     * the borders are virtual, so only the pixels of the image are copied */
+    PhaseTimer pixelsTimer(phaseTimes, PIXELS_PHASE);
+    ImageData imgData = copyBand(input, 0, input.rows, 0, parameters.borderType,
+            0, parameters.quantitize, parameters.quantitizationMax, imagePixels,
+            &workers, &quantizationTable);
+    pixelsTimer.stop();
+    // The values go straight to the memory of the caller
+    FeaturePlanes featurePlanes(output, input.rows, input.columns, 1);
+    /* All the memory of the computation is taken before the output is
+     * touched, so that it is left as it was when some is missing */
+    Tile windows = getComputedWindows(imgData, parameters, featurePlanes);
+    TileScheduler scheduler(windows.lastRow, windows.lastColumn,
+            workers.getNumberOfThreads());
+    reserveWorkAreas(imgData, parameters);
+    // The windows excluded without borders are never written
+    fill(output, output + getOutputSize(input), 0.0);
+    computeScheduledFeatures(imagePixels.data(), imgData, parameters,
+            featurePlanes, scheduler);
+    return true;
+}
+
+const string& GLCMFeatures::getLastError() const{
+    return lastError;
+}
+
+size_t GLCMFeatures::getOutputSize(const PixelBuffer& input){
+    return (size_t) input.rows * input.columns
+            * Features::getSupportedFeaturesCount();
+}
+
+bool GLCMFeatures::checkInput(const PixelBuffer& input,
+        const GLCMParameters& parameters, string& error){
+    if((input.data == NULL) || (input.rows < 1) || (input.columns < 1)){
+        error = "Empty image";
+        return false;
+    }
+    if((input.bitsPerPixel != 8) && (input.bitsPerPixel != 16)){
+        error = "Unsupported depth type: " + to_string(input.bitsPerPixel)
+                + " bits per pixel";
+        return false;
+    }
+    if(input.stride < (size_t) input.columns * (input.bitsPerPixel / 8)){
+        error = "The stride of the rows is shorter than a row";
+        return false;
+    }
+    int imageSmallestSide = min(input.rows, input.columns);
+    if(parameters.windowSize > imageSmallestSide){
+        error = "The window side exceeds the smallest dimension ("
+                + to_string(imageSmallestSide) + ") of the image";
+        return false;
+    }
+    return checkParameters(parameters, error);
+}
+
+bool GLCMFeatures::checkParameters(const GLCMParameters& parameters,
+        string& error){
+    if(parameters.windowSize < 2){
+        error = "The window side must be >= 2";
+        return false;
+    }
+    if((parameters.distance < 1) || (parameters.distance >= parameters.windowSize)){
+        error = "The distance between every pixel pair must be >= 1 and "
+                "smaller than the window side";
+        return false;
+    }
+    if((parameters.directionType < 1) || (parameters.directionType > 4)){
+        error = "The type of directions must be a value between 1 and 4";
+        return false;
+    }
+    if((parameters.borderType < 0) || (parameters.borderType > 2)){
+        error = "The type of border must be a value between 0 and 2";
+        return false;
+    }
+    if(parameters.quantitize && (parameters.quantitizationMax < 1)){
+        error = "The maximum gray level of the quantization must be >= 1";
+        return false;
+    }
+    return true;
+}
+
+/* Bands with at least these pixels are copied by all the workers, a block
+ * of rows each; waking them up isn't worth it for smaller ones */
+#define PARALLEL_COPY_PIXELS (1 << 20)
+
+/**
+ * Copy the pixels of a row of the caller buffer as gray levels
+ * @param source: first pixel of the row
+ * @param columns: pixels of the row
+ * @param table: gray level of each intensity after the quantization; NULL
+ * when the intensities are kept
+ * @param destination: where the gray levels are put
+ */
+template <typename PixelType>
+static void copyRow(const PixelType* source, const int columns,
+        const unsigned int* table, unsigned int* destination){
+    // Separate loops without branches, so that the compiler can vectorize them
+    if(table == NULL){
+        for (int j = 0; j < columns; ++j)
+            destination[j] = source[j];
+    }
+    else{
+        for (int j = 0; j < columns; ++j)
+            destination[j] = table[source[j]];
+    }
+}
+
+Image GLCMFeatures::readBand(const PixelBuffer& input, const int firstRow,
+        const int lastRow, const int windowSide, const short int borderType,
+        const int borderSize, const bool quantitize, const int quantizationMax,
+        ThreadPool* workers, QuantizationTable* quantizationTable){
+    vector<unsigned int> pixels;
+    ImageData band = copyBand(input, firstRow, lastRow, windowSide, borderType,
+            borderSize, quantitize, quantizationMax, pixels, workers,
+            quantizationTable);
+    // The band owns the pixels copied, without copying them again
+    return Image(move(pixels), band.getRows(), band.getColumns(),
+            band.getMaxGrayLevel());
+}
+
+ImageData GLCMFeatures::copyBand(const PixelBuffer& input, const int firstRow,
+        const int lastRow, const int windowSide, const short int borderType,
+        int borderSize, const bool quantitize, int quantizationMax,
+        vector<unsigned int>& pixels, ThreadPool* workers,
+        QuantizationTable* quantizationTable){
+    if(borderType == 0)
+        borderSize = 0;
+    /* Rows of the bordered image needed: from the first window of the band
+     * to the last pixel of the windows of its last row */
+    int paddedRows = input.rows + 2 * borderSize;
+    int firstPaddedRow = firstRow;
+    int lastPaddedRow = min(lastRow + borderSize + windowSide, paddedRows);
+    if(windowSide == 0) // whole image
+        lastPaddedRow = paddedRows;
+    int paddedColumns = input.columns + 2 * borderSize;
+
+    int maxGrayLevel = (input.bitsPerPixel == 16) ? IMG16MAXGRAYLEVEL
+            : IMG8MAXGRAYLEVEL;
+    // The callers warn about it, if they want
+    if(quantitize && (quantizationMax > maxGrayLevel))
+        quantizationMax = maxGrayLevel;
+    /* Quantized level of every intensity, instead of a division for each
+     * pixel; the levels of the previous reads when they are the same */
+    shared_ptr<const vector<unsigned int>> quantizationLevels;
+    if(quantitize){
+        QuantizationTable localTable;
+        if(quantizationTable == NULL)
+            quantizationTable = &localTable;
+        quantizationLevels = quantizationTable->getLevels(maxGrayLevel, quantizationMax);
+    }
+    const unsigned int* table = quantitize ? quantizationLevels->data() : NULL;
+
+    pixels.resize((size_t) (lastPaddedRow - firstPaddedRow) * paddedColumns);
+    // Each row is read once, converted and bordered while it is written
+    auto copyRows = [&](const int firstCopiedRow, const int lastCopiedRow){
+        for (int i = firstCopiedRow; i < lastCopiedRow; ++i) {
+            unsigned int* destination = pixels.data()
+                    + (size_t) (i - firstPaddedRow) * paddedColumns;
+            // Border rows replicate the nearest row of the image, or are 0
+            int row = min(max(i - borderSize, 0), input.rows - 1);
+            if((row != i - borderSize) && (borderType == 1)){
+                fill(destination, destination + paddedColumns, 0);
+                continue;
+            }
+            const unsigned char* rowStart = (const unsigned char*) input.data
+                    + (size_t) row * input.stride;
+            unsigned int* inside = destination + borderSize;
+            if(input.bitsPerPixel == 16)
+                copyRow((const uint16_t*) rowStart, input.columns, table, inside);
+            else
+                copyRow(rowStart, input.columns, table, inside);
+            // Border columns replicate the nearest pixel of the row, or are 0
+            unsigned int leftLevel = (borderType == 1) ? 0 : inside[0];
+            unsigned int rightLevel = (borderType == 1) ? 0 : inside[input.columns - 1];
+            fill(destination, inside, leftLevel);
+            fill(inside + input.columns, destination + paddedColumns, rightLevel);
+        }
+    };
+
+    int copiedRows = lastPaddedRow - firstPaddedRow;
+    if((workers != NULL) && (workers->getNumberOfThreads() > 1)
+        && (pixels.size() >= PARALLEL_COPY_PIXELS)){
+        // Each worker copies a block of consecutive rows
+        int numberOfThreads = workers->getNumberOfThreads();
+        workers->run([&](int workerIndex){
+            int firstCopiedRow = firstPaddedRow
+                    + (int) ((long long) copiedRows * workerIndex / numberOfThreads);
+            int lastCopiedRow = firstPaddedRow
+                    + (int) ((long long) copiedRows * (workerIndex + 1) / numberOfThreads);
+            copyRows(firstCopiedRow, lastCopiedRow);
+        });
+    }
+    else
+        copyRows(firstPaddedRow, lastPaddedRow);
+    return ImageData(copiedRows, paddedColumns, borderSize, maxGrayLevel);
+}
+
+void GLCMFeatures::computeAllFeatures(const unsigned int * pixels, const ImageData& img,
+        const GLCMParameters& parameters, FeaturePlanes& featurePlanes){
+    Tile windows = getComputedWindows(img, parameters, featurePlanes);
+
+    // Split the windows in tiles that idle workers can steal from each other
+    TileScheduler scheduler(windows.lastRow, windows.lastColumn,
+            workers.getNumberOfThreads());
+    computeScheduledFeatures(pixels, img, parameters, featurePlanes, scheduler);
+}
+
+void GLCMFeatures::computeScheduledFeatures(const unsigned int * pixels,
+        const ImageData& img, const GLCMParameters& parameters,
+        FeaturePlanes& featurePlanes, TileScheduler& scheduler){
+    workers.run([&](int workerIndex){
+        // Each worker has its own working area; results go to disjoint windows
+        WorkArea& wa = getWorkArea(workerIndex, parameters);
+        wa.output = &featurePlanes;
+        // Counters of the events of this thread
+        PerfCounters counters;
+        startMeasures(wa, counters);
+
+        Tile tile;
+        while(scheduler.getNextTile(workerIndex, tile)){
+            computeTileFeatures(pixels, img, parameters, tile, wa);
+        }
+        wa.output = NULL;
+        collectMeasures(wa);
+    });
+    if(phaseTimes != NULL){
+        Tile windows = getComputedWindows(img, parameters, featurePlanes);
+        phaseTimes->addWindows((uint64_t) windows.lastRow * windows.lastColumn);
+    }
+}
+
+void GLCMFeatures::computeImageFeatures(const unsigned int * pixels, const ImageData& img,
+        const GLCMParameters& parameters, WorkArea& wa){
+    Tile windows = getComputedWindows(img, parameters, *wa.output);
+    PerfCounters counters;
+    startMeasures(wa, counters);
+    computeTileFeatures(pixels, img, parameters, windows, wa);
+    collectMeasures(wa);
+    if(phaseTimes != NULL)
+        phaseTimes->addWindows((uint64_t) windows.lastRow * windows.lastColumn);
+}
+
+void GLCMFeatures::setPhaseTimes(PhaseTimes* times){
+    phaseTimes = times;
+}
+
+void GLCMFeatures::setPerfTotals(PerfTotals* totals){
+    perfTotals = totals;
+}
+
+void GLCMFeatures::setProgress(ProgressReporter* reporter){
+    progress = reporter;
+}
+
+void GLCMFeatures::startMeasures(WorkArea& wa, PerfCounters& counters){
+    wa.timed = (phaseTimes != NULL);
+    if(perfTotals == NULL)
+        return;
+    // Without counters the windows are computed all the same
+    if(counters.open())
+        wa.perfCounters = &counters;
+    else
+        perfTotals->warnMissingCounters(counters);
+}
+
+void GLCMFeatures::collectMeasures(WorkArea& wa){
+    if(phaseTimes != NULL){
+        phaseTimes->add(GLCM_PHASE, wa.glcmNanoseconds);
+        phaseTimes->add(FEATURES_PHASE, wa.featuresNanoseconds);
+    }
+    wa.glcmNanoseconds = 0;
+    wa.featuresNanoseconds = 0;
+    wa.timed = false;
+    if(wa.perfCounters != NULL){
+        perfTotals->add(wa.perfCounts, wa.countedWindows, wa.countedPairs,
+                *wa.perfCounters);
+        for (int i = 0; i < NUMBER_OF_COUNTED_PHASES; ++i) {
+            fill(wa.perfCounts[i], wa.perfCounts[i] + NUMBER_OF_PERF_EVENTS, 0);
+        }
+        wa.countedWindows = 0;
+        wa.countedPairs = 0;
+        wa.perfCounters = NULL;
+    }
+}
+
+void GLCMFeatures::computeTileFeatures(const unsigned int * pixels, const ImageData& img,
+        const GLCMParameters& parameters, const Tile& tile, WorkArea& wa){
+    // Only the windows that go past the last row or column read the border
+    bool edgeTile = (tile.lastRow - 1 + parameters.windowSize > (int) img.getRows())
+            || (tile.lastColumn - 1 + parameters.windowSize > (int) img.getColumns());
+    if(hasVirtualBorders(img, parameters) && edgeTile)
+        computeEdgeTileFeatures(pixels, img, parameters, tile, wa);
+    else
+        computeWindowsFeatures(pixels, img, parameters, tile, wa);
+}
+
+void GLCMFeatures::computeWindowsFeatures(const unsigned int * pixels,
+        const ImageData& img, const GLCMParameters& parameters, const Tile& tile,
+        WorkArea& wa){
+    int appliedBorders = img.getBorderSize();
+    // Slide windows on the tile
+    for(int i = tile.firstRow; i < tile.lastRow ; i++){
+        for(int j = tile.firstColumn; j < tile.lastColumn ; j++){
+            // Create local window information
+            Window actualWindow {parameters.windowSize, parameters.distance,
+                                 parameters.directionType, parameters.symmetric};
+            // tell the window its relative offset (starting point) inside the image
+            actualWindow.setSpacialOffsets(i + appliedBorders, j + appliedBorders);
+            // Launch the computation of features on the window
+            WindowFeatureComputer wfc(pixels, img, actualWindow, wa);
+        }
+        if(progress != NULL)
+            progress->addWindows(tile.lastColumn - tile.firstColumn);
+    }
+}
+
+void GLCMFeatures::computeEdgeTileFeatures(const unsigned int * pixels,
+        const ImageData& img, const GLCMParameters& parameters, const Tile& tile,
+        WorkArea& wa){
+    // Pixels read by the windows of the tile; the windows never read above or left of their first pixel
+    int tileRows = tile.lastRow - tile.firstRow;
+    int tileColumns = tile.lastColumn - tile.firstColumn;
+    int haloRows = tileRows + parameters.windowSize - 1;
+    int haloColumns = tileColumns + parameters.windowSize - 1;
+    int lastRow = img.getRows() - 1;
+    int lastColumn = img.getColumns() - 1;
+    // Memory of the worker, grown only by the first edge tiles
+    vector<unsigned int>& halo = wa.haloPixels;
+    halo.resize((size_t) haloRows * haloColumns);
+    for (int i = 0; i < haloRows; ++i) {
+        int row = tile.firstRow + i;
+        const unsigned int* source = pixels + (size_t) min(row, lastRow) * img.getColumns();
+        for (int j = 0; j < haloColumns; ++j) {
+            int column = tile.firstColumn + j;
+            // Past the image: zero (1), or the nearest pixel of the image (2)
+            bool outside = (row > lastRow) || (column > lastColumn);
+            halo[(size_t) i * haloColumns + j] = (outside && (parameters.borderType == 1)) ?
+                    0 : source[min(column, lastColumn)];
+        }
+    }
+
+    /* The halo is a small image whose windows are all inside it; their
+     * values go straight to their place, through a view of the planes that
+     * starts from the first window of the tile */
+    ImageData haloData(haloRows, haloColumns, 0, img.getMaxGrayLevel());
+    FeaturePlanes* output = wa.output;
+    FeaturePlanes tilePlanes(output->getPlane((FeatureNames) 0, 0)
+            + (size_t) tile.firstRow * output->getColumns() + tile.firstColumn,
+            output->getRows(), output->getColumns(), output->getNumberOfDirections());
+    wa.output = &tilePlanes;
+    Tile haloTile = {0, tileRows, 0, tileColumns};
+    computeWindowsFeatures(halo.data(), haloData, parameters, haloTile, wa);
+    wa.output = output;
+}
+
+QuantizationTable& GLCMFeatures::getQuantizationTable(){
+    return quantizationTable;
+}
+
+ThreadPool& GLCMFeatures::getWorkers(){
+    return workers;
+}
+
+WorkArea& GLCMFeatures::getWorkArea(const int workerIndex,
+        const GLCMParameters& parameters){
+    int numberOfPairsInWindow = getNumberOfPairsInWindow(parameters);
+    WorkArea& wa = workAreas[workerIndex];
+    if(wa.numberOfElements != numberOfPairsInWindow){
+        // First use, or the window side changed since the last image
+        WorkArea allocated = WorkArea::allocate(numberOfPairsInWindow, NULL);
+        wa.release();
+        wa = allocated;
+    }
+    return wa;
+}
+
+void GLCMFeatures::reserveWorkAreas(const ImageData& img,
+        const GLCMParameters& parameters){
+    // The halo of an edge tile is never larger than the one of a whole tile
+    int haloSide = TileScheduler::DEFAULT_TILE_SIDE + parameters.windowSize - 1;
+    for (int i = 0; i < workers.getNumberOfThreads(); ++i) {
+        WorkArea& wa = getWorkArea(i, parameters);
+        if(hasVirtualBorders(img, parameters))
+            wa.haloPixels.reserve((size_t) haloSide * haloSide);
+    }
+}
+
+int GLCMFeatures::getAppliedBorders(const GLCMParameters& parameters){
+    int bordersToApply = 0;
+    if(parameters.borderType != 0 )
+        bordersToApply = parameters.windowSize;
+    return bordersToApply;
+}
+
+bool GLCMFeatures::hasVirtualBorders(const ImageData& img,
+        const GLCMParameters& parameters){
+    return (getAppliedBorders(parameters) > 0) && (img.getBorderSize() == 0);
+}
+
+Tile GLCMFeatures::getComputedWindows(const ImageData& img,
+        const GLCMParameters& parameters, const FeaturePlanes& featurePlanes){
+    // Virtual borders: a window for each pixel of the rows of the planes
+    if(hasVirtualBorders(img, parameters)){
+        Tile windows = {0, featurePlanes.getRows(), 0, (int) img.getColumns()};
+        return windows;
+    }
+
+    // Get dimensions of the original image without borders
+    int originalImageRows = img.getRows() - 2 * getAppliedBorders(parameters);
+    int originalImageCols = img.getColumns() - 2 * getAppliedBorders(parameters);
+
+    /* If no border is applied, window on the borders need to be excluded because
+        no pixel pair are available. Same as matlab graycomatrix.
+        The last rows of a band have the pixels of the next band below them */
+    if(parameters.borderType == 0){
+        originalImageRows -= parameters.windowSize;
+        originalImageCols -= parameters.windowSize;
+    }
+    Tile windows = {0, originalImageRows, 0, originalImageCols};
+    return windows;
+}
+
+int GLCMFeatures::getNumberOfPairsInWindow(const GLCMParameters& parameters){
+    int extimatedWindowRows = parameters.windowSize; // 0° has all rows
+    int extimateWindowCols = parameters.windowSize - (parameters.distance * 1); // at least 1 column is lost
+    int numberOfPairsInWindow = extimatedWindowRows * extimateWindowCols;
+    if(parameters.symmetric)
+        numberOfPairsInWindow *= 2;
+    return numberOfPairsInWindow;
+}
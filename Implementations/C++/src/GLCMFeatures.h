@@ -0,0 +1,342 @@
+#ifndef FEATUREEXTRACTOR_GLCMFEATURES_H
+#define FEATUREEXTRACTOR_GLCMFEATURES_H
+
+#include <vector>
+#include "GLCMParameters.h"
+#include "Image.h"
+#include "ImageData.h"
+#include "FeaturePlanes.h"
+#include "WorkArea.h"
+#include "ThreadPool.h"
+#include "TileScheduler.h"
+#include "QuantizationTable.h"
+#include "PhaseTimes.h"
+#include "ProgressReporter.h"
+#include "PerfCounters.h"
+
+using namespace std;
+
+/**
+ * Entry point of the glcmfeatures library: it computes the features of all
+ * the windows of pixels already in memory, without reading or writing any
+ * file, so that it can be linked without OpenCv.
+ * The workers and their memory are created once and reused for every
+ * image computed by the same instance, so an instance computes one image
+ * at a time; different instances can be used concurrently.
+ * The pixels can come with the borders of the parameters already applied,
+ * or without them (border size 0 in their metadata): the borders are then
+ * virtual. The windows of the tiles inside the image read the pixels as
+ * they are; only the tiles whose windows go past the last row or column
+ * copy their pixels, with the border, in a small halo
+ */
+class GLCMFeatures {
+public:
+    /**
+     * Create the workers
+     * @param numberOfThreads: workers that compute the windows of each
+     * image; values < 1 mean "as many as the cores of the machine"
+     */
+    explicit GLCMFeatures(int numberOfThreads);
+    /**
+     * Release the work areas of the workers
+     */
+    ~GLCMFeatures();
+    /**
+     * Compute all the features of every window of the image
+     * @param input: pixels of the image
+     * @param parameters: windows, pairs and borders to use
+     * @param output: at least getOutputSize(input) values, where the planes
+     * (rows x columns values for each feature, in the order of FeatureNames)
+     * are put; windows that are not computed without borders are 0
+     * @return false if the image or the parameters are not valid
+     * (getLastError() tells why); nothing is written in that case
+     * @throws bad_alloc if the memory of the computation is not available;
+     * it is all allocated before the output is written, so nothing is
+     * written in that case either
+     */
+    bool extract(const PixelBuffer& input, const GLCMParameters& parameters,
+            double* output);
+    /**
+     * Getter
+     * @return why the last image given to extract() was not valid; empty
+     * if it was
+     */
+    const string& getLastError() const;
+    /**
+     * Check the parameters that don't depend on the image
+     * @param parameters: windows, pairs and borders to use
+     * @param error: where the reason is put when they can't be computed
+     * @return false if they can't be computed
+     */
+    static bool checkParameters(const GLCMParameters& parameters, string& error);
+    /**
+     * Utility method
+     * @param input: pixels of the image
+     * @return how many values extract() puts in its output
+     */
+    static size_t getOutputSize(const PixelBuffer& input);
+    /**
+     * Build the Image with only the pixels needed by a band of rows of
+     * windows, with borders and quantization applied
+     * @param input: pixels of the whole image
+     * @param firstRow: first row of windows of the band
+     * @param lastRow: last row (excluded) of windows of the band
+     * @param windowSide: side of each window; windows of the last row of the
+     * band need the pixels below it. 0 for all the rows of the image
+     * @param borderType: type of the border to apply to the image
+     * @param borderSize: border to apply to each side of the image
+     * @param quantitize: reduction of grayLevels to apply to the image
+     * @param quantizationMax: maximum gray level when quantitization is
+     * applied to reduce the graylevels in [0,quantizationMax]; reduced to
+     * the maximum gray level of the image when larger
+     * @param workers: threads that copy the rows of large bands; NULL (the
+     * default) for the calling thread only. They must not be running a job
+     * @param quantizationTable: levels reused by the bands and images read
+     * with the same quantization; NULL (the default) for building them
+     * @return the band, with borders, as if it were a whole image of
+     * (lastRow - firstRow) rows of windows
+     */
+    static Image readBand(const PixelBuffer& input, int firstRow, int lastRow,
+            int windowSide, short int borderType, int borderSize,
+            bool quantitize, int quantizationMax, ThreadPool* workers = NULL,
+            QuantizationTable* quantizationTable = NULL);
+    /**
+     * Compute all the features for every window, spreading the windows
+     * among all the workers
+     * @param pixels: pixels intensities of the image provided, with borders
+     * or with virtual borders
+     * @param img: image metadata; border size 0 for virtual borders
+     * @param parameters: windows and pairs to use
+     * @param featurePlanes: where the values are put; one row of each plane
+     * for each row of windows of the image. With virtual borders the pixels
+     * below its rows are only read
+     */
+    void computeAllFeatures(const unsigned int * pixels, const ImageData& img,
+            const GLCMParameters& parameters, FeaturePlanes& featurePlanes);
+    /**
+     * Compute, on the calling thread only, all the features for every window
+     * @param pixels: pixels intensities of the image provided, with borders
+     * or with virtual borders
+     * @param img: image metadata; border size 0 for virtual borders
+     * @param parameters: windows and pairs to use
+     * @param wa: work area of the caller; results go to its planes
+     */
+    void computeImageFeatures(const unsigned int * pixels, const ImageData& img,
+            const GLCMParameters& parameters, WorkArea& wa);
+    /**
+     * Getter
+     * @return the workers; callers can run their own jobs on them between
+     * computations
+     */
+    ThreadPool& getWorkers();
+    /**
+     * Getter
+     * @return the quantization levels of the images extracted, that can be
+     * reused by the ones read with readBand
+     */
+    QuantizationTable& getQuantizationTable();
+    /**
+     * Measure the computations of this instance
+     * @param times: where the time of the phases and the computed windows
+     * are added; NULL (the default) doesn't measure anything
+     */
+    void setPhaseTimes(PhaseTimes* times);
+    /**
+     * Count the hardware events of the windows of the computations of this
+     * instance
+     * @param totals: where the events of all the threads are added; NULL
+     * (the default) doesn't count anything
+     */
+    void setPerfTotals(PerfTotals* totals);
+    /**
+     * Report the progress of the computations of this instance
+     * @param reporter: where the computed windows are added, row after row
+     * of each tile; NULL (the default) doesn't report anything
+     */
+    void setProgress(ProgressReporter* reporter);
+    /**
+     * Utility method
+     * @param workerIndex: worker that will use the work area
+     * @param parameters: windows and pairs to use
+     * @return the work area of the worker, allocated again only when the
+     * windows need a different number of pairs
+     */
+    WorkArea& getWorkArea(int workerIndex, const GLCMParameters& parameters);
+    /**
+     * Utility method
+     * @param parameters: border to apply
+     * @return border applied to each side of the image
+     */
+    static int getAppliedBorders(const GLCMParameters& parameters);
+
+private:
+    /**
+     * Workers that compute the windows of the image
+     */
+    ThreadPool workers;
+    /**
+     * Memory of each worker for the glcm of its windows
+     */
+    vector<WorkArea> workAreas;
+    /**
+     * Pixels, with borders, of the last image extracted; the memory is
+     * reused by the next images
+     */
+    vector<unsigned int> imagePixels;
+    /**
+     * Quantization levels of the images extracted
+     */
+    QuantizationTable quantizationTable;
+    /**
+     * Why the last image extracted was not valid
+     */
+    string lastError;
+    /**
+     * Where the time of the phases is added; NULL when not measured
+     */
+    PhaseTimes* phaseTimes;
+    /**
+     * Where the hardware events of the windows are added; NULL when not
+     * counted
+     */
+    PerfTotals* perfTotals;
+    /**
+     * Where the computed windows are added; NULL when not reported
+     */
+    ProgressReporter* progress;
+
+    /**
+     * The work areas are owned by this instance
+     */
+    GLCMFeatures(const GLCMFeatures& other);
+    /**
+     * Check that the image and the parameters can be computed
+     * @param input: pixels of the image
+     * @param parameters: windows, pairs and borders to use
+     * @param error: where the reason is put when they can't
+     * @return false if they can't
+     */
+    static bool checkInput(const PixelBuffer& input,
+            const GLCMParameters& parameters, string& error);
+    /**
+     * Copy the pixels needed by a band of rows of windows, with borders and
+     * quantization applied
+     * @param input: pixels of the whole image
+     * @param firstRow: first row of windows of the band
+     * @param lastRow: last row (excluded) of windows of the band
+     * @param windowSide: side of each window; 0 for all the rows of the image
+     * @param borderType: type of the border to apply to the image
+     * @param borderSize: border to apply to each side of the image
+     * @param quantitize: reduction of grayLevels to apply to the image
+     * @param quantizationMax: maximum gray level when quantitization is
+     * applied
+     * @param pixels: where the pixels of the band are put; its memory is
+     * reused when large enough
+     * @param workers: threads that copy the rows of large bands; NULL for
+     * the calling thread only
+     * @param quantizationTable: levels reused between the reads; NULL for
+     * building them
+     * @return metadata of the band, with borders
+     */
+    static ImageData copyBand(const PixelBuffer& input, int firstRow,
+            int lastRow, int windowSide, short int borderType, int borderSize,
+            bool quantitize, int quantizationMax, vector<unsigned int>& pixels,
+            ThreadPool* workers, QuantizationTable* quantizationTable);
+    /**
+     * Prepare a work area for measuring the windows that the calling thread
+     * computes with it
+     * @param wa: work area of the calling thread
+     * @param counters: hardware counters to open for the calling thread;
+     * they must last until the measures are collected
+     */
+    void startMeasures(WorkArea& wa, PerfCounters& counters);
+    /**
+     * Add the times and the events of the windows measured in a work area
+     * to the totals of this instance, and zero them
+     * @param wa: work area whose windows were measured
+     */
+    void collectMeasures(WorkArea& wa);
+    /**
+     * This method will compute the features of all the windows of a tile
+     * @param pixels: pixels intensities of the image provided
+     * @param img: image metadata
+     * @param parameters: windows and pairs to use
+     * @param tile: windows to compute
+     * @param wa: work area of the worker; results go to its planes
+     */
+    void computeTileFeatures(const unsigned int * pixels, const ImageData& img,
+            const GLCMParameters& parameters, const Tile& tile, WorkArea& wa);
+    /**
+     * This method will compute the features of the windows of a tile that
+     * read its pixels as they are
+     * @param pixels: pixels intensities of the image provided
+     * @param img: image metadata
+     * @param parameters: windows and pairs to use
+     * @param tile: windows to compute
+     * @param wa: work area of the worker; results go to its planes
+     */
+    void computeWindowsFeatures(const unsigned int * pixels, const ImageData& img,
+            const GLCMParameters& parameters, const Tile& tile, WorkArea& wa);
+    /**
+     * This method will compute the features of the windows of a tile at the
+     * edge of an image with virtual borders: its pixels are copied, with
+     * the border, in a halo of the work area where the windows are
+     * computed, and their values are written in the planes of the work area
+     * @param pixels: pixels intensities of the image provided, without borders
+     * @param img: image metadata
+     * @param parameters: windows, pairs and border to use
+     * @param tile: windows to compute
+     * @param wa: work area of the worker; results go to its planes
+     */
+    void computeEdgeTileFeatures(const unsigned int * pixels, const ImageData& img,
+            const GLCMParameters& parameters, const Tile& tile, WorkArea& wa);
+    /**
+     * Utility method
+     * @param img: image metadata
+     * @param parameters: windows and borders used
+     * @return true if the pixels don't have the border of the parameters,
+     * which is then applied while reading them
+     */
+    static bool hasVirtualBorders(const ImageData& img,
+            const GLCMParameters& parameters);
+    /**
+     * Compute the windows of the tiles of the scheduler, spreading them
+     * among all the workers
+     * @param pixels: pixels intensities of the image provided, with borders
+     * or with virtual borders
+     * @param img: image metadata; border size 0 for virtual borders
+     * @param parameters: windows and pairs to use
+     * @param featurePlanes: where the values are put
+     * @param scheduler: tiles of the windows of the image
+     */
+    void computeScheduledFeatures(const unsigned int * pixels, const ImageData& img,
+            const GLCMParameters& parameters, FeaturePlanes& featurePlanes,
+            TileScheduler& scheduler);
+    /**
+     * Allocate, before computing the image, the memory that every worker
+     * will need for its windows
+     * @param img: image metadata
+     * @param parameters: windows and borders used
+     * @throws bad_alloc if the memory is not available
+     */
+    void reserveWorkAreas(const ImageData& img, const GLCMParameters& parameters);
+    /**
+     * Utility method
+     * @param img: image metadata
+     * @param parameters: windows and borders used
+     * @param featurePlanes: planes of the values; with virtual borders, the
+     * windows of their rows are computed
+     * @return the range of windows of the image that will be computed
+     */
+    static Tile getComputedWindows(const ImageData& img,
+            const GLCMParameters& parameters, const FeaturePlanes& featurePlanes);
+    /**
+     * Utility method
+     * @param parameters: windows and pairs used
+     * @return worst case number of pairs of each working area
+     */
+    static int getNumberOfPairsInWindow(const GLCMParameters& parameters);
+};
+
+
+#endif //FEATUREEXTRACTOR_GLCMFEATURES_H
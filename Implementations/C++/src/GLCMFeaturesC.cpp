@@ -0,0 +1,132 @@
+#include <new>
+#include <string>
+#include <climits>
+#include "GLCMFeaturesC.h"
+#include "GLCMFeatures.h"
+
+/**
+ * What the opaque handle of the C interface points to
+ */
+struct glcm_context {
+    GLCMParameters parameters;
+    GLCMFeatures features;
+
+    glcm_context(const GLCMParameters& parameters, int numberOfThreads)
+            : parameters(parameters), features(numberOfThreads){};
+};
+
+/**
+ * Why the last function that failed on each thread did
+ */
+static thread_local string lastError;
+
+/**
+ * Keep why a function failed; nothing may throw across the C interface
+ * @param reason: what went wrong
+ * @param detail: what the exception that stopped the function says
+ */
+static void keepError(const char* reason, const char* detail = ""){
+    try{
+        lastError = string(reason) + detail;
+    }
+    catch (...) {
+        lastError.clear();
+    }
+}
+
+// The short ints of GLCMParameters must not wrap around
+inline bool fitsShort(const int value){
+    return (value >= SHRT_MIN) && (value <= SHRT_MAX);
+}
+
+glcm_context* glcm_create_context(const glcm_parameters* params){
+    if(params == NULL){
+        keepError("Missing parameters");
+        return NULL;
+    }
+    if(!fitsShort(params->window_size) || !fitsShort(params->distance)
+        || !fitsShort(params->direction_type) || !fitsShort(params->border_type)){
+        keepError("Parameters out of range");
+        return NULL;
+    }
+    GLCMParameters parameters = {(short int) params->window_size,
+            (short int) params->distance, (short int) params->direction_type,
+            params->symmetric != 0, (short int) params->border_type,
+            params->quantize != 0, params->quantization_max};
+    try{
+        if(!GLCMFeatures::checkParameters(parameters, lastError))
+            return NULL;
+        return new glcm_context(parameters, params->number_of_threads);
+    }
+    catch (exception& e) {
+        keepError("The context could not be created: ", e.what());
+    }
+    catch (...) {
+        keepError("The context could not be created");
+    }
+    return NULL;
+}
+
+int glcm_compute(glcm_context* context, const void* pixels,
+        const glcm_dimensions* dims, double* out_planes){
+    if((context == NULL) || (dims == NULL) || (out_planes == NULL)){
+        keepError("Missing context, dimensions or output");
+        return GLCM_INVALID_ARGUMENT;
+    }
+    PixelBuffer input = {pixels, dims->bits_per_pixel, dims->rows,
+            dims->columns, dims->stride};
+    try{
+        if(!context->features.extract(input, context->parameters, out_planes)){
+            keepError(context->features.getLastError().c_str());
+            return GLCM_INVALID_ARGUMENT;
+        }
+    }
+    catch (bad_alloc& e) {
+        keepError("Not enough memory for the image");
+        return GLCM_OUT_OF_MEMORY;
+    }
+    catch (exception& e) {
+        // Nothing may cross the C interface
+        keepError("The image could not be computed: ", e.what());
+        return GLCM_INVALID_ARGUMENT;
+    }
+    catch (...) {
+        keepError("The image could not be computed");
+        return GLCM_INVALID_ARGUMENT;
+    }
+    return GLCM_OK;
+}
+size_t glcm_output_size(const glcm_dimensions* dims){
+    if((dims == NULL) || (dims->rows < 0) || (dims->columns < 0))
+        return 0;
+    PixelBuffer input = {NULL, dims->bits_per_pixel, dims->rows,
+            dims->columns, dims->stride};
+    try{
+        return GLCMFeatures::getOutputSize(input);
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+int glcm_feature_count(void){
+    try{
+        return Features::getSupportedFeaturesCount();
+    }
+    catch (...) {
+        return 0;
+    }
+}
+
+const char* glcm_last_error(void){
+    return lastError.c_str();
+}
+
+void glcm_destroy_context(glcm_context* context){
+    try{
+        delete context;
+    }
+    catch (...) {
+        keepError("The context could not be destroyed");
+    }
+}
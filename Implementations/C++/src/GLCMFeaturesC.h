@@ -0,0 +1,155 @@
+#ifndef FEATUREEXTRACTOR_GLCMFEATURESC_H
+#define FEATUREEXTRACTOR_GLCMFEATURESC_H
+
+/*
+ * C interface of the glcmfeatures library, for programs that can't use its
+ * C++ classes (C, Go through cgo, ...). Only plain C types cross it and no
+ * C++ exception leaves it.
+ *
+ * A context owns the workers and all the memory they need; it is reused
+ * by every image computed with it, so after the first image nothing is
+ * allocated as long as the images don't grow. A context computes one image
+ * at a time; different contexts can be used concurrently from different
+ * threads.
+ *
+ * The output of each image has one plane of rows x columns values for each
+ * feature, in this order: ASM, AUTOCORRELATION, ENTROPY, MAXPROB,
+ * HOMOGENEITY, CONTRAST, DISSIMILARITY, CORRELATION, CLUSTERPROMINENCE,
+ * CLUSTERSHADE, SUMOFSQUARES, SUMAVERAGE, IDM, SUMENTROPY, SUMVARIANCE,
+ * DIFFENTROPY, DIFFVARIANCE, IMOC.
+ * The value of the window whose top-left pixel is (row, column) is at
+ * [feature * rows * columns + row * columns + column]
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Opaque handle of the workers and of their memory
+ */
+typedef struct glcm_context glcm_context;
+
+/**
+ * Parameters that decide the values of the features, fixed for the whole
+ * life of a context
+ */
+typedef struct {
+    /**
+     * Side of each squared window; at least 2
+     */
+    int window_size;
+    /**
+     * Modulus of the vector that links reference to neighbor pixel; in
+     * [1, window_size)
+     */
+    int distance;
+    /**
+     * Direction of the pairs: 1 = 0°, 2 = 45°, 3 = 90°, 4 = 135°
+     */
+    int direction_type;
+    /**
+     * Not 0 if pairs <i,j> and <j,i> are the same gray pair
+     */
+    int symmetric;
+    /**
+     * 0 = no border, 1 = zero pixel border, 2 = symmetric border
+     */
+    int border_type;
+    /**
+     * Not 0 for reducing the gray levels to [0, quantization_max]
+     */
+    int quantize;
+    int quantization_max;
+    /**
+     * Workers that compute the windows of each image; values < 1 mean
+     * "as many as the cores of the machine"
+     */
+    int number_of_threads;
+} glcm_parameters;
+
+/**
+ * Layout of the pixels of an image owned by the caller
+ */
+typedef struct {
+    int rows;
+    int columns;
+    /**
+     * 8 or 16; 16 bit pixels are in the byte order of the machine
+     */
+    int bits_per_pixel;
+    /**
+     * Bytes from the start of a row to the start of the next one
+     */
+    size_t stride;
+} glcm_dimensions;
+
+/**
+ * Results of the functions
+ */
+enum {
+    GLCM_OK = 0,
+    /**
+     * NULL pointers, or dimensions/parameters that can't be computed;
+     * glcm_last_error() tells why
+     */
+    GLCM_INVALID_ARGUMENT = -1,
+    /**
+     * The memory of the computation could not be allocated
+     */
+    GLCM_OUT_OF_MEMORY = -2
+};
+
+/**
+ * Create a context and its workers
+ * @param params: parameters of every image computed with the context
+ * @return the context, or NULL if the parameters are not valid or the
+ * workers could not be created; glcm_last_error() tells why
+ */
+glcm_context* glcm_create_context(const glcm_parameters* params);
+
+/**
+ * Compute all the features of every window of an image
+ * @param context: created by glcm_create_context
+ * @param pixels: first pixel of the first row of the image
+ * @param dims: layout of the pixels
+ * @param out_planes: at least glcm_output_size(dims) values, filled with
+ * the planes of the features; windows that are not computed without
+ * borders are 0
+ * @return GLCM_OK, or the error; out_planes is not written on errors
+ */
+int glcm_compute(glcm_context* context, const void* pixels,
+        const glcm_dimensions* dims, double* out_planes);
+
+/**
+ * @param dims: layout of the pixels of an image
+ * @return how many values glcm_compute puts in out_planes for the image
+ */
+size_t glcm_output_size(const glcm_dimensions* dims);
+
+/**
+ * @return how many features (planes) each image has
+ */
+int glcm_feature_count(void);
+
+/**
+ * Nothing is printed by the library: the functions that fail keep the
+ * reason here
+ * @return why the last function that failed on the calling thread did;
+ * valid until the next call of the thread
+ */
+const char* glcm_last_error(void);
+
+/**
+ * Release the workers and all the memory of the context
+ * @param context: created by glcm_create_context; NULL is ignored
+ */
+void glcm_destroy_context(glcm_context* context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //FEATUREEXTRACTOR_GLCMFEATURESC_H
@@ -0,0 +1,68 @@
+#ifndef FEATUREEXTRACTOR_GLCMPARAMETERS_H
+#define FEATUREEXTRACTOR_GLCMPARAMETERS_H
+
+#include <cstddef>
+
+/**
+ * Pixels of a grayscale image owned by the caller of the glcmfeatures
+ * library; they are only read
+ */
+struct PixelBuffer {
+    /**
+     * First pixel of the first row
+     */
+    const void* data;
+    /**
+     * 8 or 16; 16 bit pixels are unsigned shorts in the byte order of the
+     * machine
+     */
+    int bitsPerPixel;
+    int rows;
+    int columns;
+    /**
+     * Bytes from the start of a row to the start of the next one; at least
+     * columns * bitsPerPixel / 8
+     */
+    size_t stride;
+};
+
+/**
+ * Parameters that decide the values of the features; the command line
+ * tool fills them from its options
+ */
+struct GLCMParameters {
+    /**
+     * Side of each squared window
+     */
+    short int windowSize;
+    /**
+     * Modulus of the vector that links reference to neighbor pixel
+     */
+    short int distance;
+    /**
+     * Which direction to compute between 0°, 45°, 90°, 135° (1 to 4)
+     */
+    short int directionType;
+    /**
+     * Pairs <i,j> and <j,i> are the same gray pair
+     */
+    bool symmetric;
+    /**
+     * Type of border applied to the image:
+     * 0 = no border
+     * 1 = zero pixel border
+     * 2 = symmetric border
+     */
+    short int borderType;
+    /**
+     * Optional reduction of gray levels to range [0,Max]
+     */
+    bool quantitize;
+    /**
+     * Maximum gray level when the reduction of gray levels is applied
+     */
+    int quantitizationMax;
+};
+
+
+#endif //FEATUREEXTRACTOR_GLCMPARAMETERS_H
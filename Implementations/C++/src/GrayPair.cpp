@@ -15,6 +15,12 @@ GrayPair::GrayPair (grayLevelType i, grayLevelType j) {
    frequency = 1;
 }
 
+GrayPair::GrayPair (grayLevelType i, grayLevelType j, frequencyType frequency) {
+   grayLevelI = i;
+   grayLevelJ = j;
+   this->frequency = frequency;
+}
+
 void GrayPair::printPair()const {
     std::cout << "i: "<< grayLevelI;
     std::cout << "\tj: " << grayLevelJ;
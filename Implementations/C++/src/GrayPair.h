@@ -4,7 +4,8 @@
 // Custom types for easy future correction
 // Unsigned shorts half the memory footprint of the application
 typedef unsigned short grayLevelType;
-typedef unsigned short frequencyType;
+// Cubic windows of volumes can have more than 2^16 equal pairs
+typedef unsigned int frequencyType;
 
 /**
  * This class represent the gray levels of a pixel pair
@@ -21,6 +22,13 @@ public:
      * @param j grayLevel of the neighbor pixel of the pair
      */
     GrayPair(grayLevelType i, grayLevelType j);
+    /**
+     * Constructor for gray-tone pairs already counted
+     * @param i grayLevel of the reference pixel of the pair
+     * @param j grayLevel of the neighbor pixel of the pair
+     * @param frequency how many times the pair was found
+     */
+    GrayPair(grayLevelType i, grayLevelType j, frequencyType frequency);
     /**
      * Getter
      * @return the gray level of the reference pixel of the pair
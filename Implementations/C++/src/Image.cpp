@@ -8,8 +8,13 @@ unsigned int Image::getColumns() const{
     return columns;
 }
 
-vector<unsigned int> Image::getPixels() const{
-    return pixels;
+const unsigned int* Image::getPixels() const{
+    return pixels.data();
+}
+
+ImageView Image::getView() const{
+    ImageView view = {pixels.data(), rows, columns, columns};
+    return view;
 }
 
 unsigned int Image::getMaxGrayLevel() const{
@@ -21,7 +26,7 @@ void Image::printElements() const {
 
     for (unsigned int i = 0; i < rows; i++) {
         for (unsigned int j = 0; j < columns; j++) {
-            std::cout << pixels[i * rows + j] << " ";
+            std::cout << pixels[(size_t) i * columns + j] << " ";
         }
         std::cout << std::endl;
     }
@@ -6,29 +6,54 @@
 
 using namespace std;
 
+/**
+ * Pixels of an Image seen without owning them; valid while the Image lives
+ */
+struct ImageView {
+    const unsigned int* pixels;
+    unsigned int rows;
+    unsigned int columns;
+    /**
+     * Pixels from the start of a row to the start of the next one
+     */
+    size_t stride;
+};
+
 /**
  * This class represent the acquired image; it embeds:
  * - all its pixels as unsigned ints
  * - pysical dimensions (height, width as rows and columns)
  * - the maximum gray level that could be encountered according to its type
+ * The pixels are owned only by the image, which can be moved but not copied;
+ * the computations read them through getPixels or getView
  */
 class Image {
 public:
     /**
      * Constructor of the image
-     * @param pixels: all pixels of the image transformed into unsigned int
+     * @param pixels: all pixels of the image transformed into unsigned int;
+     * moved in the image, not copied, when the caller gives them away
      * @param rows
      * @param columns
      * @param mxGrayLevel: maximum gray level that can be encountered in the
      * image; depends on the image type and eventual quantitization applied
      */
     Image(vector<unsigned int> pixels, unsigned int rows, unsigned int columns, unsigned int mxGrayLevel)
-            :pixels(pixels), rows(rows), columns(columns), maxGrayLevel(mxGrayLevel){};
+            :pixels(move(pixels)), rows(rows), columns(columns), maxGrayLevel(mxGrayLevel){};
+    Image(const Image&) = delete;
+    Image& operator=(const Image&) = delete;
+    Image(Image&&) = default;
+    /**
+     * Getter
+     * @return the pixels of the image, row after row; they are owned by the
+     * image
+     */
+    const unsigned int* getPixels() const;
     /**
      * Getter
-     * @return the pixels of the image
+     * @return the pixels of the image with its dimensions
      */
-    vector<unsigned int> getPixels() const;
+    ImageView getView() const;
     /**
     * Getter
     * @return the number of rows of the image
@@ -11,6 +11,10 @@ uint ImageData::getColumns() const{
     return columns;
 }
 
+uint ImageData::getSlices() const{
+    return slices;
+}
+
 int ImageData::getBorderSize() const {
     return appliedBorders;
 }
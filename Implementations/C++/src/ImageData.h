@@ -8,7 +8,8 @@ using namespace std;
 
 /**
  * This class embeds metadata about the acquired image:
- * - pysical dimensions (height, width as rows and columns)
+ * - pysical dimensions (height, width as rows and columns; volumes also
+ * have a depth as slices)
  * - the maximum gray level that could be encountered according to its type
  *
  * On the CPU only the "Image" class should be used; it's still present to
@@ -23,11 +24,12 @@ public:
      * @param columns
      * @param borders
      * @param mxGrayLevel
+     * @param slices: 1 for images, the depth of volumes
      */
     explicit ImageData(unsigned int rows, unsigned int columns, int borders,
-            unsigned int mxGrayLevel)
+            unsigned int mxGrayLevel, unsigned int slices = 1)
             : rows(rows), columns(columns), appliedBorders(borders),
-            maxGrayLevel(mxGrayLevel){};
+            maxGrayLevel(mxGrayLevel), slices(slices){};
      /**
       * Constructor that strips metadata from the "complete" Image class
       * @param img complete image with pixels + metadata
@@ -35,7 +37,8 @@ public:
       */
     explicit ImageData(const Image& img, int borders)
             : rows(img.getRows()), columns(img.getColumns()),
-            appliedBorders(borders), maxGrayLevel(img.getMaxGrayLevel()){};
+            appliedBorders(borders), maxGrayLevel(img.getMaxGrayLevel()),
+            slices(1){};
     // Getters
     /**
      * Getter
@@ -47,6 +50,11 @@ public:
      * @return the number of columns of the image
      */
     unsigned int getColumns() const;
+    /**
+     * Getter
+     * @return the number of slices of a volume; 1 for images
+     */
+    unsigned int getSlices() const;
     /**
      * @return maximum gray level that can be encountered in the
      * image; depends on the image type and eventual quantitization applied
@@ -62,6 +70,7 @@ private:
     const unsigned int rows;
     const unsigned int columns;
     const unsigned int maxGrayLevel;
+    const unsigned int slices;
     // Amount of borders applied to each side of the original image
     int appliedBorders;
 };
@@ -1,11 +1,47 @@
 #include <iostream>
 #include <fstream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <exception>
 
 #include "ImageFeatureComputer.h"
+#include "NpyWriter.h"
+#include "MemoryPlanner.h"
 
+/**
+ * Utility method
+ * @param progArg: parameters of the problem
+ * @return the workers that compute the windows: the ones asked, fewer if
+ * their memory doesn't fit in the budget (--mem-budget)
+ */
+static int getPlannedThreads(const ProgramArguments& progArg){
+	if(progArg.memoryBudget == 0)
+		return progArg.numberOfThreads;
+	return MemoryPlanner(progArg).planThreads();
+}
 
 ImageFeatureComputer::ImageFeatureComputer(const ProgramArguments& progArg)
-:progArg(progArg){}
+:progArg(progArg), glcmFeatures(getPlannedThreads(progArg)),
+workers(glcmFeatures.getWorkers()), saver(this->progArg, &workers){
+	if(!progArg.cacheFolder.empty())
+		resultCache.reset(new ResultCache(progArg.cacheFolder, progArg.cacheSize));
+	if(!progArg.reportPath.empty()){
+		// Every phase of the computation is measured
+		phaseTimes.reset(new PhaseTimes());
+		glcmFeatures.setPhaseTimes(phaseTimes.get());
+		saver.setPhaseTimes(phaseTimes.get());
+	}
+	if(progArg.perfCounters){
+		perfTotals.reset(new PerfTotals());
+		glcmFeatures.setPerfTotals(perfTotals.get());
+	}
+	if(progArg.progress || !progArg.progressPath.empty()){
+		// The workers count their windows, a thread of its own reports them
+		progress.reset(new ProgressReporter(progArg.progress, progArg.progressPath));
+		glcmFeatures.setProgress(progress.get());
+	}
+}
 
 /**
  * Display a set of information about the computation of the provided image
@@ -15,13 +51,18 @@ ImageFeatureComputer::ImageFeatureComputer(const ProgramArguments& progArg)
 void ImageFeatureComputer::printInfo(const ImageData imgData, int border) {
 	cout << endl << "- Input image: " << progArg.imagePath;
 	cout << endl << "- Output folder: " << progArg.outputFolder;
-	int pixelCount = imgData.getRows() * imgData.getColumns();
-	int rows = imgData.getRows() - 2 * getAppliedBorders();
-    int cols = imgData.getColumns() - 2 * getAppliedBorders();
+	size_t pixelCount = (size_t) imgData.getRows() * imgData.getColumns();
+	int rows = imgData.getRows() - 2 * imgData.getBorderSize();
+    int cols = imgData.getColumns() - 2 * imgData.getBorderSize();
 	cout << endl << "- Rows: " << rows << " - Columns: " << cols << " - Pixel count: " << pixelCount;
 	cout << endl << "- Gray Levels : " << imgData.getMaxGrayLevel();
 	cout << endl << "- Distance: " << progArg.distance;
 	cout << endl << "- Window side: " << progArg.windowSize;
+	cout << endl << "- Threads: " << workers.getNumberOfThreads();
+	if(progArg.bandRows > 0)
+		cout << endl << "- Rows of each band: " << progArg.bandRows;
+	if(progArg.pipelineDepth > 0)
+		cout << endl << "- Bands waiting to be saved: " << progArg.pipelineDepth;
 }
 
 /**
@@ -30,17 +71,24 @@ void ImageFeatureComputer::printInfo(const ImageData imgData, int border) {
  * @param padding
  */
 void ImageFeatureComputer::printExtimatedSizes(const ImageData& img){
-    int numberOfRows = img.getRows() - progArg.windowSize + 1;
-    int numberOfColumns = img.getColumns() - progArg.windowSize + 1;
-    int numberOfWindows = numberOfRows * numberOfColumns;
+    size_t numberOfRows = img.getRows() - progArg.windowSize + 1;
+    size_t numberOfColumns = img.getColumns() - progArg.windowSize + 1;
+    size_t numberOfWindows = numberOfRows * numberOfColumns;
     int supportedFeatures = Features::getSupportedFeaturesCount();
 
-    int featureNumber = numberOfWindows * supportedFeatures;
+    size_t featureNumber = numberOfWindows * supportedFeatures;
     cout << endl << "* Size estimation * " << endl;
     cout << "\tTotal features number: " << featureNumber << endl;
-    int featureSize = (((featureNumber * sizeof(double))
+    size_t featureSize = (((featureNumber * sizeof(double))
                         /1024)/1024);
     cout << "\tTotal features weight: " <<  featureSize << " MB" << endl;
+    if(progArg.bandRows > 0){
+        // Only a band of windows is kept in memory at each time
+        size_t bandWindows = min(numberOfRows, (size_t) progArg.bandRows) * numberOfColumns;
+        size_t bandSize = (((bandWindows * supportedFeatures * sizeof(double))
+                            /1024)/1024);
+        cout << "\tFeatures weight of each band: " <<  bandSize << " MB" << endl;
+    }
 }
 
 /**
@@ -48,7 +96,7 @@ void ImageFeatureComputer::printExtimatedSizes(const ImageData& img){
  * @param progArg
  * @param img
  */
-void checkOptionCompatibility(ProgramArguments& progArg, const Image img){
+void checkOptionCompatibility(ProgramArguments& progArg, const ImageData& img){
     int imageSmallestSide = img.getRows();
     if(img.getColumns() < imageSmallestSide)
         imageSmallestSide = img.getColumns();
@@ -66,10 +114,83 @@ void checkOptionCompatibility(ProgramArguments& progArg, const Image img){
  * @return applied border to the original image read
  */
 int ImageFeatureComputer::getAppliedBorders(){
-    int bordersToApply = 0;
-    if(progArg.borderType != 0 )
-        bordersToApply = progArg.windowSize;
-    return bordersToApply;
+    return GLCMFeatures::getAppliedBorders(progArg.getGLCMParameters());
+}
+
+/**
+ * Utility method
+ * @param rows: rows of the image, without borders
+ * @param columns: columns of the image, without borders
+ * @param windowSide: side of each window
+ * @param borderType: border applied to the image
+ * @return how many windows of the image are computed
+ */
+uint64_t ImageFeatureComputer::countComputedWindows(const int rows,
+        const int columns, const int windowSide, const short int borderType){
+    // Without borders, the windows that would go out of the image are skipped
+    if(borderType == 0)
+        return (uint64_t) max(0, rows - windowSide) * max(0, columns - windowSide);
+    return (uint64_t) rows * columns;
+}
+
+/**
+ * Read the pixels needed by a band of rows of windows, with the quantization
+ * of the options, measuring the time. The borders of the options aren't
+ * copied: they are virtual, applied by the library only to the windows
+ * that go past the image
+ * @param imgRead: the image read from the file
+ * @param firstRow: first row of windows of the band
+ * @param lastRow: last row (excluded) of windows of the band
+ * @param windowSide: side of each window; 0 for all the rows of the image
+ * @param parallel: the workers copy the rows of large bands; only when they
+ * aren't computing
+ * @return the band, without borders
+ */
+Image ImageFeatureComputer::readImageBand(const Mat& imgRead, const int firstRow,
+		const int lastRow, const int windowSide, const bool parallel){
+	PhaseTimer pixelsTimer(phaseTimes.get(), PIXELS_PHASE);
+	return ImageLoader::readImageBand(imgRead, firstRow, lastRow, windowSide,
+			progArg.borderType, 0, progArg.quantitize,
+			progArg.quantitizationMax, parallel ? &workers : NULL,
+			&glcmFeatures.getQuantizationTable());
+}
+
+/**
+ * Choose the rows of each band and the bands waiting to be saved so that
+ * the computation of the image fits in the memory budget, and print the plan
+ * @param imgRead: the image read from the file
+ */
+void ImageFeatureComputer::planMemory(const Mat& imgRead){
+	MemoryPlanner planner(progArg);
+	// Without /proc, at least the image read
+	unsigned long long usedBytes = max(Utils::getResidentMemory(),
+			(unsigned long long) imgRead.total() * imgRead.elemSize());
+	MemoryPlan plan = planner.planImage(imgRead.rows, imgRead.cols, usedBytes,
+			workers.getNumberOfThreads());
+	planner.printPlan(plan, imgRead.rows);
+	if(!plan.fits){
+		cerr << "ERROR! The memory budget (--mem-budget) is too small for this "
+				"image: bands of 1 row need " << plan.getTotalBytes() << " bytes" << endl;
+		exit(3);
+	}
+	progArg.bandRows = (plan.bandRows < imgRead.rows) ? plan.bandRows : 0;
+	progArg.pipelineDepth = plan.pipelineDepth;
+}
+
+/**
+ * Stop the computation of an image whose files couldn't be saved (ex. full
+ * disk): its checkpoint stays at the last band saved whole, so that the
+ * run can be resumed from there
+ * @param firstRow: first row of windows of the band not saved
+ * @param lastRow: last row (excluded) of windows of the band not saved
+ */
+void ImageFeatureComputer::exitUnsavedBand(const int firstRow, const int lastRow){
+	cerr << "ERROR! The rows [" << firstRow << ", " << lastRow << ") of windows "
+			"could not be saved";
+	if(progArg.bandRows > 0)
+		cerr << "; the run can be resumed (--resume) from the last band saved";
+	cerr << endl;
+	exit(-1);
 }
 
 /**
@@ -77,45 +198,228 @@ int ImageFeatureComputer::getAppliedBorders(){
  * results and save them as need on the file system
  */
 void ImageFeatureComputer::compute(){
+	if(progress)
+		progress->start();
+	computeInput();
+	if(progress)
+		progress->stop();
+}
+
+/**
+ * This method will read the input (image, stack, volume or batch) and
+ * compute and save the features of all its windows
+ */
+void ImageFeatureComputer::computeInput(){
 	bool verbose = progArg.verbose;
 
-	// Image from imageLoader
-	Image image = ImageLoader::readImage(progArg.imagePath, progArg.borderType,
-                                         getAppliedBorders(), progArg.quantitize,
-                                         progArg.quantitizationMax);
-	ImageData imgData(image, getAppliedBorders());
+	// Image from imageLoader, still in its compact representation
+	if(!progArg.batchPath.empty()){
+		// Many images, each with its own output folder
+		computeBatch();
+		return;
+	}
+	PhaseTimer loadTimer(phaseTimes.get(), LOAD_PHASE);
+	vector<Mat> pages = ImageLoader::readImageStack(progArg.imagePath);
+	loadTimer.stop();
+	if(progArg.volumetric){
+		// The pages are the slices of a volume with cubic windows
+		computeVolume(pages);
+		return;
+	}
+	if(progArg.windowSizes.size() > 1){
+		// Every window size from a single traversal of the image
+		if(pages.size() > 1){
+			cerr << "ERROR! Many window sizes (-w) can only be computed for "
+					"single images" << endl;
+			exit(-1);
+		}
+		computeSweep(pages[0]);
+		return;
+	}
+	if(pages.size() > 1){
+		// Each page is a slice of a volume
+		computeStack(pages);
+		return;
+	}
+	Mat imgRead = pages[0];
+	int originalRows = imgRead.rows;
+	int originalCols = imgRead.cols;
 	if(verbose)
     	cout << endl << "* Image loaded * ";
-    checkOptionCompatibility(progArg, image);
-    // Print computation info to cout
-	printInfo(imgData, progArg.windowSize);
-	if(verbose) {
-		// Additional info on memory occupation
-		printExtimatedSizes(imgData);
+	if(progArg.memoryBudget > 0)
+		planMemory(imgRead);
+
+	// Without bands the whole image is computed at once
+	bool streaming = (progArg.bandRows > 0) && (progArg.bandRows < originalRows);
+	int bandRows = streaming ? progArg.bandRows : originalRows;
+	if(streaming && progArg.createImages){
+		cout << endl << "WARNING! Feature images need all the values of the image;"
+				" they can't be created when computing by bands" << endl;
+		progArg.createImages = false;
+	}
+	if(streaming && resultCache){
+		cout << endl << "WARNING! Only whole images are kept in the cache;"
+				" --cache-dir is ignored when computing by bands" << endl;
 	}
 
-	// Compute every feature
-	if(verbose)
-		cout << "* COMPUTING features * " << endl;
-	vector<vector<WindowFeatures>> fs= computeAllFeatures(image.getPixels().data(), imgData);
-	vector<vector<FeatureValues>> formattedFeatures = getAllDirectionsAllFeatureValues(fs);
-	if(verbose)
-		cout << "* Features computed * " << endl;
-
-	// Save result to file
-	if(verbose)
-		cout << "* Saving features to files *" << endl;
-	saveFeaturesToFiles(formattedFeatures);
+	/* The rows of windows already saved are recorded after each band, so
+	 * that a stopped run can be resumed from the last band saved */
+	Checkpoint checkpoint(progArg.outputFolder,
+			streaming ? getCheckpointKey(imgRead) : "");
+	int resumedRows = 0;
+	if(streaming && progArg.resume){
+		resumedRows = checkpoint.restore();
+		if(resumedRows >= originalRows)
+			cout << endl << "* All the bands were already saved * " << endl;
+		else if(resumedRows > 0)
+			cout << endl << "* Resuming from row " << resumedRows << " * " << endl;
+	}
 
-	// Save feature images
-	if(progArg.createImages){
-		if(verbose)
-			cout << "* Creating feature images *" << endl;
-		// Compute how many features will be used for creating the image
-        int realImageRows = image.getRows() - 2 * getAppliedBorders();
-        int realImageCols = image.getColumns() - 2 * getAppliedBorders();
-        saveAllFeatureImages(realImageRows, realImageCols, formattedFeatures);
+	/* Pipelined mode: a thread saves the feature files and another the
+	 * feature images of the bands already computed. Each queue holds at most
+	 * pipelineDepth bands, so the compute stops when the savers fall behind */
+	bool pipelined = (progArg.pipelineDepth > 0);
+	BoundedQueue<ComputedBand> fileQueue(progArg.pipelineDepth);
+	BoundedQueue<ComputedBand> imageQueue(progArg.pipelineDepth);
+	thread fileSaver;
+	thread imageSaver;
+	/* What stopped a saver, given back by this thread; the other bands are
+	 * then neither computed nor saved */
+	exception_ptr fileSaverError;
+	exception_ptr imageSaverError;
+	atomic<bool> saverFailed(false);
+	if(pipelined){
+		fileSaver = thread([&](){
+			ComputedBand band;
+			try{
+				while(fileQueue.pop(band)){
+					if(verbose)
+						cout << "* Saving features to files *" << endl;
+					bool saved = saver.saveFeaturesToFiles(*band.featurePlanes,
+							band.firstRow, originalRows, progArg.outputFolder, 0);
+					int lastRow = band.firstRow + band.featurePlanes->getRows();
+					if(!saved)
+						exitUnsavedBand(band.firstRow, lastRow);
+					if(streaming)
+						checkpoint.save(lastRow);
+				}
+			}
+			catch (...) {
+				fileSaverError = current_exception();
+				saverFailed = true;
+				// The compute never waits for room in the queue
+				while(fileQueue.pop(band)){}
+			}
+		});
+		if(progArg.createImages){
+			imageSaver = thread([&](){
+				ComputedBand band;
+				try{
+					while(imageQueue.pop(band)){
+						if(verbose)
+							cout << "* Creating feature images *" << endl;
+						saver.saveAllFeatureImages(*band.featurePlanes,
+								progArg.outputFolder, false);
+					}
+				}
+				catch (...) {
+					imageSaverError = current_exception();
+					saverFailed = true;
+					while(imageQueue.pop(band)){}
+				}
+			});
+		}
+	}
+	// Wait for the savers to empty their queues
+	auto stopSavers = [&](){
+		fileQueue.close();
+		imageQueue.close();
+		fileSaver.join();
+		if(imageSaver.joinable())
+			imageSaver.join();
+	};
+
+	try{
+		for(int firstRow = resumedRows; (firstRow < originalRows) && !saverFailed;
+				firstRow += bandRows){
+			int lastRow = min(firstRow + bandRows, originalRows);
+			// Only the pixels needed by the windows of this band
+			Image image = readImageBand(imgRead, firstRow, lastRow, progArg.windowSize,
+					true);
+			ImageData imgData(image, 0);
+
+			if(firstRow == resumedRows){
+				// Metadata of the whole image, with borders
+				ImageData wholeImgData(originalRows + 2 * getAppliedBorders(),
+						originalCols + 2 * getAppliedBorders(), getAppliedBorders(),
+						image.getMaxGrayLevel());
+				checkOptionCompatibility(progArg, wholeImgData);
+				if(progress)
+					progress->addTotalWindows(countComputedWindows(
+							originalRows - resumedRows, originalCols, progArg.windowSize,
+							progArg.borderType));
+				// Print computation info to cout
+				printInfo(wholeImgData, progArg.windowSize);
+				if(verbose) {
+					// Additional info on memory occupation
+					printExtimatedSizes(wholeImgData);
+				}
+			}
+
+			// Compute every feature
+			if(verbose){
+				if(streaming)
+					cout << "* COMPUTING features of rows [" << firstRow << ", "
+						<< lastRow << ") * " << endl;
+				else
+					cout << "* COMPUTING features * " << endl;
+			}
+			FeaturePlanes featurePlanes = streaming ?
+					computeAllFeatures(image.getPixels(), imgData, lastRow - firstRow)
+					: computeCachedFeatures(image, imgData, lastRow - firstRow, NULL);
+			if(verbose)
+				cout << "* Features computed * " << endl;
+
+			if(pipelined){
+				// The savers take the band while the next one is computed
+				ComputedBand band = {shared_ptr<const FeaturePlanes>(
+						new FeaturePlanes(move(featurePlanes))), firstRow};
+				fileQueue.push(band);
+				if(progArg.createImages)
+					imageQueue.push(band);
+				continue;
+			}
+
+			// Save result to file; bands after the first are appended
+			if(verbose)
+				cout << "* Saving features to files *" << endl;
+			if(!saver.saveFeaturesToFiles(featurePlanes, firstRow, originalRows,
+					progArg.outputFolder, -1))
+				exitUnsavedBand(firstRow, lastRow);
+			if(streaming)
+				checkpoint.save(lastRow);
+
+			// Save feature images
+			if(progArg.createImages){
+				if(verbose)
+					cout << "* Creating feature images *" << endl;
+				saver.saveAllFeatureImages(featurePlanes, progArg.outputFolder, true);
+			}
+		}
+	}
+	catch (...) {
+		// The bands already computed are still saved, and the savers stopped
+		if(pipelined)
+			stopSavers();
+		throw;
+	}
 
+	if(pipelined){
+		stopSavers();
+		if(fileSaverError)
+			rethrow_exception(fileSaverError);
+		if(imageSaverError)
+			rethrow_exception(imageSaverError);
 	}
 	if(verbose)
 		cout << "* DONE * " << endl;
@@ -124,285 +428,609 @@ void ImageFeatureComputer::compute(){
 
 
 /**
- * This method will re-arrange (de-linearize) all the feature values
- * computed window per window in a structure organized as features
- * values of a feature, for each direction, for each window of the image
- * @param featureValues: all the features computed, window per window
- * @param numberOfWindows: how many windows were computed
- * @param featuresCount: how many features were computed in each window
- * @return structured array (windowFeatures [] where each cell has
- * directionFeatures[] where each cell has double[] = features)
+ * Print the time of each phase of the computation, the windows computed
+ * per second, the bytes written and the hardware events of the windows, and
+ * save them in the report
+ * @param seconds: duration of the whole run
  */
-vector<vector<vector<double>>> formatOutputResults(const double* featureValues,
-                                                   const int numberOfWindows, const int featuresCount){
-    // For each window, an array of directions,
-    // For each direction, an array of features
-    vector<vector<vector<double>>> output(numberOfWindows,
-                                          vector<vector<double>>(1, vector<double> (featuresCount)));
-    // How many double values fit into a window
-    int windowResultsSize = featuresCount;
-
-    for (int k = 0; k < numberOfWindows; ++k) {
-        int windowOffset = k * windowResultsSize;
-        const double* windowResultsStartingPoint = featureValues + windowOffset;
-
-        // Copy each of the values
-        vector<double> singleDirectionFeatures(windowResultsStartingPoint,
-        		windowResultsStartingPoint + windowResultsSize);
-		output[k][0] = singleDirectionFeatures;
-	}
-
-    return output;
+void ImageFeatureComputer::reportMeasures(const double seconds){
+	if(phaseTimes)
+		phaseTimes->print(cout, seconds);
+	if(perfTotals)
+		perfTotals->print(cout);
+	if(progArg.reportPath.empty())
+		return;
+
+	ofstream file(progArg.reportPath.c_str());
+	if(!file.is_open()){
+		cerr << "Couldn't save the report to " << progArg.reportPath << endl;
+		return;
+	}
+	file << "{" << endl;
+	file << "  \"input\": " << Utils::toJsonString(progArg.batchPath.empty() ?
+			progArg.imagePath : progArg.batchPath) << "," << endl;
+	file << "  \"threads\": " << workers.getNumberOfThreads() << "," << endl;
+	file << "  \"windowSize\": " << progArg.windowSize << "," << endl;
+	file << "  \"distance\": " << progArg.distance << "," << endl;
+	phaseTimes->writeJson(file, seconds);
+	if(perfTotals){
+		file << "," << endl << "  \"counters\": ";
+		perfTotals->writeJson(file);
+	}
+	file << endl << "}" << endl;
+	cout << "- Report saved in " << progArg.reportPath << endl;
 }
 
-
 /**
- * This method will compute all the features for every window for the
- * number of directions provided
- * @param pixels: pixels intensities of the image provided
- * @param img: image metadata
- * @return array (1 for each window) of array (1 for each computed direction)
- * of array of doubles (1 for each feature)
+ * Utility method
+ * @param imgRead: the image read from the file
+ * @return identifier of the image and of every parameter that changes the
+ * files of the results
  */
-vector<vector<WindowFeatures>> ImageFeatureComputer::computeAllFeatures(unsigned int * pixels, const ImageData& img){
-	// Create the metadata of each window that will be created
-	Window windowData = Window(progArg.windowSize, progArg.distance, progArg.directionType, progArg.symmetric);
-
-	// Get dimensions of the original image without borders
-    int originalImageRows = img.getRows() - 2 * getAppliedBorders();
-    int originalImageCols = img.getColumns() - 2 * getAppliedBorders();
-
-    // Pre-Allocation of working areas
-
-	// How many windows need to be allocated
-    int numberOfWindows = (originalImageRows * originalImageCols);
-    // How many directions need to be allocated for each window
-    short int numberOfDirs = 1;
-    // How many feature values need to be allocated for each direction
-    int featuresCount = Features::getSupportedFeaturesCount();
-
-    // Pre-Allocate the array that will contain features
-    size_t featureSize = numberOfWindows * numberOfDirs * featuresCount * sizeof(double);
-    double* featuresList = (double*) malloc(featureSize);
-    if(featuresList == NULL){
-        cerr << "FATAL ERROR! Not enough mallocable memory on the system" << endl;
-        exit(3);
-    }
-
-    // 	Pre-Allocate working area
-    int extimatedWindowRows = windowData.side; // 0° has all rows
-    int extimateWindowCols = windowData.side - (windowData.distance * 1); // at least 1 column is lost
-    int numberOfPairsInWindow = extimatedWindowRows * extimateWindowCols;
-    if(windowData.symmetric)
-        numberOfPairsInWindow *= 2;
-
-    // Each 1 of these data structures allow 1 thread to work
-	GrayPair* elements = (GrayPair*) malloc(sizeof(GrayPair)
-	        * numberOfPairsInWindow);
-	AggregatedGrayPair* summedPairs = (AggregatedGrayPair*) malloc(sizeof(AggregatedGrayPair)
-	        * numberOfPairsInWindow );
-    AggregatedGrayPair* subtractedPairs = (AggregatedGrayPair*) malloc(sizeof(AggregatedGrayPair)
-            * numberOfPairsInWindow);
-    AggregatedGrayPair* xMarginalPairs = (AggregatedGrayPair*) malloc(sizeof(AggregatedGrayPair)
-            * numberOfPairsInWindow);
-    AggregatedGrayPair* yMarginalPairs = (AggregatedGrayPair*) malloc(sizeof(AggregatedGrayPair)
-            * numberOfPairsInWindow);
-
-    WorkArea wa(numberOfPairsInWindow, elements, summedPairs,
-                subtractedPairs, xMarginalPairs, yMarginalPairs, featuresList);
-
-    /* If no border is applied, window on the borders need to be excluded because
-		no pixel pair are available. Same as matlab graycomatrix */
-    if(progArg.borderType == 0){
-    	originalImageRows -= windowData.side;
-    	originalImageCols -= windowData.side;
-    }
-
-    // Slide windows on the image
-    for(int i = 0; i < originalImageRows ; i++){
-        for(int j = 0; j < originalImageCols ; j++){
-            // Create local window information
-            Window actualWindow {windowData.side, windowData.distance,
-                                 progArg.directionType, windowData.symmetric};
-            // tell the window its relative offset (starting point) inside the image
-            actualWindow.setSpacialOffsets(i + getAppliedBorders(), j + getAppliedBorders());
-            // Launch the computation of features on the window
-            WindowFeatureComputer wfc(pixels, img, actualWindow, wa);
-        }
-
+string ImageFeatureComputer::getCheckpointKey(const Mat& imgRead){
+	uint64_t hash = Utils::HASH_OFFSET_BASIS;
+	int dimensions[] = {imgRead.rows, imgRead.cols, imgRead.depth()};
+	hash = Utils::hashBytes(hash, dimensions, sizeof(dimensions));
+	// Rows may not be contiguous in memory
+	for (int i = 0; i < imgRead.rows; ++i) {
+		hash = Utils::hashBytes(hash, imgRead.ptr(i), imgRead.cols * imgRead.elemSize());
 	}
-
-	// Give the data structure
-    vector<vector<vector<double>>> output =
-            formatOutputResults(featuresList, numberOfWindows, featuresCount);
-
-	free(featuresList);
-	wa.release();
-	return output;
+	/* The rows of each band aren't part of it: the checkpoint counts the
+	 * rows saved, and the files don't depend on how they were split. The
+	 * memory budget can choose other bands when the run is resumed */
+	int parameters[] = {progArg.distance, progArg.windowSize,
+						progArg.directionType, progArg.symmetric,
+						progArg.borderType, progArg.quantitize,
+						progArg.quantitize ? progArg.quantitizationMax : 0,
+						progArg.textOutput, progArg.npyOutput,
+						progArg.textPrecision, progArg.textRowLayout};
+	hash = Utils::hashBytes(hash, parameters, sizeof(parameters));
+	return Utils::hashToString(hash);
 }
 
-
-
 /**
- * This method will extract the results from each window
- * @param imageFeatures: array (1 for each window) of array (1 for each
- * computed direction) of array of doubles (1 for each feature)
- * @return array (1 for each direction) of array (1 for each feature) of all
- * the values computed of that feature
- * Es. <Entropy , (0.1, 0.2, 3, 4 , ...)>
+ * This method will compute and save the features of every slice of a stack,
+ * each in its own output folder
+ * @param slices: the pages read from the image file
  */
-vector<vector<FeatureValues>> ImageFeatureComputer::getAllDirectionsAllFeatureValues(const vector<vector<WindowFeatures>>& imageFeatures){
-	vector<FeatureNames> supportedFeatures = Features::getAllSupportedFeatures();
-	// Direzioni[] aventi Features[] aventi double[]
-	vector<vector<FeatureValues>> output(1);
-
-	// for each computed direction
-	// 1 external vector cell for each of the 18 features
-	// each cell has all the values of that feature
-	vector<FeatureValues> featuresInDirection(supportedFeatures.size());
-
-	// for each computed window
-	for (int i = 0; i < imageFeatures.size() ; ++i) {
-		// for each supported feature
-		for (int k = 0; k < supportedFeatures.size(); ++k) {
-			FeatureNames actualFeature = supportedFeatures[k];
-			// Push the value found in the output list for that direction
-			featuresInDirection[actualFeature].push_back(imageFeatures.at(i).at(0).at(actualFeature));
-		}
+void ImageFeatureComputer::computeStack(const vector<Mat>& slices){
+	bool verbose = progArg.verbose;
+	int numberOfSlices = slices.size();
+	if(verbose)
+		cout << endl << "* Stack of " << numberOfSlices << " slices loaded * ";
+	if((progArg.bandRows > 0) || (progArg.pipelineDepth > 0) || (progArg.memoryBudget > 0)){
+		cout << endl << "WARNING! The slices of a stack are computed whole;"
+				" --band-rows, --pipeline, --resume and --mem-budget are ignored" << endl;
+		progArg.bandRows = 0;
+		progArg.pipelineDepth = 0;
+		progArg.resume = false;
+	}
 
+	// Every slice must be able to contain the windows
+	for (int i = 0; i < numberOfSlices; ++i) {
+		ImageData sliceData(slices[i].rows + 2 * getAppliedBorders(),
+				slices[i].cols + 2 * getAppliedBorders(), getAppliedBorders(),
+				slices[i].depth() == CV_16UC1 ? 65535 : 255);
+		checkOptionCompatibility(progArg, sliceData);
+	}
+	if(progress){
+		for (int i = 0; i < numberOfSlices; ++i) {
+			progress->addTotalWindows(countComputedWindows(slices[i].rows,
+					slices[i].cols, progArg.windowSize, progArg.borderType));
+		}
+	}
+	// The first slice warns about the quantization only once for all
+	Image firstSlice = readImageBand(slices[0], 0, slices[0].rows, 0);
+	if(progArg.quantitize)
+		progArg.quantitizationMax = min(progArg.quantitizationMax,
+				(int) firstSlice.getMaxGrayLevel());
+	ImageData firstSliceData(firstSlice, 0);
+	printInfo(firstSliceData, progArg.windowSize);
+	cout << endl << "- Slices: " << numberOfSlices;
+	if(verbose)
+		printExtimatedSizes(firstSliceData);
+
+	// Each slice has its own folder
+	Utils::createFolder(progArg.outputFolder);
+	int digits = to_string(numberOfSlices - 1).size();
+
+	// Few slices: all the workers compute the windows of each slice
+	if(numberOfSlices < workers.getNumberOfThreads()){
+		for (int i = 0; i < numberOfSlices; ++i) {
+			Image image = readImageBand(slices[i], 0, slices[i].rows, 0, true);
+			ImageData imgData(image, 0);
+			FeaturePlanes featurePlanes = computeCachedFeatures(image, imgData,
+					slices[i].rows, NULL);
+			string sliceFolder = getSliceFolder(i, digits);
+			saver.saveFeaturesToFiles(featurePlanes, 0, slices[i].rows, sliceFolder, -1);
+			if(progArg.createImages)
+				saver.saveAllFeatureImages(featurePlanes, sliceFolder, true);
+			if(verbose)
+				cout << "* Slice " << i << " saved *" << endl;
+		}
+		if(verbose)
+			cout << "* DONE * " << endl;
+		return;
 	}
-	output[0] = featuresInDirection;
 
-	return output;
+	/* Each worker takes the next slice and computes, saves it alone; its
+	 * work area is reused for all the slices it takes */
+	atomic<int> nextSlice(0);
+	mutex coutLock;
+	workers.run([&](int workerIndex){
+		WorkArea& wa = getWorkArea(workerIndex);
+		int slice;
+		while((slice = nextSlice++) < numberOfSlices){
+			Image image = readImageBand(slices[slice], 0, slices[slice].rows, 0);
+			ImageData imgData(image, 0);
+			FeaturePlanes featurePlanes = computeCachedFeatures(image, imgData,
+					slices[slice].rows, &wa);
+			string sliceFolder = getSliceFolder(slice, digits);
+			saver.saveFeaturesToFiles(featurePlanes, 0, slices[slice].rows,
+					sliceFolder, workerIndex);
+			if(progArg.createImages)
+				saver.saveAllFeatureImages(featurePlanes, sliceFolder, false);
+			if(verbose){
+				lock_guard<mutex> lock(coutLock);
+				cout << "* Slice " << slice << " saved *" << endl;
+			}
+		}
+	});
+	if(verbose)
+		cout << "* DONE * " << endl;
 }
 
-
 /**
- * This method will save on different folders, all the features values
- * computed for each directions of the image
- * @param imageFeatures
+ * This method will compute and save the features of every cubic window of
+ * the volume made by the slices of a stack
+ * @param slices: the pages read from the image file
  */
-void ImageFeatureComputer::saveFeaturesToFiles(const vector<vector<FeatureValues>>& imageFeatures){
-    int dirType = progArg.directionType;
+void ImageFeatureComputer::computeVolume(const vector<Mat>& slices){
+	bool verbose = progArg.verbose;
+	int numberOfSlices = slices.size();
+	if(verbose)
+		cout << endl << "* Volume of " << numberOfSlices << " slices loaded * ";
+	if((progArg.bandRows > 0) || (progArg.pipelineDepth > 0) || progArg.createImages){
+		cout << endl << "WARNING! Volumes are computed whole and saved as value"
+				" files; --band-rows, --pipeline and -s are ignored" << endl;
+		progArg.bandRows = 0;
+		progArg.pipelineDepth = 0;
+		progArg.createImages = false;
+	}
+	if(resultCache)
+		cout << endl << "WARNING! Volumes aren't kept in the cache; --cache-dir is ignored" << endl;
+	for (int i = 1; i < numberOfSlices; ++i) {
+		if((slices[i].rows != slices[0].rows) || (slices[i].cols != slices[0].cols)){
+			cerr << "ERROR! All the slices of a volume must have the same size" << endl;
+			exit(-1);
+		}
+	}
+
+	// The cubic windows must fit also in the depth of the volume
+	ImageData sliceData(slices[0].rows + 2 * getAppliedBorders(),
+			slices[0].cols + 2 * getAppliedBorders(), getAppliedBorders(),
+			slices[0].depth() == CV_16UC1 ? 65535 : 255);
+	checkOptionCompatibility(progArg, sliceData);
+	int paddedSlices = numberOfSlices + 2 * getAppliedBorders();
+	if(progArg.windowSize > paddedSlices){
+		cout << "WARNING! The window side specified with the option -w"
+				" exceeds the slices (" << paddedSlices << ") of the volume read!" << endl;
+		cout << "Window side is corrected to (" << paddedSlices << ")" << endl;
+		progArg.windowSize = paddedSlices;
+	}
+	if(progress){
+		int computedSlices = (progArg.borderType == 0) ?
+				max(0, numberOfSlices - progArg.windowSize) : numberOfSlices;
+		progress->addTotalWindows(computedSlices * countComputedWindows(
+				slices[0].rows, slices[0].cols, progArg.windowSize, progArg.borderType));
+	}
 
-    string outFolder = progArg.outputFolder;
-    Utils::createFolder(outFolder);
-    string foldersPath[] ={ "/Values0/", "/Values45/", "/Values90/", "/Values135/"};
+	PhaseTimer pixelsTimer(phaseTimes.get(), PIXELS_PHASE);
+	Image volume = ImageLoader::readVolume(slices, progArg.borderType,
+			getAppliedBorders(), progArg.quantitize, progArg.quantitizationMax,
+			&workers, &glcmFeatures.getQuantizationTable());
+	pixelsTimer.stop();
+	if(progArg.quantitize)
+		progArg.quantitizationMax = min(progArg.quantitizationMax,
+				(int) volume.getMaxGrayLevel());
+	ImageData volumeData(slices[0].rows + 2 * getAppliedBorders(),
+			slices[0].cols + 2 * getAppliedBorders(), getAppliedBorders(),
+			volume.getMaxGrayLevel(), paddedSlices);
+	printInfo(volumeData, progArg.windowSize);
+	cout << endl << "- Slices: " << numberOfSlices;
+	cout << endl << "- Direction: " << Direction(progArg.directionType).label;
+
+	VolumeFeatureComputer volumeComputer(progArg, workers, phaseTimes.get(),
+			progress.get());
+	FeaturePlanes featurePlanes = volumeComputer.computeAllFeatures(
+			volume.getPixels(), volumeData);
+	if(verbose)
+		cout << endl << "* Volume computed * " << endl;
 
-    // First create the the folder
-    string outputDirectionPath = outFolder + foldersPath[dirType -1];
+	// Each direction of the space has its own folder
+	Utils::createFolder(progArg.outputFolder);
+	string outputDirectionPath = progArg.outputFolder + "/Volume"
+			+ to_string(progArg.directionType) + "/";
 	Utils::createFolder(outputDirectionPath);
-    saveDirectedFeaturesToFiles(imageFeatures[0], outputDirectionPath);
+	if(progArg.textOutput)
+		saver.saveDirectedFeaturesToFiles(featurePlanes, 0, outputDirectionPath, false, -1);
+	if(progArg.npyOutput){
+		saver.saveFeaturesMetadata(slices[0].cols, slices[0].rows, numberOfSlices,
+				outputDirectionPath);
+		vector<string> fileDestinations = Features::getAllFeaturesFileNames();
+		for(int i = 0; i < fileDestinations.size(); i++) {
+			PhaseTimer npyTimer(phaseTimes.get(), NPY_WRITE_PHASE);
+			bool saved = NpyWriter::saveVolume(outputDirectionPath + fileDestinations[i],
+					featurePlanes.getPlane((FeatureNames) i, 0), numberOfSlices,
+					slices[0].rows, slices[0].cols);
+			npyTimer.stop();
+			if(phaseTimes)
+				phaseTimes->addBytes(Utils::getFileSize(outputDirectionPath
+						+ fileDestinations[i] + ".npy"));
+			if(!saved)
+				cerr << "Couldn't save the feature values to file" << endl;
+		}
+	}
+	if(verbose)
+		cout << "* DONE * " << endl;
 }
 
 /**
- * This method will save into the given folder, alle the values of all
- * the features computed for 1  directions
- * @param imageDirectedFeatures: all the values computed for each feature
- * in 1 direction of the image
- * @param outputFolderPath
+ * This method will compute and save the features of the image for every
+ * window size, each in its own output folder
+ * @param imgRead: the image read from the file
  */
-void ImageFeatureComputer::saveDirectedFeaturesToFiles(const vector<FeatureValues>& imageDirectedFeatures,
-		const string& outputFolderPath){
-	vector<string> fileDestinations = Features::getAllFeaturesFileNames();
+void ImageFeatureComputer::computeSweep(const Mat& imgRead){
+	bool verbose = progArg.verbose;
+	if((progArg.bandRows > 0) || (progArg.pipelineDepth > 0)){
+		cout << endl << "WARNING! Many window sizes are computed on the whole"
+				" image; --band-rows and --pipeline are ignored" << endl;
+		progArg.bandRows = 0;
+		progArg.pipelineDepth = 0;
+	}
+	if(resultCache)
+		cout << endl << "WARNING! Many window sizes aren't kept in the cache;"
+				" --cache-dir is ignored" << endl;
+
+	// The largest window decides the borders shared by all the sizes
+	vector<short int> windowSizes = progArg.windowSizes;
+	ImageData wholeImgData(imgRead.rows + 2 * getAppliedBorders(),
+			imgRead.cols + 2 * getAppliedBorders(), getAppliedBorders(),
+			imgRead.depth() == CV_16UC1 ? 65535 : 255);
+	checkOptionCompatibility(progArg, wholeImgData);
+	while(windowSizes.back() > progArg.windowSize)
+		windowSizes.pop_back();
+	if(windowSizes.empty() || (windowSizes.back() < progArg.windowSize))
+		windowSizes.push_back(progArg.windowSize);
+	if(progress){
+		for (size_t k = 0; k < windowSizes.size(); ++k) {
+			progress->addTotalWindows(countComputedWindows(imgRead.rows,
+					imgRead.cols, windowSizes[k], progArg.borderType));
+		}
+	}
+
+	// Windows of all the sizes share the borders of the largest one
+	PhaseTimer pixelsTimer(phaseTimes.get(), PIXELS_PHASE);
+	Image image = ImageLoader::readImageBand(imgRead, 0, imgRead.rows, 0,
+			progArg.borderType, getAppliedBorders(), progArg.quantitize,
+			progArg.quantitizationMax, &workers, &glcmFeatures.getQuantizationTable());
+	pixelsTimer.stop();
+	ImageData imgData(image, getAppliedBorders());
+	printInfo(imgData, progArg.windowSize);
+	cout << endl << "- Window sides:";
+	for (size_t k = 0; k < windowSizes.size(); ++k) {
+		cout << " " << windowSizes[k];
+	}
+	if(verbose)
+		cout << endl << "* COMPUTING features * " << endl;
 
-	// for each feature
-	for(int i = 0; i < imageDirectedFeatures.size(); i++) {
-		string newFileName(outputFolderPath); // create the right file path
-		pair<FeatureNames , FeatureValues> featurePair = make_pair((FeatureNames) i, imageDirectedFeatures[i]);
-		saveFeatureToFile(featurePair, newFileName.append(fileDestinations[i]));
+	WindowSweepComputer sweepComputer(progArg, windowSizes, workers,
+			phaseTimes.get(), progress.get());
+	vector<FeaturePlanes> featurePlanes = sweepComputer.computeAllFeatures(
+			image.getPixels(), imgData);
+	if(verbose)
+		cout << "* Features computed * " << endl;
+
+	// Each size has its own folder, described with its own side
+	Utils::createFolder(progArg.outputFolder);
+	short int largestWindow = progArg.windowSize;
+	for (size_t k = 0; k < windowSizes.size(); ++k) {
+		progArg.windowSize = windowSizes[k];
+		string sizeFolder = progArg.outputFolder + "/W" + to_string(windowSizes[k]);
+		if(verbose)
+			cout << "* Saving features of windows of side " << windowSizes[k] << " *" << endl;
+		saver.saveFeaturesToFiles(featurePlanes[k], 0, imgRead.rows, sizeFolder, -1);
+		if(progArg.createImages)
+			saver.saveAllFeatureImages(featurePlanes[k], sizeFolder, true);
 	}
+	progArg.windowSize = largestWindow;
+	if(verbose)
+		cout << "* DONE * " << endl;
 }
 
 /**
- * This method will save into the given folder, all the values for 1 feature
- * computed for 1 directions
- * @param imageFeatures all the feature values of 1 feature
- * @param path
+ * This method will compute and save the features of every image of the batch,
+ * each in its own output folder. A thread decodes the next images and
+ * another saves the previous ones while the workers compute the current one
  */
-void ImageFeatureComputer::saveFeatureToFile(const pair<FeatureNames, vector<double>>& featurePair, string filePath){
-	// Open the file
-	ofstream file;
-	file.open(filePath.append(".txt"));
-	if(file.is_open()){
-		for(int i = 0; i < featurePair.second.size(); i++){
-			file << featurePair.second[i] << ",";
+void ImageFeatureComputer::computeBatch(){
+	bool verbose = progArg.verbose;
+	vector<string> imagePaths = Utils::listBatchImages(progArg.batchPath);
+	if(imagePaths.empty()){
+		cerr << "ERROR! No images found in the batch: " << progArg.batchPath << endl;
+		exit(-1);
+	}
+	if(progArg.bandRows > 0){
+		cout << endl << "WARNING! The images of a batch are computed whole;"
+				" --band-rows is ignored" << endl;
+		progArg.bandRows = 0;
+	}
+	// Each image starts from the options given by the user
+	ProgramArguments batchArgs = progArg;
+	int queueDepth = (progArg.pipelineDepth > 0) ? progArg.pipelineDepth : 2;
+
+	cout << endl << "- Batch: " << progArg.batchPath;
+	cout << endl << "- Output folder: " << progArg.outputFolder;
+	cout << endl << "- Images: " << imagePaths.size();
+	cout << endl << "- Threads: " << workers.getNumberOfThreads();
+	cout << endl << "- Images waiting at each stage: " << queueDepth << endl;
+	Utils::createFolder(progArg.outputFolder);
+
+	/* Load -> compute -> save: each queue holds at most queueDepth images,
+	 * so the loader stops when the compute falls behind and the compute
+	 * stops when the saver falls behind */
+	BoundedQueue<LoadedImage> loadQueue(queueDepth);
+	BoundedQueue<ComputedImage> saveQueue(queueDepth);
+	atomic<int> failedImages(0);
+	atomic<int> unsavedImages(0);
+	/* Set when a stage fails, so that no more images are decoded nor
+	 * computed */
+	atomic<bool> stopLoading(false);
+	// What stopped the loader or the saver, given back by this thread
+	exception_ptr loaderError;
+	exception_ptr saverError;
+
+	thread loader([&](){
+		try{
+			for (size_t i = 0; (i < imagePaths.size()) && !stopLoading; ++i) {
+				LoadedImage loaded;
+				loaded.imagePath = imagePaths[i];
+				PhaseTimer loadTimer(phaseTimes.get(), LOAD_PHASE);
+				bool read = ImageLoader::tryReadImage(imagePaths[i], loaded.image);
+				loadTimer.stop();
+				if(!read){
+					cerr << "Could not open or find the image: " << imagePaths[i] << endl;
+					failedImages++;
+					continue;
+				}
+				/* The total grows as the images are decoded; the window side is
+				 * corrected for images smaller than it, as they are computed */
+				if(progress){
+					int smallestSide = min(loaded.image.rows, loaded.image.cols);
+					progress->addTotalWindows(countComputedWindows(loaded.image.rows,
+							loaded.image.cols, min((int) batchArgs.windowSize, smallestSide),
+							batchArgs.borderType));
+				}
+				loadQueue.push(loaded);
+			}
+		}
+		catch (...) {
+			loaderError = current_exception();
+			stopLoading = true;
+		}
+		loadQueue.close();
+	});
+
+	thread resultsSaver([&](){
+		// Its own writers, without workers: it saves alone
+		FeatureSaver imageSaver(batchArgs, NULL);
+		imageSaver.setPhaseTimes(phaseTimes.get());
+		ComputedImage computed;
+		try{
+			while(saveQueue.pop(computed)){
+				// The options of the image, with its own output folder
+				imageSaver.setProgramArguments(computed.progArg);
+				if(!imageSaver.saveFeaturesToFiles(*computed.featurePlanes, 0,
+						computed.rows, computed.progArg.outputFolder, 0)){
+					cerr << "Could not save the features of the image: "
+							<< computed.progArg.imagePath << endl;
+					unsavedImages++;
+					continue;
+				}
+				if(computed.progArg.createImages)
+					imageSaver.saveAllFeatureImages(*computed.featurePlanes,
+							computed.progArg.outputFolder, false);
+				if(verbose)
+					cout << "* " << computed.progArg.imagePath << " saved *" << endl;
+			}
+		}
+		catch (...) {
+			saverError = current_exception();
+			stopLoading = true;
+			// The compute never waits for room in the queue
+			while(saveQueue.pop(computed)){}
+		}
+	});
+
+	// Wait for the saver to empty its queue; the loader may wait for room
+	auto stopStages = [&](){
+		LoadedImage discarded;
+		while(loadQueue.pop(discarded)){}
+		saveQueue.close();
+		loader.join();
+		resultsSaver.join();
+		progArg = batchArgs;
+	};
+
+	int computedImages = 0;
+	LoadedImage loaded;
+	try{
+		while(!stopLoading && loadQueue.pop(loaded)){
+			progArg = batchArgs;
+			progArg.imagePath = loaded.imagePath;
+			progArg.outputFolder = batchArgs.outputFolder + "/"
+					+ Utils::removeExtension(Utils::basename(loaded.imagePath));
+			const Mat& imgRead = loaded.image;
+
+			ImageData wholeImgData(imgRead.rows + 2 * getAppliedBorders(),
+					imgRead.cols + 2 * getAppliedBorders(), getAppliedBorders(),
+					imgRead.depth() == CV_16UC1 ? 65535 : 255);
+			checkOptionCompatibility(progArg, wholeImgData);
+			Image image = readImageBand(imgRead, 0, imgRead.rows, 0);
+			ImageData imgData(image, 0);
+			if(verbose){
+				printInfo(imgData, progArg.windowSize);
+				cout << endl << "* COMPUTING features * " << endl;
+			}
+
+			// The saver takes the values while the next image is computed
+			ComputedImage computed = {progArg, shared_ptr<const FeaturePlanes>(
+					new FeaturePlanes(computeCachedFeatures(image, imgData,
+							imgRead.rows, NULL))), imgRead.rows};
+			saveQueue.push(computed);
+			computedImages++;
 		}
-		file.close();
-	} else{
-		cerr << "Couldn't save the feature values to file" << endl;
+	}
+	catch (...) {
+		// The images already computed are still saved, and the threads stopped
+		stopLoading = true;
+		stopStages();
+		throw;
 	}
 
+	stopStages();
+	if(loaderError)
+		rethrow_exception(loaderError);
+	if(saverError)
+		rethrow_exception(saverError);
+
+	cout << endl << "- Images computed: " << computedImages;
+	if(failedImages > 0)
+		cout << endl << "- Images that could not be read: " << failedImages;
+	if(unsavedImages > 0)
+		cout << endl << "- Images that could not be saved: " << unsavedImages;
+	if(verbose)
+		cout << endl << "* DONE * " << endl;
 }
 
-// IMAGING
 /**
- * This method will produce and save all the images associated with each feature
- * for each direction
- * @param rowNumber: how many rows each image will have
- * @param colNumber: how many columns each image will have
- * @param imageFeatures
+ * Utility method
+ * @param slice: index of the slice in the stack
+ * @param digits: how many digits the index is padded to
+ * @return folder of the results of the slice, inside the output folder
  */
-void ImageFeatureComputer::saveAllFeatureImages(const int rowNumber,
-		const int colNumber, const vector<vector<FeatureValues>>& imageFeatures){
-    int dirType = progArg.directionType;
-
-    string outFolder = progArg.outputFolder;
-    string foldersPath[] ={ "/Images0/", "/Images45/", "/Images90/", "/Images135/"};
-    string outputDirectionPath = outFolder + foldersPath[dirType -1];
-	Utils::createFolder(outputDirectionPath);
-    // For each direction computed
-    saveAllFeatureDirectedImages(rowNumber, colNumber, imageFeatures[0],
-                outputDirectionPath);
+string ImageFeatureComputer::getSliceFolder(const int slice, const int digits){
+	string index = to_string(slice);
+	if(index.size() < digits)
+		index.insert(0, digits - index.size(), '0');
+	string sliceFolder = progArg.outputFolder + "/Slice" + index;
+	Utils::createFolder(sliceFolder);
+	return sliceFolder;
 }
 
 /**
- * This method will produce and save all the images associated with
- * each feature in 1 direction
- * @param rowNumber: how many rows each image will have
- * @param colNumber: how many columns each image will have
- * @param imageFeatures: all the values computed for each feature of the image
- * @param outputFolderPath: where to save the image
+ * This method will compute all the features for every window for the
+ * number of directions provided
+ * @param pixels: pixels intensities of the image provided
+ * @param img: image metadata
+ * @param windowRows: how many rows of windows the image provided has
+ * @return the planes (1 for each feature, for each computed direction) with
+ * the values of all the windows
  */
-void ImageFeatureComputer::saveAllFeatureDirectedImages(const int rowNumber,
-		const int colNumber, const vector<FeatureValues>& imageDirectedFeatures, const string& outputFolderPath){
-
-	vector<string> fileDestinations = Features::getAllFeaturesFileNames();
-
-	// For each feature
-	for(int i = 0; i < imageDirectedFeatures.size(); i++) {
-		string newFileName(outputFolderPath);
-		saveFeatureImage(rowNumber, colNumber, imageDirectedFeatures[i], newFileName.append(fileDestinations[i]));
-	}
+FeaturePlanes ImageFeatureComputer::computeAllFeatures(const unsigned int * pixels,
+        const ImageData& img, const int windowRows){
+    // Pre-Allocate the planes that will contain features
+    FeaturePlanes featurePlanes = allocateFeaturePlanes(img, windowRows);
+    glcmFeatures.computeAllFeatures(pixels, img, progArg.getGLCMParameters(),
+            featurePlanes);
+	return featurePlanes;
 }
 
 /**
- * This method will produce and save on the filesystem the image associated with
- * a feature in 1 direction
- * @param rowNumber: how many rows the image will have
- * @param colNumber: how many columns the image will have
- * @param featureValues: values that will be the intensities values of the
- * image
- * @param outputFilePath: where to save the image
+ * This method will compute all the features for every window of an image,
+ * unless the cache already has them
+ * @param image: the image read, with borders
+ * @param img: image metadata
+ * @param windowRows: how many rows of windows the image has
+ * @param wa: work area of the caller when it computes the image alone; NULL
+ * for spreading the windows among all the workers
+ * @return the planes with the values of all the windows
  */
-void ImageFeatureComputer::saveFeatureImage(const int rowNumber,
-		const int colNumber, const FeatureValues& featureValues,const string& filePath){
-	typedef vector<WindowFeatures>::const_iterator VI;
-
-	int imageSize = rowNumber * colNumber;
+FeaturePlanes ImageFeatureComputer::computeCachedFeatures(const Image& image,
+        const ImageData& img, const int windowRows, WorkArea* wa){
+    // The windows read the pixels owned by the image
+    const unsigned int* pixels = image.getPixels();
+    if(!resultCache){
+        if(wa == NULL)
+            return computeAllFeatures(pixels, img, windowRows);
+        return computeImageFeatures(pixels, img, *wa);
+    }
 
-	// Check if dimensions are compatible
-	if(featureValues.size() != imageSize){
-		cerr << "Fatal Error! Couldn't create the image; size unexpected " << featureValues.size();
-		exit(-2);
-	}
+    // Same pixels and parameters give the same values
+    PhaseTimer cacheTimer(phaseTimes.get(), CACHE_PHASE);
+    string key = ResultCache::computeKey(image.getView(), img, progArg);
+    FeaturePlanes cachedPlanes = allocateFeaturePlanes(img, windowRows);
+    bool cached = resultCache->load(key, cachedPlanes);
+    cacheTimer.stop();
+    if(cached){
+        if(progArg.verbose)
+            cout << "* Features read from the cache *" << endl;
+        // Its windows are done as well
+        if(progress)
+            progress->addWindows(countComputedWindows(img.getRows() - 2 * img.getBorderSize(),
+                    img.getColumns() - 2 * img.getBorderSize(), progArg.windowSize,
+                    progArg.borderType));
+        return cachedPlanes;
+    }
 
-	// Create a 2d matrix of double grayPairs
-	Mat_<double> imageFeature = ImageLoader::createDoubleMat(rowNumber, colNumber, featureValues);
-    ImageLoader::saveImage(imageFeature, filePath);
+    FeaturePlanes featurePlanes = (wa == NULL) ?
+            computeAllFeatures(pixels, img, windowRows)
+            : computeImageFeatures(pixels, img, *wa);
+    PhaseTimer storeTimer(phaseTimes.get(), CACHE_PHASE);
+    resultCache->store(key, featurePlanes);
+    storeTimer.stop();
+    return featurePlanes;
 }
 
+/**
+ * This method will compute, on the calling thread only, all the features
+ * for every window of an image
+ * @param pixels: pixels intensities of the image provided
+ * @param img: image metadata
+ * @param wa: work area of the caller, reused for every image it computes
+ * @return the planes with the values of all the windows
+ */
+FeaturePlanes ImageFeatureComputer::computeImageFeatures(const unsigned int * pixels,
+        const ImageData& img, WorkArea& wa){
+    int windowRows = img.getRows() - 2 * img.getBorderSize();
+    FeaturePlanes featurePlanes = allocateFeaturePlanes(img, windowRows);
+    wa.output = &featurePlanes;
+    glcmFeatures.computeImageFeatures(pixels, img, progArg.getGLCMParameters(), wa);
+    wa.output = NULL;
+    return featurePlanes;
+}
 
+/**
+ * Allocate the planes of the results of an image
+ * @param img: image metadata
+ * @param windowRows: rows of windows of the image
+ * @return zeroed planes, 1 for each feature, for each computed direction
+ */
+FeaturePlanes ImageFeatureComputer::allocateFeaturePlanes(const ImageData& img,
+        const int windowRows){
+    // How many directions need to be allocated for each window
+    short int numberOfDirs = 1;
+    int originalImageCols = img.getColumns() - 2 * img.getBorderSize();
+    return FeaturePlanes(windowRows, originalImageCols, numberOfDirs);
+}
 
-
-
+/**
+ * Utility method
+ * @param workerIndex: worker that will use the work area
+ * @return the work area of the worker, allocated again only when the windows
+ * need a different number of pairs
+ */
+WorkArea& ImageFeatureComputer::getWorkArea(const int workerIndex){
+	// The window side may have been corrected for the image
+	return glcmFeatures.getWorkArea(workerIndex, progArg.getGLCMParameters());
+}
@@ -3,13 +3,64 @@
 
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/core.hpp>
+#include <memory>
 #include "ImageLoader.h"
 #include "ProgramArguments.h"
+#include "GLCMFeatures.h"
 #include "WindowFeatureComputer.h"
+#include "VolumeFeatureComputer.h"
+#include "WindowSweepComputer.h"
+#include "ResultCache.h"
+#include "Checkpoint.h"
+#include "ThreadPool.h"
+#include "TileScheduler.h"
+#include "FeatureSaver.h"
+#include "BoundedQueue.h"
 #include "Utils.h"
+#include "PhaseTimes.h"
+#include "ProgressReporter.h"
 
 using namespace cv;
 
+/**
+ * Values of a band of rows of windows, handed to the threads that save
+ * them in pipelined mode
+ */
+struct ComputedBand {
+	shared_ptr<const FeaturePlanes> featurePlanes;
+	/**
+	 * First row of windows of the image that the planes have
+	 */
+	int firstRow;
+};
+
+/**
+ * Image of a batch decoded by the loader thread, waiting to be computed
+ */
+struct LoadedImage {
+	string imagePath;
+	/**
+	 * Pixels in their compact (8/16 bit) representation
+	 */
+	Mat image;
+};
+
+/**
+ * Values of an image of a batch, handed to the thread that saves them
+ * while the next image is computed
+ */
+struct ComputedImage {
+	/**
+	 * Options used for the image, with its own output folder
+	 */
+	ProgramArguments progArg;
+	shared_ptr<const FeaturePlanes> featurePlanes;
+	/**
+	 * Rows of windows of the image
+	 */
+	int rows;
+};
+
 /**
  * This class has 3 main tasks:
  * - Read and transform the image according to the options provided
@@ -30,91 +81,180 @@ public:
 	 * results and save them as need on the file system
 	 */
 	void compute();
+	/**
+	 * Print the time of each phase of the computation, the windows computed
+	 * per second, the bytes written (--report) and the hardware events of
+	 * the windows (--perf), and save them in the report
+	 * @param seconds: duration of the whole run
+	 */
+	void reportMeasures(double seconds);
     /**
      * This method will compute all the features for every window for the
      * number of directions provided
      * @param pixels: pixels intensities of the image provided
      * @param img: image metadata
-     * @return array (1 for each window) of array (1 for each computed direction)
-     * of array of doubles (1 for each feature)
+     * @param windowRows: how many rows of windows the image provided has;
+     * when the image is computed by bands, the rows of the band
+     * @return the planes (1 for each feature, for each computed direction)
+     * with the values of all the windows
      */
-	vector<vector<WindowFeatures>> computeAllFeatures(unsigned int * pixels,
-	        const ImageData& img);
-
-    // EXTRAPOLATING RESULTS
-    /**
-     * This method will extract the results from each window
-     * @param imageFeatures: array (1 for each window) of array (1 for each
-     * computed direction) of array of doubles (1 for each feature)
-     * @return array (1 for each direction) of array (1 for each feature) of all
-     * the values computed of that feature
-     * Es. <Entropy , (0.1, 0.2, 3, 4 , ...)>
-     */
-	vector<vector<vector<double>>> getAllDirectionsAllFeatureValues(const vector<vector<WindowFeatures>>& imageFeatures);
-
-	// SAVING RESULTS ON FILES
+	FeaturePlanes computeAllFeatures(const unsigned int * pixels,
+	        const ImageData& img, int windowRows);
 	/**
-	 * This method will save on different folders, all the features values
-	 * computed for each directions of the image
-	 * @param imageFeatures
+	 * This method will compute, on the calling thread only, all the
+	 * features for every window of an image
+	 * @param pixels: pixels intensities of the image provided
+	 * @param img: image metadata
+	 * @param wa: work area of the caller, reused for every image it computes
+	 * @return the planes with the values of all the windows
 	 */
-	void saveFeaturesToFiles(const vector<vector<vector<double>>>& imageFeatures);
-
-    // IMAGING
-    /**
-     * This method will produce and save all the images associated with each feature
-     * for each direction
-     * @param rowNumber: how many rows each image will have
-     * @param colNumber: how many columns each image will have
-     * @param imageFeatures
-     */
-    void saveAllFeatureImages(int rowNumber,  int colNumber,
-            const vector<vector<FeatureValues>>& imageFeatures);
+	FeaturePlanes computeImageFeatures(const unsigned int * pixels,
+	        const ImageData& img, WorkArea& wa);
 
 
 private:
 	ProgramArguments progArg;
+	/**
+	 * Computation of the windows, with the workers and their memory;
+	 * created once and reused for every band, slice and image computed
+	 */
+	GLCMFeatures glcmFeatures;
+	/**
+	 * Workers of glcmFeatures, that also save the files
+	 */
+	ThreadPool& workers;
+	/**
+	 * Saves the results of the images; its text writers are reused for
+	 * every file
+	 */
+	FeatureSaver saver;
+	/**
+	 * Features computed by the previous runs; NULL if not used
+	 */
+	unique_ptr<ResultCache> resultCache;
+	/**
+	 * Time of each phase of the computation; only when a report is asked.
+	 * The saver of a batch adds its files to it
+	 */
+	unique_ptr<PhaseTimes> phaseTimes;
+	/**
+	 * Hardware events of the windows; only when counted
+	 */
+	unique_ptr<PerfTotals> perfTotals;
+	/**
+	 * Progress of the windows while computing; only when reported
+	 */
+	unique_ptr<ProgressReporter> progress;
 
-	// SUPPORT FILESAVE methods
 	/**
-	 * This method will save into the given folder, alle the values of all
-	 * the features computed for 1  directions
-	 * @param imageDirectedFeatures: all the values computed for each feature
-	 * in 1 direction of the image
-	 * @param outputFolderPath
+	 * This method will read the input (image, stack, volume or batch) and
+	 * compute and save the features of all its windows
 	 */
-	void saveDirectedFeaturesToFiles(const vector<vector<double>>& imageDirectedFeatures,
-			const string& outputFolderPath);
+	void computeInput();
+
 	/**
-	 * This method will save into the given folder, all the values for 1 feature
-     * computed for 1 directions
-	 * @param imageFeatures all the feature values of 1 feature
-	 * @param path
+	 * This method will compute and save the features of every image of the
+	 * batch, each in its own output folder. The next images are decoded,
+	 * and the previous ones saved, while the workers compute the current one
 	 */
-	void saveFeatureToFile(const pair<FeatureNames, vector<double>>& imageFeatures, const string path);
+	void computeBatch();
 
-	// SUPPORT IMAGING methods
-	/**
-	 * This method will produce and save all the images associated with
-	 * each feature in 1 direction
-	 * @param rowNumber: how many rows each image will have
-	 * @param colNumber: how many columns each image will have
-	 * @param imageFeatures: all the values computed for each feature of the image
-	 * @param outputFolderPath: where to save the image
-	 */
-	void saveAllFeatureDirectedImages(int rowNumber,  int colNumber,
-			const vector<vector<double>> &imageFeatures, const string& outputFolderPath);
-	/**
-	 * This method will produce and save on the filesystem the image associated with
-	 * a feature in 1 direction
-	 * @param rowNumber: how many rows the image will have
-	 * @param colNumber: how many columns the image will have
-	 * @param featureValues: values that will be the intensities values of the
-	 * image
-	 * @param outputFilePath: where to save the image
-	 */
-	void saveFeatureImage(int rowNumber,  int colNumber,
-			const vector<double>& featureValues, const string& outputFilePath);
+	/**
+	 * This method will compute and save the features of every slice of a
+	 * stack, each in its own output folder
+	 * @param slices: the pages read from the image file
+	 */
+	void computeStack(const vector<Mat>& slices);
+	/**
+	 * This method will compute and save the features of every cubic window
+	 * of the volume made by the slices of a stack
+	 * @param slices: the pages read from the image file
+	 */
+	void computeVolume(const vector<Mat>& slices);
+	/**
+	 * This method will compute and save the features of the image for
+	 * every window size (-w list), each in its own output folder
+	 * @param imgRead: the image read from the file
+	 */
+	void computeSweep(const Mat& imgRead);
+	/**
+	 * This method will compute all the features for every window of an
+	 * image, unless the cache already has them
+	 * @param image: the image read, with borders
+	 * @param img: image metadata
+	 * @param windowRows: how many rows of windows the image has
+	 * @param wa: work area of the caller when it computes the image alone;
+	 * NULL for spreading the windows among all the workers
+	 * @return the planes with the values of all the windows
+	 */
+	FeaturePlanes computeCachedFeatures(const Image& image, const ImageData& img,
+			int windowRows, WorkArea* wa);
+	/**
+	 * Utility method
+	 * @param rows: rows of the image, without borders
+	 * @param columns: columns of the image, without borders
+	 * @param windowSide: side of each window
+	 * @param borderType: border applied to the image
+	 * @return how many windows of the image are computed; without borders,
+	 * only the ones whose pixels are all in the image
+	 */
+	static uint64_t countComputedWindows(int rows, int columns, int windowSide,
+			short int borderType);
+	/**
+	 * Read the pixels needed by a band of rows of windows, with the borders
+	 * and the quantization of the options
+	 * @param imgRead: the image read from the file
+	 * @param firstRow: first row of windows of the band
+	 * @param lastRow: last row (excluded) of windows of the band
+	 * @param windowSide: side of each window; 0 for all the rows of the image
+	 * @param parallel: the workers copy the rows of large bands; only when
+	 * they aren't computing
+	 * @return the band, with borders
+	 */
+	Image readImageBand(const Mat& imgRead, int firstRow, int lastRow,
+			int windowSide, bool parallel = false);
+	/**
+	 * Choose the rows of each band and the bands waiting to be saved so that
+	 * the computation of the image fits in the memory budget (--mem-budget),
+	 * and print the plan; exit if not even bands of 1 row fit
+	 * @param imgRead: the image read from the file
+	 */
+	void planMemory(const Mat& imgRead);
+	/**
+	 * Stop the computation of an image whose files couldn't be saved; the
+	 * checkpoint stays at the last band saved whole
+	 * @param firstRow: first row of windows of the band not saved
+	 * @param lastRow: last row (excluded) of windows of the band not saved
+	 */
+	void exitUnsavedBand(int firstRow, int lastRow);
+	/**
+	 * Allocate the planes of the results of an image
+	 * @param img: image metadata
+	 * @param windowRows: rows of windows of the image
+	 * @return zeroed planes, 1 for each feature, for each computed direction
+	 */
+	FeaturePlanes allocateFeaturePlanes(const ImageData& img, int windowRows);
+	/**
+	 * Utility method
+	 * @param workerIndex: worker that will use the work area
+	 * @return the work area of the worker, allocated again only when the
+	 * windows need a different number of pairs
+	 */
+	WorkArea& getWorkArea(int workerIndex);
+	/**
+	 * Utility method
+	 * @param imgRead: the image read from the file
+	 * @return identifier of the image and of every parameter that changes
+	 * the files of the results, for its checkpoints
+	 */
+	string getCheckpointKey(const Mat& imgRead);
+	/**
+	 * Utility method
+	 * @param slice: index of the slice in the stack
+	 * @param digits: how many digits the index is padded to
+	 * @return folder of the results of the slice, inside the output folder
+	 */
+	string getSliceFolder(int slice, int digits);
 
 	/**
 	 * Utility method
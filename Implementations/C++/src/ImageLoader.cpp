@@ -1,9 +1,19 @@
 #include "ImageLoader.h"
-
-#define IMG16MAXGRAYLEVEL 65535
-#define IMG8MAXGRAYLEVEL 255
+#include "Utils.h"
+#include "GLCMFeatures.h"
 
 Mat ImageLoader::readImage(string fileName){
+    Mat inputImage;
+    if(!tryReadImage(fileName, inputImage))
+    {
+        cout <<  "Could not open or find the image" << std::endl ;
+        exit(-1);
+    }
+
+    return inputImage;
+}
+
+bool ImageLoader::tryReadImage(const string& fileName, Mat& image){
     Mat inputImage;
     try{
         inputImage = imread(fileName, CV_LOAD_IMAGE_ANYDEPTH);
@@ -13,51 +23,57 @@ Mat ImageLoader::readImage(string fileName){
         cerr << "Exception occurred: " << err_msg << endl;
     }
     if(! inputImage.data )  // Check for invalid input
-    {
-        cout <<  "Could not open or find the image" << std::endl ;
-        exit(-1);
-    }
+        return false;
+
+    image = toGrayLevels(inputImage);
+    return true;
+}
+
+Mat ImageLoader::toGrayLevels(Mat& inputImage){
     // If not a grayscale 256/6536 depth, it must be a color image
     if((inputImage.depth() != CV_8UC1) && (inputImage.depth() != CV_16UC1)){
         // reduce color channel from 3 to 1
         cvtColor(inputImage, inputImage, CV_RGB2GRAY);
         inputImage.convertTo(inputImage, CV_8UC1);
     }
-
     return inputImage;
 }
 
+vector<Mat> ImageLoader::readImageStack(string fileName){
+    vector<Mat> pages;
+    // Only TIFF files can contain more than 1 page
+    string extension = fileName.substr(Utils::removeExtension(fileName).size());
+    transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if((extension != ".tif") && (extension != ".tiff")){
+        pages.push_back(readImage(fileName));
+        return pages;
+    }
 
-
-Mat ImageLoader::createDoubleMat(const int rows, const int cols,
-                                 const vector<double>& input){
-    Mat_<double> output = Mat(rows, cols, CV_64F);
-    // Copy the values into the image
-    memcpy(output.data, input.data(), rows * cols * sizeof(double));
-    return output;
-}
-
-// TODO use generics
-// Utility method to iterate on the pysical pixels expressed as uchars
-inline void readUchars(vector<uint>& output, Mat& img){
-    typedef MatConstIterator_<uchar> MI;
-    int address = 0;
-    for(MI element = img.begin<uchar>() ; element != img.end<uchar>() ; element++)
+    try{
+        imreadmulti(fileName, pages, CV_LOAD_IMAGE_ANYDEPTH);
+    }
+    catch (cv::Exception& e) {
+        const char *err_msg = e.what();
+        cerr << "Exception occurred: " << err_msg << endl;
+    }
+    if(pages.empty())  // Check for invalid input
     {
-        output[address] = *element;
-        address++;
+        cout <<  "Could not open or find the image" << std::endl ;
+        exit(-1);
+    }
+    for (size_t i = 0; i < pages.size(); ++i) {
+        pages[i] = toGrayLevels(pages[i]);
     }
+    return pages;
 }
 
-// Utility method to iterate on the pysical pixels expressed as uint
-inline void readUint(vector<uint>& output, Mat& img){
-    typedef MatConstIterator_<ushort> MI;
-    int address = 0;
-    for(MI element = img.begin<ushort>() ; element != img.end<ushort>() ; element++)
-    {
-        output[address] = *element;
-        address++;
-    }
+
+
+Mat ImageLoader::createDoubleMat(const int rows, const int cols,
+                                 const double* input){
+    // The image header points to the values, nothing is copied
+    Mat_<double> output = Mat(rows, cols, CV_64F, const_cast<double*>(input));
+    return output;
 }
 
 Image ImageLoader::readImage(const string fileName, short int borderType,
@@ -65,41 +81,75 @@ Image ImageLoader::readImage(const string fileName, short int borderType,
     // Open image from file system
     Mat imgRead = readImage(fileName);
 
-    // Create borders to the image
-    addBorderToImage(imgRead, borderType, borderSize);
+    // The whole image is a single band
+    return readImageBand(imgRead, 0, imgRead.rows, 0, borderType, borderSize,
+            quantitize, quantizationMax);
+}
 
-    if((quantitize) && (imgRead.depth() == CV_16UC1) && (quantizationMax > IMG16MAXGRAYLEVEL)){
-        cout << "Warning! Provided a quantization level > maximum gray level of the image";
-        quantizationMax = IMG16MAXGRAYLEVEL;
+Image ImageLoader::readVolume(const vector<Mat>& slices, short int borderType,
+        int borderSize, bool quantitize, int quantizationMax, ThreadPool* workers,
+        QuantizationTable* quantizationTable){
+    if(borderType == 0)
+        borderSize = 0;
+    int numberOfSlices = slices.size();
+    int paddedSlices = numberOfSlices + 2 * borderSize;
+    vector<uint> voxels;
+    size_t sliceSize = 0;
+    int paddedRows = 0;
+    int paddedColumns = 0;
+    int maxGrayLevel = 0;
+    for (int i = 0; i < numberOfSlices; ++i) {
+        // Borders of the rows and columns, and quantization
+        Image slice = readImageBand(slices[i], 0, slices[i].rows, 0,
+                borderType, borderSize, quantitize, quantizationMax, workers,
+                quantizationTable);
+        if(i == 0){
+            paddedRows = slice.getRows();
+            paddedColumns = slice.getColumns();
+            maxGrayLevel = slice.getMaxGrayLevel();
+            sliceSize = (size_t) paddedRows * paddedColumns;
+            // The zero border slices are already there
+            voxels.resize(paddedSlices * sliceSize);
+            // Warn about the quantization only once
+            if(quantitize)
+                quantizationMax = min(quantizationMax, maxGrayLevel);
+        }
+        copy(slice.getPixels(), slice.getPixels() + sliceSize,
+             voxels.begin() + (i + borderSize) * sliceSize);
     }
-    if((quantitize) && (imgRead.depth() == CV_8UC1) && (quantizationMax > IMG8MAXGRAYLEVEL)){
-        cout << "Warning! Provided a quantization level > maximum gray level of the image";
-        quantizationMax = IMG8MAXGRAYLEVEL;
+
+    if(borderType == 2){
+        // Replicate the first and the last slice
+        for (int i = 0; i < borderSize; ++i) {
+            copy(voxels.begin() + borderSize * sliceSize,
+                 voxels.begin() + (borderSize + 1) * sliceSize,
+                 voxels.begin() + i * sliceSize);
+            copy(voxels.begin() + (borderSize + numberOfSlices - 1) * sliceSize,
+                 voxels.begin() + (borderSize + numberOfSlices) * sliceSize,
+                 voxels.begin() + (borderSize + numberOfSlices + i) * sliceSize);
+        }
     }
-    if(quantitize)
-        imgRead = quantitizeImage(imgRead, quantizationMax);
-
-    // Get the pixels from the image to a standard uint array
-    vector<uint> pixels(imgRead.total());
-
-    int maxGrayLevel;
-    // TODO think again this mechanism , DRY
-    switch (imgRead.type()){
-        case CV_16UC1:
-            readUint(pixels, imgRead);
-            maxGrayLevel = IMG16MAXGRAYLEVEL;
-            break;
-        case CV_8UC1:
-            readUchars(pixels, imgRead);
-            maxGrayLevel = IMG8MAXGRAYLEVEL;
-            break;
-        default:
-            cerr << "ERROR! Unsupported depth type: " << imgRead.type();
-            exit(-4);
+    return Image(move(voxels), paddedSlices * paddedRows, paddedColumns, maxGrayLevel);
+}
+
+Image ImageLoader::readImageBand(const Mat& img, const int firstRow, const int lastRow,
+        const int windowSide, short int borderType, int borderSize,
+        bool quantitize, int quantizationMax, ThreadPool* workers,
+        QuantizationTable* quantizationTable){
+    if((img.type() != CV_16UC1) && (img.type() != CV_8UC1)){
+        cerr << "ERROR! Unsupported depth type: " << img.type();
+        exit(-4);
     }
-    // CREATE IMAGE abstraction structure
-    Image image = Image(pixels, imgRead.rows, imgRead.cols, maxGrayLevel);
-    return image;
+    // The pixels of the Mat are converted by the library, without copies
+    PixelBuffer input = {img.data, (img.type() == CV_16UC1) ? 16 : 8,
+            img.rows, img.cols, (size_t) img.step};
+    // The library reduces it silently; warn only once for the bands of an image
+    int maxGrayLevel = (input.bitsPerPixel == 16) ? 65535 : 255;
+    if(quantitize && (quantizationMax > maxGrayLevel) && (firstRow == 0))
+        cout << "Warning! Provided a quantization level > maximum gray level of the image" << endl;
+    return GLCMFeatures::readBand(input, firstRow, lastRow, windowSide,
+            borderType, borderSize, quantitize, quantizationMax, workers,
+            quantizationTable);
 }
 
 
@@ -111,66 +161,24 @@ void ImageLoader::showImagePaused(const Mat& img, const string& windowName){
 }
 
 // GLCM can work only with grayscale images
-Mat ImageLoader::convertToGrayScale(const Mat& inputImage) {
-    // Convert image to a 255 grayscale
-    Mat convertedImage = inputImage.clone();
-    normalize(convertedImage, convertedImage, 0, 255, NORM_MINMAX, CV_8UC1);
-    return convertedImage;
-}
-
-unsigned int quantizationStep(int intensity, int maxLevel, int oldMax){
-    return (intensity * maxLevel / oldMax);
-}
-
-Mat ImageLoader::quantitizeImage(Mat& img, int maxLevel) {
-    Mat convertedImage = img.clone();
-
-    switch(img.depth()){
-        case CV_8UC1:{
-            typedef MatIterator_<uchar> MI;
-            for(MI element = convertedImage.begin<uchar>() ; element != convertedImage.end<uchar>() ; element++)
-            {
-                int intensity = *element;
-                int newIntensity = quantizationStep(intensity, maxLevel, IMG8MAXGRAYLEVEL);
-                *element = newIntensity;
-            }
-            break;
-        }
-        case CV_16UC1: {
-            typedef MatIterator_<ushort> MI;
-            for(MI element = convertedImage.begin<ushort>() ; element != convertedImage.end<ushort>() ; element++)
-            {
-                int intensity = *element;
-                int newIntensity = quantizationStep(intensity, maxLevel, IMG16MAXGRAYLEVEL);
-                *element = newIntensity;
-            }
-            break;
-        }
-    }
-
+Mat ImageLoader::convertToGrayScale(const Mat& inputImage, const short int bitsPerPixel) {
+    // Converted straight from the input, without copying it first
+    Mat convertedImage;
+    if(bitsPerPixel == 32)
+        inputImage.convertTo(convertedImage, CV_32F);
+    else if(bitsPerPixel == 16)
+        normalize(inputImage, convertedImage, 0, 65535, NORM_MINMAX, CV_16UC1);
+    else
+        normalize(inputImage, convertedImage, 0, 255, NORM_MINMAX, CV_8UC1);
     return convertedImage;
 }
 
-void ImageLoader::addBorderToImage(Mat &img, short int borderType, int borderSize) {
-    switch (borderType){
-        case 0: // NO PADDING
-            break;
-        case 1: // 0 pixel padding
-            copyMakeBorder(img, img, borderSize, borderSize, borderSize, borderSize, BORDER_CONSTANT, 0);
-            break;
-        case 2: // Reflect pixels at the borders
-            copyMakeBorder(img, img, borderSize, borderSize, borderSize, borderSize, BORDER_REPLICATE);
-            break;
-    }
-
-}
-
 // Improve clarity in very dark/bright images
 Mat ImageLoader::stretchImage(const Mat& inputImage){
     Mat stretched;
 
-    // Stretch can only be applied to gray scale CV_8U
-    if(inputImage.type() != CV_8UC1){
+    // Stretch can only be applied to gray scale CV_8U or CV_16U
+    if((inputImage.type() != CV_8UC1) && (inputImage.type() != CV_16UC1)){
         inputImage.convertTo(inputImage, CV_8U);
     }
 
@@ -181,21 +189,27 @@ Mat ImageLoader::stretchImage(const Mat& inputImage){
 }
 
 // Perform needed transformation and save the image
-void ImageLoader::saveImage(const Mat &img, const string &fileName, bool stretch){
+void ImageLoader::saveImage(const Mat &img, const string &fileName, bool stretch,
+                            PhaseTimes* phaseTimes, const short int bitsPerPixel){
+    PhaseTimer reformatTimer(phaseTimes, REFORMAT_PHASE);
     // Transform to a format that opencv can save with imwrite
-    Mat convertedImage = ImageLoader::convertToGrayScale(img);
+    Mat convertedImage = ImageLoader::convertToGrayScale(img, bitsPerPixel);
+    // The float values are saved as they are
+    if(stretch && (bitsPerPixel != 32))
+        convertedImage = stretchImage(convertedImage);
+    reformatTimer.stop();
+
+    PhaseTimer encodingTimer(phaseTimes, IMAGE_ENCODING_PHASE);
+    saveImageToFileSystem(convertedImage, fileName + getImageExtension(bitsPerPixel));
+}
 
-    if(stretch){
-        Mat stretched = stretchImage(convertedImage);
-        saveImageToFileSystem(stretched, fileName);
-    }
-    else
-        saveImageToFileSystem(convertedImage, fileName);
+string ImageLoader::getImageExtension(const short int bitsPerPixel){
+    return (bitsPerPixel == 32) ? ".tiff" : ".png";
 }
 
 void ImageLoader::saveImageToFileSystem(const Mat& img, const string& fileName){
     try {
-        imwrite(fileName +".png", img);
+        imwrite(fileName, img);
     }catch (exception& e){
         cout << e.what() << '\n';
         cerr << "Fatal Error! Couldn't save the image";
@@ -3,6 +3,9 @@
 
 #include <iostream>
 #include "ImageData.h"
+#include "PhaseTimes.h"
+#include "ThreadPool.h"
+#include "QuantizationTable.h"
 #include <opencv/cv.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/core.hpp>
@@ -27,46 +30,121 @@ public:
      * @return
      */
     static Image readImage(string fileName, short int borderType, int borderSize, bool quantitize, int quantizationMax);
+    /**
+     * Invocation of Opencv standard reading method from file system; the
+     * pixels are kept in their compact (8/16 bit) representation
+     * @param fileName: the path/name of the image to read
+     * @return the image decoded in a single grayscale channel
+     */
+    static Mat readImage(string fileName);
+    /**
+     * Invocation of Opencv standard reading method from file system that
+     * doesn't stop the program when the image can't be read
+     * @param fileName: the path/name of the image to read
+     * @param image: where the image decoded in a single grayscale channel
+     * is put
+     * @return false if the image could not be read
+     */
+    static bool tryReadImage(const string& fileName, Mat& image);
+    /**
+     * Read all the pages of a multi-page image (ex. TIFF stacks of the
+     * slices of a MRI study); other formats give a single page
+     * @param fileName: the path/name of the image to read
+     * @return the pages decoded in a single grayscale channel, in the order
+     * they are stored in the file
+     */
+    static vector<Mat> readImageStack(string fileName);
+    /**
+     * Method that external components will invoke to get the voxels of a
+     * volume, with borders applied also before the first and after the last
+     * slice
+     * @param slices: the pages read with readImageStack; all of the same size
+     * @param borderType: type of the border to apply to the volume
+     * @param borderSize: border to apply to each side of the volume
+     * @param quantitize: reduction of grayLevels to apply to the volume
+     * @param quantizationMax: maximum gray level when quantitization is
+     * applied to reduce the graylevels in [0,quantizationMax]
+     * @param workers: threads that copy the rows of large slices; NULL for
+     * the calling thread only
+     * @param quantizationTable: levels reused by all the slices; NULL for
+     * building them for each slice
+     * @return the bordered slices, one below the other: an image of
+     * (slices + 2 * borders) * (rows + 2 * borders) rows
+     */
+    static Image readVolume(const vector<Mat>& slices, short int borderType,
+            int borderSize, bool quantitize, int quantizationMax,
+            ThreadPool* workers = NULL, QuantizationTable* quantizationTable = NULL);
+    /**
+     * Method that external components will invoke to get an Image instance
+     * with only the pixels needed by a band of rows of windows
+     * @param img: the image decoded with readImage
+     * @param firstRow: first row of windows of the band
+     * @param lastRow: last row (excluded) of windows of the band
+     * @param windowSide: side of each window; windows of the last row of the
+     * band need the pixels below it
+     * @param borderType: type of the border to apply to the image read
+     * @param borderSize: border to apply to each side of the image read
+     * @param quantitize: reduction of grayLevels to apply to the image read
+     * @param quantizationMax: maximum gray level when quantitization is
+     * applied to reduce the graylevels in [0,quantizationMax]
+     * @param workers: threads that copy the rows of large bands; NULL for
+     * the calling thread only. They must not be running a job
+     * @param quantizationTable: levels reused by the bands and images read
+     * with the same quantization; NULL for building them
+     * @return the band, with borders, as if it were a whole image of
+     * (lastRow - firstRow) rows of windows
+     */
+    static Image readImageBand(const Mat& img, int firstRow, int lastRow,
+            int windowSide, short int borderType, int borderSize,
+            bool quantitize, int quantizationMax, ThreadPool* workers = NULL,
+            QuantizationTable* quantizationTable = NULL);
     /**
      * Method used when generating feature images with the features values computed
      * @param rows
      * @param cols
-     * @param input: list of all the features values used as intensity in the
-     * output image
+     * @param input: plane of all the features values used as intensity in the
+     * output image; it is not copied so it must outlive the returned image
      * @return image obtained from features values provided
      */
-    static Mat createDoubleMat(int rows, int cols, const vector<double>& input);
+    static Mat createDoubleMat(int rows, int cols, const double* input);
     /**
      * Save the feature image on disk
      * @param image to save
-     * @param fileName path where to save the image
+     * @param fileName path where to save the image, without extension
      * @param stretch linear stretch applied to enhance quality with very
-     * dark/bright images
+     * dark/bright images; never applied to float images
+     * @param phaseTimes where the time of the conversion and of the encoding
+     * is added; NULL when not measured
+     * @param bitsPerPixel 8 or 16 for PNG images with the values spread on
+     * all the gray levels, 32 for TIFF images with the float values as they are
      */
     static void saveImage(const Mat &image, const string &fileName,
-                          bool stretch = true);
+                          bool stretch = true, PhaseTimes* phaseTimes = NULL,
+                          short int bitsPerPixel = 8);
+    /**
+     * Utility method
+     * @param bitsPerPixel of the feature images
+     * @return the extension of the files of the feature images
+     */
+    static string getImageExtension(short int bitsPerPixel);
     // DEBUG method
     static void showImagePaused(const Mat& img, const string& windowName);
 private:
-    /**
-     * Invocation of Opencv standard reading method from file system
-     * @param fileName
-     * @return
-     */
-    static Mat readImage(string fileName);
     /**
      * Converting images with colors to grayScale
      * @param inputImage
+     * @param bitsPerPixel 8 or 16 for gray levels spread on all the ones of
+     * the depth, 32 for the values as floats
      * @return
      */
-    static Mat convertToGrayScale(const Mat& inputImage);
+    static Mat convertToGrayScale(const Mat& inputImage, short int bitsPerPixel);
     /**
-     * Quantitze gray levels in set [0, Max]
+     * Check that the image read is a grayscale 8/16 bit one, otherwise
+     * convert it
      * @param inputImage
-     * @param maxLevel
-     * @return
+     * @return image with a single grayscale channel
      */
-    static Mat quantitizeImage(Mat& inputImage, int maxLevel);
+    static Mat toGrayLevels(Mat& inputImage);
     /**
      * Returnes a stretched image to enhance details in over/under exposed
      * input
@@ -77,16 +155,9 @@ private:
     /**
      * Save the image on the file system
      * @param img
-     * @param fileName
+     * @param fileName: path with the extension, which decides the format
      */
     static void saveImageToFileSystem(const Mat& img, const string& fileName);
-    /**
-     * Add borders to the image read
-     * @param img
-     * @param borderType
-     * @param borderSize
-     */
-    static void addBorderToImage(Mat &img, short int borderType, int borderSize);
 
 };
 
@@ -0,0 +1,135 @@
+#include <iomanip>
+#include <sstream>
+#include "MemoryPlanner.h"
+#include "GLCMFeatures.h"
+#include "TextFeatureWriter.h"
+
+const int MemoryPlanner::MIN_PIPELINED_BAND_ROWS;
+
+unsigned long long MemoryPlan::getTotalBytes() const{
+    return usedBytes + threadBytes + bandBytes + featureImageBytes;
+}
+
+MemoryPlanner::MemoryPlanner(const ProgramArguments& progArg): progArg(progArg){
+}
+
+unsigned long long MemoryPlanner::getThreadBytes() const{
+    // Each pair of the window can be a different element of the glcm
+    unsigned long long pairs = (unsigned long long) progArg.windowSize * progArg.windowSize;
+    if(progArg.symmetric)
+        pairs *= 2;
+    unsigned long long bytes = pairs * (sizeof(GrayPair) + 4 * sizeof(AggregatedGrayPair));
+    if(progArg.textOutput)
+        bytes += TextFeatureWriter::getBufferSize();
+    return bytes;
+}
+
+int MemoryPlanner::planThreads() const{
+    int threads = (progArg.numberOfThreads > 0) ? progArg.numberOfThreads
+            : ThreadPool::getAvailableCores();
+    unsigned long long threadsInBudget = progArg.memoryBudget / 2 / getThreadBytes();
+    if(threadsInBudget < (unsigned long long) threads)
+        threads = max(1, (int) threadsInBudget);
+    return threads;
+}
+
+unsigned long long MemoryPlanner::estimate(MemoryPlan& plan, const int rows,
+        const int columns, const int bandRows, const int pipelineDepth) const{
+    /* The pixels of a band, with the rows below it needed by its last
+     * windows, are read and then copied for the workers; the borders are
+     * virtual */
+    unsigned long long pixelBytes = 2ull * (bandRows + progArg.windowSize)
+            * columns * sizeof(unsigned int);
+    unsigned long long valueBytes = (unsigned long long) bandRows * columns
+            * Features::getSupportedFeaturesCount() * sizeof(double);
+    // In background, a band is computed while others wait and one is saved
+    int numberOfBands = (rows + bandRows - 1) / bandRows;
+    int bandsInMemory = (pipelineDepth > 0) ? min(numberOfBands, pipelineDepth + 2) : 1;
+    plan.bandBytes = pixelBytes + bandsInMemory * valueBytes;
+
+    /* Each feature image is its plane converted to the pixels of the image
+     * and stretched; each thread encodes one at a time. They can only be
+     * created from whole images */
+    plan.featureImageBytes = 0;
+    if(progArg.createImages && (bandRows >= rows)){
+        int encodedImages = min(plan.threads, Features::getSupportedFeaturesCount());
+        plan.featureImageBytes = (unsigned long long) encodedImages * rows * columns
+                * 2 * (progArg.imageDepth / 8);
+    }
+    return plan.getTotalBytes();
+}
+
+MemoryPlan MemoryPlanner::planImage(const int rows, const int columns,
+        const unsigned long long usedBytes, const int threads) const{
+    MemoryPlan plan;
+    plan.threads = threads;
+    plan.usedBytes = usedBytes;
+    plan.threadBytes = threads * getThreadBytes();
+    unsigned long long budget = progArg.memoryBudget;
+
+    // The whole image, or the bands asked, when they fit
+    int tallestBand = (progArg.bandRows > 0) ? min(progArg.bandRows, rows) : rows;
+    if(estimate(plan, rows, columns, tallestBand, progArg.pipelineDepth) <= budget){
+        plan.bandRows = tallestBand;
+        plan.pipelineDepth = progArg.pipelineDepth;
+        plan.fits = true;
+        return plan;
+    }
+
+    /* Shorter bands; the ones saved in background are preferred while they
+     * aren't too short, since saving is then hidden by the computation.
+     * Fewer bands wait (half each time) when they would be */
+    int pipelineDepth = (progArg.pipelineDepth > 0) ? progArg.pipelineDepth : 1;
+    for (; pipelineDepth >= 0; pipelineDepth /= 2) {
+        int bandRows = tallestBand - 1;
+        while((bandRows > 0)
+            && (estimate(plan, rows, columns, bandRows, pipelineDepth) > budget))
+            bandRows--;
+        bool tooShort = (pipelineDepth > 0) && (bandRows < MIN_PIPELINED_BAND_ROWS)
+                && (bandRows < tallestBand - 1);
+        if((bandRows > 0) && !tooShort){
+            plan.bandRows = bandRows;
+            plan.pipelineDepth = pipelineDepth;
+            plan.fits = true;
+            return plan;
+        }
+        if(pipelineDepth == 0)
+            break;
+    }
+
+    // Not even a band of 1 row fits
+    plan.bandRows = 1;
+    plan.pipelineDepth = 0;
+    estimate(plan, rows, columns, 1, 0);
+    plan.fits = false;
+    return plan;
+}
+
+/**
+ * Utility method
+ * @param bytes
+ * @return the bytes in MB, with 1 decimal digit
+ */
+static string toMegabytes(const unsigned long long bytes){
+    ostringstream text;
+    text << fixed << setprecision(1) << (bytes / (1024.0 * 1024.0)) << " MB";
+    return text.str();
+}
+
+void MemoryPlanner::printPlan(const MemoryPlan& plan, const int rows) const{
+    cout << endl << "* Memory plan (budget: " << toMegabytes(progArg.memoryBudget)
+         << ") * " << endl;
+    cout << "\tThreads: " << plan.threads << endl;
+    if(plan.bandRows >= rows)
+        cout << "\tRows of each band: the whole image (" << rows << ")" << endl;
+    else
+        cout << "\tRows of each band: " << plan.bandRows << " of " << rows << endl;
+    cout << "\tBands waiting to be saved: " << plan.pipelineDepth << endl;
+    cout << "\tAlready used (code, libraries, decoded image): "
+         << toMegabytes(plan.usedBytes) << endl;
+    cout << "\tWork areas and text buffers: " << toMegabytes(plan.threadBytes) << endl;
+    cout << "\tPixels and values of the bands: " << toMegabytes(plan.bandBytes) << endl;
+    if(plan.featureImageBytes > 0)
+        cout << "\tFeature images: " << toMegabytes(plan.featureImageBytes) << endl;
+    cout << "\tEstimated peak: " << toMegabytes(plan.getTotalBytes()) << endl;
+}
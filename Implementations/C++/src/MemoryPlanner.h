@@ -0,0 +1,123 @@
+#ifndef FEATUREEXTRACTOR_MEMORYPLANNER_H
+#define FEATUREEXTRACTOR_MEMORYPLANNER_H
+
+#include "ProgramArguments.h"
+
+/**
+ * How an image is computed within a memory budget, with the estimated bytes
+ * of each part of the computation
+ */
+struct MemoryPlan {
+    /**
+     * Workers that compute the windows
+     */
+    int threads;
+    /**
+     * Rows of windows of each band; the rows of the image when it is
+     * computed at once
+     */
+    int bandRows;
+    /**
+     * Computed bands that can wait to be saved
+     */
+    int pipelineDepth;
+    /**
+     * Already used before computing: code, libraries and the image decoded
+     * from the file
+     */
+    unsigned long long usedBytes;
+    /**
+     * Work areas and text buffers of all the workers
+     */
+    unsigned long long threadBytes;
+    /**
+     * Pixels and values of all the bands in memory at the same time
+     */
+    unsigned long long bandBytes;
+    /**
+     * Feature images being converted and encoded at the same time; only
+     * for whole images
+     */
+    unsigned long long featureImageBytes;
+    /**
+     * The estimated bytes are within the budget
+     */
+    bool fits;
+
+    /**
+     * Utility method
+     * @return the estimated bytes of the whole computation
+     */
+    unsigned long long getTotalBytes() const;
+};
+
+/**
+ * Chooses the threads, the rows of each band and the bands waiting to be
+ * saved (--pipeline) so that the computation of an image fits in the memory
+ * budget (--mem-budget). The options given by the user are upper bounds.
+ * The threads only depend on the windows, so they are planned before the
+ * image is read; the bands depend on its size
+ */
+class MemoryPlanner {
+public:
+    /**
+     * Initialize the class
+     * @param progArg: parameters of the problem, with the budget
+     */
+    explicit MemoryPlanner(const ProgramArguments& progArg);
+    /**
+     * Choose how many workers compute the windows: the ones asked (all the
+     * cores for 0), unless their memory takes more than half of the budget
+     * @return at least 1 thread
+     */
+    int planThreads() const;
+    /**
+     * Choose the bands of an image: the whole image (or the bands of
+     * --band-rows) when it fits, otherwise the tallest bands that fit,
+     * saved in background (1 band waiting, if --pipeline wasn't given) when
+     * that doesn't make them too short, otherwise with fewer bands waiting
+     * @param rows: rows of the image read
+     * @param columns: columns of the image read
+     * @param usedBytes: memory already used by the process, with the
+     * image read
+     * @param threads: workers that compute the windows
+     * @return the plan; not fitting, with bands of 1 row, if nothing fits
+     */
+    MemoryPlan planImage(int rows, int columns, unsigned long long usedBytes,
+            int threads) const;
+    /**
+     * Display the plan and the estimated memory of each part
+     * @param plan
+     * @param rows: rows of the image read
+     */
+    void printPlan(const MemoryPlan& plan, int rows) const;
+
+private:
+    ProgramArguments progArg;
+    /**
+     * Bands shorter than this aren't worth computing in background: the
+     * memory of a waiting band is better spent on taller bands
+     */
+    static const int MIN_PIPELINED_BAND_ROWS = 64;
+
+    /**
+     * Utility method
+     * @return bytes of the work area and of the text buffer of each worker
+     */
+    unsigned long long getThreadBytes() const;
+    /**
+     * Estimate the memory of a computation
+     * @param plan: where the bytes of the bands and of the feature images
+     * are put; its used and thread bytes must be set
+     * @param rows: rows of the image read
+     * @param columns: columns of the image read
+     * @param bandRows: rows of windows of each band
+     * @param pipelineDepth: computed bands that can wait to be saved
+     * @return the estimated bytes of the whole computation
+     */
+    unsigned long long estimate(MemoryPlan& plan, int rows, int columns,
+            int bandRows, int pipelineDepth) const;
+};
+
+
+#endif //FEATUREEXTRACTOR_MEMORYPLANNER_H
@@ -0,0 +1,93 @@
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include "NpyWriter.h"
+
+// Format version 1.0 allows headers up to 65535 bytes
+#define NPY_MAGIC "\x93NUMPY"
+#define NPY_MAGIC_LENGTH 6
+#define NPY_PREAMBLE_LENGTH 10
+#define NPY_ALIGNMENT 64
+
+string NpyWriter::getDoubleDescription(){
+    uint16_t probe = 1;
+    bool littleEndian = (*reinterpret_cast<unsigned char*>(&probe) == 1);
+    return littleEndian ? "<f8" : ">f8";
+}
+
+string NpyWriter::createHeader(const size_t rows, const size_t columns){
+    vector<size_t> shape;
+    shape.push_back(rows);
+    shape.push_back(columns);
+    return createHeader(shape);
+}
+
+string NpyWriter::createHeader(const vector<size_t>& shape){
+    ostringstream dictionary;
+    dictionary << "{'descr': '" << getDoubleDescription() << "', "
+               << "'fortran_order': False, "
+               << "'shape': (";
+    for (size_t i = 0; i < shape.size(); ++i) {
+        if(i > 0)
+            dictionary << ", ";
+        dictionary << shape[i];
+    }
+    // Python needs the comma for tuples of 1 element
+    if(shape.size() == 1)
+        dictionary << ",";
+    dictionary << "), }";
+    string header = dictionary.str();
+
+    // Pad with spaces and terminate with newline to align the data
+    size_t unpaddedLength = NPY_PREAMBLE_LENGTH + header.size() + 1;
+    size_t padding = (NPY_ALIGNMENT - (unpaddedLength % NPY_ALIGNMENT)) % NPY_ALIGNMENT;
+    header.append(padding, ' ');
+    header.push_back('\n');
+
+    string preamble(NPY_MAGIC, NPY_MAGIC_LENGTH);
+    preamble.push_back(1); // major version
+    preamble.push_back(0); // minor version
+    // Header length is little endian regardless of the data
+    preamble.push_back((char) (header.size() & 0xFF));
+    preamble.push_back((char) ((header.size() >> 8) & 0xFF));
+    return preamble + header;
+}
+
+bool NpyWriter::savePlane(string const& filePath, const double* values,
+        const size_t numberOfValues, const size_t totalRows,
+        const size_t columns, const bool append){
+    ofstream file;
+    if(append)
+        file.open((filePath + ".npy").c_str(), ios::binary | ios::app);
+    else
+        file.open((filePath + ".npy").c_str(), ios::binary | ios::trunc);
+    if(!file.is_open())
+        return false;
+
+    if(!append){
+        string header = createHeader(totalRows, columns);
+        file.write(header.data(), header.size());
+    }
+    // All the values with a single write
+    file.write(reinterpret_cast<const char*>(values),
+            numberOfValues * sizeof(double));
+    file.close();
+    return !file.fail();
+}
+
+bool NpyWriter::saveVolume(const string& filePath, const double* values,
+        const size_t slices, const size_t rows, const size_t columns){
+    ofstream file((filePath + ".npy").c_str(), ios::binary | ios::trunc);
+    if(!file.is_open())
+        return false;
+    vector<size_t> shape;
+    shape.push_back(slices);
+    shape.push_back(rows);
+    shape.push_back(columns);
+    string header = createHeader(shape);
+    file.write(header.data(), header.size());
+    file.write(reinterpret_cast<const char*>(values),
+            slices * rows * columns * sizeof(double));
+    file.close();
+    return !file.fail();
+}
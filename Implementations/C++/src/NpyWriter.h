@@ -0,0 +1,65 @@
+#ifndef FEATUREEXTRACTOR_NPYWRITER_H
+#define FEATUREEXTRACTOR_NPYWRITER_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * This class saves planes of feature values as NumPy .npy files: a small
+ * text header with dtype and shape followed by the raw doubles, so the
+ * results can be loaded with numpy.load (or memory mapped) without any
+ * parsing
+ */
+class NpyWriter {
+public:
+    /**
+     * Save a plane, or a band of rows of it, in the .npy file
+     * @param filePath: path of the file, without extension
+     * @param values: the values to save, row after row
+     * @param numberOfValues: how many values to save
+     * @param totalRows: rows of the whole plane, written in the header
+     * @param columns: columns of the whole plane, written in the header
+     * @param append: add the values at the end of a file whose header was
+     * already written by a previous invocation
+     * @return false if the file couldn't be written
+     */
+    static bool savePlane(const string& filePath, const double* values,
+            size_t numberOfValues, size_t totalRows, size_t columns,
+            bool append);
+    /**
+     * Save a feature volume in the .npy file, as a 3d array
+     * @param filePath: path of the file, without extension
+     * @param values: the values to save, slice after slice, row after row
+     * @param slices
+     * @param rows
+     * @param columns
+     * @return false if the file couldn't be written
+     */
+    static bool saveVolume(const string& filePath, const double* values,
+            size_t slices, size_t rows, size_t columns);
+    /**
+     * Create the header for a 2d array of doubles in C order
+     * @param rows
+     * @param columns
+     * @return magic string, version, header length and dictionary, padded
+     * so that the values start on a 64 bytes boundary
+     */
+    static string createHeader(size_t rows, size_t columns);
+    /**
+     * Create the header for an array of doubles in C order
+     * @param shape: size of each dimension, the slowest varying first
+     * @return magic string, version, header length and dictionary, padded
+     * so that the values start on a 64 bytes boundary
+     */
+    static string createHeader(const vector<size_t>& shape);
+    /**
+     * Utility method
+     * @return the numpy description of a native double ("<f8" or ">f8")
+     */
+    static string getDoubleDescription();
+};
+
+
+#endif //FEATUREEXTRACTOR_NPYWRITER_H
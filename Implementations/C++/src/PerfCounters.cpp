@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+PerfCounters::PerfCounters(): numberOfCountedEvents(0), openError(0){
+    for (int i = 0; i < NUMBER_OF_PERF_EVENTS; ++i) {
+        fileDescriptors[i] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters(){
+    close();
+}
+
+#ifdef __linux__
+/**
+ * Utility method
+ * @param event
+ * @param attributes: where the type and the configuration of the event for
+ * perf_event_open are put
+ */
+static void setEventConfig(const PerfEvent event, struct perf_event_attr& attributes){
+    attributes.type = PERF_TYPE_HARDWARE;
+    switch (event){
+        case CYCLES_EVENT:
+            attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case INSTRUCTIONS_EVENT:
+            attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case L1D_MISSES_EVENT:
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.config = PERF_COUNT_HW_CACHE_L1D
+                    | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case LLC_MISSES_EVENT:
+            attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        default:
+            attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+    }
+}
+
+bool PerfCounters::open(){
+    close();
+    int groupLeader = -1;
+    for (int i = 0; i < NUMBER_OF_PERF_EVENTS; ++i) {
+        struct perf_event_attr attributes;
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        setEventConfig((PerfEvent) i, attributes);
+        // The group starts when all its counters are open
+        attributes.disabled = (groupLeader == -1) ? 1 : 0;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_GROUP
+                | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // Calling thread, on any cpu
+        int fd = syscall(SYS_perf_event_open, &attributes, 0, -1, groupLeader, 0);
+        if(fd == -1){
+            openError = errno;
+            continue;
+        }
+        if(groupLeader == -1)
+            groupLeader = fd;
+        fileDescriptors[i] = fd;
+        countedEvents[numberOfCountedEvents++] = (PerfEvent) i;
+    }
+    if(groupLeader == -1)
+        return false;
+    ioctl(groupLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(groupLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+}
+
+void PerfCounters::read(uint64_t* values) const{
+    fill(values, values + NUMBER_OF_PERF_EVENTS, 0);
+    if(numberOfCountedEvents == 0)
+        return;
+    // Number of counters, time enabled, time running, then their values
+    uint64_t group[3 + NUMBER_OF_PERF_EVENTS];
+    ssize_t readBytes = ::read(fileDescriptors[countedEvents[0]], group, sizeof(group));
+    if((readBytes < (ssize_t) (3 * sizeof(uint64_t))) || (group[2] == 0))
+        return;
+    // Counters shared with other groups only run for part of the time
+    double scale = (double) group[1] / group[2];
+    for (uint64_t i = 0; (i < group[0]) && (i < (uint64_t) numberOfCountedEvents); ++i) {
+        values[countedEvents[i]] = (uint64_t) (group[3 + i] * scale);
+    }
+}
+
+void PerfCounters::close(){
+    for (int i = 0; i < NUMBER_OF_PERF_EVENTS; ++i) {
+        if(fileDescriptors[i] != -1)
+            ::close(fileDescriptors[i]);
+        fileDescriptors[i] = -1;
+    }
+    numberOfCountedEvents = 0;
+}
+#else
+bool PerfCounters::open(){
+    openError = ENOSYS;
+    return false;
+}
+
+void PerfCounters::read(uint64_t* values) const{
+    fill(values, values + NUMBER_OF_PERF_EVENTS, 0);
+}
+
+void PerfCounters::close(){
+}
+#endif
+
+bool PerfCounters::isCounted(const PerfEvent event) const{
+    return fileDescriptors[event] != -1;
+}
+
+string PerfCounters::getOpenError() const{
+    return strerror(openError);
+}
+
+string PerfCounters::getEventName(const PerfEvent event){
+    const char* names[] = {"cycles", "instructions", "l1dMisses", "llcMisses",
+                           "branchMisses"};
+    return names[event];
+}
+
+PerfTotals::PerfTotals(): windows(0), pairs(0), warned(false){
+    for (int i = 0; i < NUMBER_OF_COUNTED_PHASES; ++i) {
+        for (int j = 0; j < NUMBER_OF_PERF_EVENTS; ++j) {
+            counts[i][j] = 0;
+        }
+    }
+    for (int j = 0; j < NUMBER_OF_PERF_EVENTS; ++j) {
+        counted[j] = false;
+    }
+}
+
+void PerfTotals::add(const uint64_t threadCounts[NUMBER_OF_COUNTED_PHASES][NUMBER_OF_PERF_EVENTS],
+        const uint64_t threadWindows, const uint64_t threadPairs,
+        const PerfCounters& counters){
+    for (int i = 0; i < NUMBER_OF_COUNTED_PHASES; ++i) {
+        for (int j = 0; j < NUMBER_OF_PERF_EVENTS; ++j) {
+            counts[i][j] += threadCounts[i][j];
+        }
+    }
+    for (int j = 0; j < NUMBER_OF_PERF_EVENTS; ++j) {
+        if(counters.isCounted((PerfEvent) j))
+            counted[j] = true;
+    }
+    windows += threadWindows;
+    pairs += threadPairs;
+}
+
+void PerfTotals::warnMissingCounters(const PerfCounters& counters){
+    if(warned.exchange(true))
+        return;
+    cerr << "WARNING: the hardware counters (--perf) aren't available ("
+         << counters.getOpenError() << "); they may be missing in virtual "
+            "machines or not permitted by /proc/sys/kernel/perf_event_paranoid."
+            " The features are computed without them" << endl;
+}
+
+double PerfTotals::getAverage(const CountedPhase phase, const PerfEvent event) const{
+    if(!counted[event] || (windows == 0))
+        return -1;
+    return (double) counts[phase][event] / windows;
+}
+
+double PerfTotals::getPerThousandInstructions(const CountedPhase phase,
+        const PerfEvent event) const{
+    if(!counted[event] || !counted[INSTRUCTIONS_EVENT]
+        || (counts[phase][INSTRUCTIONS_EVENT] == 0))
+        return -1;
+    return 1000.0 * counts[phase][event] / counts[phase][INSTRUCTIONS_EVENT];
+}
+
+double PerfTotals::getInstructionsPerCycle(const CountedPhase phase) const{
+    if(!counted[INSTRUCTIONS_EVENT] || !counted[CYCLES_EVENT]
+        || (counts[phase][CYCLES_EVENT] == 0))
+        return -1;
+    return (double) counts[phase][INSTRUCTIONS_EVENT] / counts[phase][CYCLES_EVENT];
+}
+
+/**
+ * Utility method
+ * @param out: where to print
+ * @param value: value to print; "n/a" if negative (not counted)
+ */
+static void printValue(ostream& out, const double value){
+    if(value < 0)
+        out << setw(14) << "n/a";
+    else
+        out << setw(14) << value;
+}
+
+void PerfTotals::print(ostream& out) const{
+    if(windows == 0)
+        return;
+    out << endl << "* Hardware counters: average of each glcm (a window in a "
+                   "direction) *" << endl;
+    out << fixed << setprecision(1);
+    out << "\t" << left << setw(22) << "" << right << setw(14) << "glcm"
+        << setw(14) << "features" << endl;
+    for (int j = 0; j < NUMBER_OF_PERF_EVENTS; ++j) {
+        out << "\t" << left << setw(22) << PerfCounters::getEventName((PerfEvent) j) << right;
+        printValue(out, getAverage(GLCM_COUNTED, (PerfEvent) j));
+        printValue(out, getAverage(FEATURES_COUNTED, (PerfEvent) j));
+        out << endl;
+    }
+    out << setprecision(2);
+    out << "\t" << left << setw(22) << "instructions/cycle" << right;
+    printValue(out, getInstructionsPerCycle(GLCM_COUNTED));
+    printValue(out, getInstructionsPerCycle(FEATURES_COUNTED));
+    out << endl;
+    const PerfEvent misses[] = {L1D_MISSES_EVENT, LLC_MISSES_EVENT, BRANCH_MISSES_EVENT};
+    for (int k = 0; k < 3; ++k) {
+        out << "\t" << left << setw(22) << PerfCounters::getEventName(misses[k]) + "/1k instr."
+            << right;
+        printValue(out, getPerThousandInstructions(GLCM_COUNTED, misses[k]));
+        printValue(out, getPerThousandInstructions(FEATURES_COUNTED, misses[k]));
+        out << endl;
+    }
+    // Insertions with a linear search get slower as the glcm grows
+    double pairsPerWindow = (double) pairs / windows;
+    out << "- Pairs in each glcm: " << pairsPerWindow;
+    double cycles = getAverage(GLCM_COUNTED, CYCLES_EVENT);
+    double instructions = getAverage(GLCM_COUNTED, INSTRUCTIONS_EVENT);
+    if((pairsPerWindow > 0) && (cycles >= 0))
+        out << "; cycles for each pair: " << cycles / pairsPerWindow;
+    if((pairsPerWindow > 0) && (instructions >= 0))
+        out << "; instructions for each pair: " << instructions / pairsPerWindow;
+    out << endl;
+    out.unsetf(ios::floatfield);
+    out << setprecision(6);
+}
+
+/**
+ * Utility method
+ * @param out: where to write
+ * @param value: value to write; null if negative (not counted)
+ */
+static void writeJsonValue(ostream& out, const double value){
+    if(value < 0)
+        out << "null";
+    else
+        out << value;
+}
+
+void PerfTotals::writeJson(ostream& out) const{
+    if(windows == 0){
+        out << "null";
+        return;
+    }
+    const char* phaseNames[] = {"glcm", "features"};
+    out << "{" << endl;
+    out << "    \"windows\": " << windows << "," << endl;
+    out << "    \"pairs\": " << pairs;
+    for (int i = 0; i < NUMBER_OF_COUNTED_PHASES; ++i) {
+        CountedPhase phase = (CountedPhase) i;
+        out << "," << endl << "    \"" << phaseNames[i] << "\": {" << endl;
+        for (int j = 0; j < NUMBER_OF_PERF_EVENTS; ++j) {
+            out << "      \"" << PerfCounters::getEventName((PerfEvent) j) << "PerWindow\": ";
+            writeJsonValue(out, getAverage(phase, (PerfEvent) j));
+            out << "," << endl;
+        }
+        out << "      \"instructionsPerCycle\": ";
+        writeJsonValue(out, getInstructionsPerCycle(phase));
+        const PerfEvent misses[] = {L1D_MISSES_EVENT, LLC_MISSES_EVENT, BRANCH_MISSES_EVENT};
+        for (int k = 0; k < 3; ++k) {
+            out << "," << endl << "      \"" << PerfCounters::getEventName(misses[k])
+                << "PerThousandInstructions\": ";
+            writeJsonValue(out, getPerThousandInstructions(phase, misses[k]));
+        }
+        out << endl << "    }";
+    }
+    out << endl << "  }";
+}
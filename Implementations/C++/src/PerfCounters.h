@@ -0,0 +1,172 @@
+#ifndef FEATUREEXTRACTOR_PERFCOUNTERS_H
+#define FEATUREEXTRACTOR_PERFCOUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+/**
+ * Hardware events counted by the processor
+ */
+enum PerfEvent {
+    CYCLES_EVENT,
+    INSTRUCTIONS_EVENT,
+    /**
+     * Reads that missed the level 1 data cache
+     */
+    L1D_MISSES_EVENT,
+    /**
+     * Accesses that missed the last level cache
+     */
+    LLC_MISSES_EVENT,
+    BRANCH_MISSES_EVENT,
+    NUMBER_OF_PERF_EVENTS
+};
+
+/**
+ * Phases of the computation of each window whose events are counted
+ */
+enum CountedPhase {
+    /**
+     * Pairs of pixels of the window inserted in the glcm, and its aggregated
+     * representations
+     */
+    GLCM_COUNTED,
+    /**
+     * Features extracted from the glcm and saved
+     */
+    FEATURES_COUNTED,
+    NUMBER_OF_COUNTED_PHASES
+};
+
+/**
+ * Hardware counters of the thread that opens them, read with the Linux
+ * perf_event_open interface. Only the events of the user space are counted.
+ * The counters can be missing (other systems, virtual machines, not
+ * permitted by /proc/sys/kernel/perf_event_paranoid): then open fails and
+ * nothing is counted
+ */
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+    /**
+     * Start counting the events of the calling thread
+     * @return false if no counter could be opened
+     */
+    bool open();
+    /**
+     * Read all the counters together
+     * @param values: where the events counted since open are put, scaled
+     * when the processor had to share its counters; 0 for the events
+     * that can't be counted
+     */
+    void read(uint64_t* values) const;
+    /**
+     * Utility method
+     * @param event
+     * @return true if the event is counted
+     */
+    bool isCounted(PerfEvent event) const;
+    /**
+     * Utility method
+     * @return why the last open failed
+     */
+    string getOpenError() const;
+    /**
+     * Utility method
+     * @param event
+     * @return name of the event in the reports
+     */
+    static string getEventName(PerfEvent event);
+
+private:
+    /**
+     * Counter of each event; -1 when not counted
+     */
+    int fileDescriptors[NUMBER_OF_PERF_EVENTS];
+    /**
+     * Counted events, in the order they are read
+     */
+    PerfEvent countedEvents[NUMBER_OF_PERF_EVENTS];
+    int numberOfCountedEvents;
+    /**
+     * errno of the last counter that couldn't be opened
+     */
+    int openError;
+
+    /**
+     * The counters are closed by the destructor
+     */
+    PerfCounters(const PerfCounters& other);
+    PerfCounters& operator=(const PerfCounters& other);
+    void close();
+};
+
+/**
+ * Events counted by all the threads in each phase of the windows. Every
+ * method can be called concurrently
+ */
+class PerfTotals {
+public:
+    PerfTotals();
+    /**
+     * Add the events counted by a thread
+     * @param counts: events of each counted phase
+     * @param windows: glcms (a window in a direction) counted
+     * @param pairs: pairs of pixels inserted in those glcms
+     * @param counters: counters that counted the events
+     */
+    void add(const uint64_t counts[NUMBER_OF_COUNTED_PHASES][NUMBER_OF_PERF_EVENTS],
+             uint64_t windows, uint64_t pairs, const PerfCounters& counters);
+    /**
+     * Tell once that the counters are missing
+     * @param counters: counters that couldn't be opened
+     */
+    void warnMissingCounters(const PerfCounters& counters);
+    /**
+     * Print the average events of each glcm, and the ratios between them
+     * @param out: where to print
+     */
+    void print(ostream& out) const;
+    /**
+     * Write the same values of print as a JSON object; null if nothing was
+     * counted
+     * @param out: where to write
+     */
+    void writeJson(ostream& out) const;
+
+private:
+    atomic<uint64_t> counts[NUMBER_OF_COUNTED_PHASES][NUMBER_OF_PERF_EVENTS];
+    atomic<uint64_t> windows;
+    atomic<uint64_t> pairs;
+    /**
+     * Events counted by at least a thread
+     */
+    atomic<bool> counted[NUMBER_OF_PERF_EVENTS];
+    atomic<bool> warned;
+
+    /**
+     * Utility method
+     * @param phase
+     * @param event
+     * @return average events of each glcm in the phase; -1 if not counted
+     */
+    double getAverage(CountedPhase phase, PerfEvent event) const;
+    /**
+     * Utility method
+     * @return misses, per 1000 instructions, in the phase; -1 if not counted
+     */
+    double getPerThousandInstructions(CountedPhase phase, PerfEvent event) const;
+    /**
+     * Utility method
+     * @return instructions per cycle of the phase; -1 if not counted
+     */
+    double getInstructionsPerCycle(CountedPhase phase) const;
+};
+
+
+#endif //FEATUREEXTRACTOR_PERFCOUNTERS_H
@@ -0,0 +1,79 @@
+#include <chrono>
+#include <iomanip>
+#include "PhaseTimes.h"
+
+PhaseTimes::PhaseTimes(): windows(0), bytes(0){
+    for (int i = 0; i < NUMBER_OF_PHASES; ++i) {
+        nanoseconds[i] = 0;
+    }
+}
+
+void PhaseTimes::add(const Phase phase, const uint64_t time){
+    nanoseconds[phase] += time;
+}
+
+void PhaseTimes::addWindows(const uint64_t computedWindows){
+    windows += computedWindows;
+}
+
+void PhaseTimes::addBytes(const uint64_t writtenBytes){
+    bytes += writtenBytes;
+}
+
+uint64_t PhaseTimes::now(){
+    return chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+string PhaseTimes::getPhaseName(const Phase phase){
+    const char* names[] = {"load", "pixels", "glcm", "features", "reformat",
+                           "textWrite", "npyWrite", "imageEncoding", "cache"};
+    return names[phase];
+}
+
+uint64_t PhaseTimes::getTotalNanoseconds() const{
+    uint64_t total = 0;
+    for (int i = 0; i < NUMBER_OF_PHASES; ++i) {
+        total += nanoseconds[i];
+    }
+    return total;
+}
+
+void PhaseTimes::print(ostream& out, const double wallSeconds) const{
+    uint64_t total = getTotalNanoseconds();
+    out << endl << "* Time of each phase (summed over the threads) *" << endl;
+    for (int i = 0; i < NUMBER_OF_PHASES; ++i) {
+        if(nanoseconds[i] == 0)
+            continue;
+        double share = 100.0 * nanoseconds[i] / total;
+        out << "\t" << left << setw(16) << getPhaseName((Phase) i) << right
+            << fixed << setprecision(3) << setw(12) << nanoseconds[i] / 1e9 << " s"
+            << setprecision(1) << setw(8) << share << " %" << endl;
+    }
+    out.unsetf(ios::floatfield);
+    out << setprecision(6);
+    out << "- Windows computed: " << windows;
+    if(wallSeconds > 0)
+        out << " (" << windows / wallSeconds << " windows/s)";
+    out << endl << "- Bytes written: " << bytes;
+    uint64_t writeNanoseconds = nanoseconds[TEXT_WRITE_PHASE]
+            + nanoseconds[NPY_WRITE_PHASE] + nanoseconds[IMAGE_ENCODING_PHASE];
+    if(writeNanoseconds > 0)
+        out << " (" << bytes / (writeNanoseconds / 1e9) / (1024 * 1024)
+            << " MB/s while writing)";
+    out << endl;
+}
+
+void PhaseTimes::writeJson(ostream& out, const double wallSeconds) const{
+    out << "  \"wallSeconds\": " << wallSeconds << "," << endl;
+    out << "  \"windows\": " << windows << "," << endl;
+    out << "  \"windowsPerSecond\": " << ((wallSeconds > 0) ? windows / wallSeconds : 0)
+        << "," << endl;
+    out << "  \"bytesWritten\": " << bytes << "," << endl;
+    out << "  \"phases\": {";
+    for (int i = 0; i < NUMBER_OF_PHASES; ++i) {
+        out << ((i > 0) ? "," : "") << endl << "    \""
+            << getPhaseName((Phase) i) << "\": " << nanoseconds[i] / 1e9;
+    }
+    out << endl << "  }";
+}
@@ -0,0 +1,140 @@
+#ifndef FEATUREEXTRACTOR_PHASETIMES_H
+#define FEATUREEXTRACTOR_PHASETIMES_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+/**
+ * Phases of the computation whose time is measured
+ */
+enum Phase {
+    /**
+     * Decoding of the image files
+     */
+    LOAD_PHASE,
+    /**
+     * Copy of the pixels in the gray levels used by the windows; borders
+     * and quantization are applied in the same pass
+     */
+    PIXELS_PHASE,
+    /**
+     * Pairs of pixels of the windows, and their aggregated representations
+     */
+    GLCM_PHASE,
+    /**
+     * Features extracted from the glcm of the windows
+     */
+    FEATURES_PHASE,
+    /**
+     * Conversion of the planes of values into 8 bit images
+     */
+    REFORMAT_PHASE,
+    TEXT_WRITE_PHASE,
+    NPY_WRITE_PHASE,
+    IMAGE_ENCODING_PHASE,
+    /**
+     * Results read from and stored in the cache (--cache-dir)
+     */
+    CACHE_PHASE,
+    NUMBER_OF_PHASES
+};
+
+/**
+ * Time spent in each phase, windows computed and bytes written by a run.
+ * Phases overlap when they run on many threads: their times are the sum of
+ * the times of all the threads. Every method can be called concurrently
+ */
+class PhaseTimes {
+public:
+    PhaseTimes();
+    /**
+     * Add the time of some work
+     * @param phase: phase of the work
+     * @param nanoseconds: time spent by the work
+     */
+    void add(Phase phase, uint64_t nanoseconds);
+    /**
+     * Add computed windows
+     * @param windows: how many were computed
+     */
+    void addWindows(uint64_t windows);
+    /**
+     * Add written bytes
+     * @param bytes: how many bytes were written in the files of the results
+     */
+    void addBytes(uint64_t bytes);
+    /**
+     * Print the times of the phases, the computed windows per second and
+     * the written bytes
+     * @param out: where to print
+     * @param wallSeconds: duration of the whole run
+     */
+    void print(ostream& out, double wallSeconds) const;
+    /**
+     * Write the same values of print as the members of a JSON object,
+     * without its braces
+     * @param out: where to write
+     * @param wallSeconds: duration of the whole run
+     */
+    void writeJson(ostream& out, double wallSeconds) const;
+    /**
+     * Utility method
+     * @return nanoseconds of a monotonic clock
+     */
+    static uint64_t now();
+    /**
+     * Utility method
+     * @param phase
+     * @return name of the phase in the reports
+     */
+    static string getPhaseName(Phase phase);
+
+private:
+    atomic<uint64_t> nanoseconds[NUMBER_OF_PHASES];
+    atomic<uint64_t> windows;
+    atomic<uint64_t> bytes;
+
+    /**
+     * Sum of the times of all the phases
+     */
+    uint64_t getTotalNanoseconds() const;
+};
+
+/**
+ * Adds to a phase the time from its creation to its destruction; it does
+ * nothing without PhaseTimes
+ */
+class PhaseTimer {
+public:
+    /**
+     * Start measuring
+     * @param phaseTimes: where the time is added; NULL when not measured
+     * @param phase: phase of the work measured
+     */
+    PhaseTimer(PhaseTimes* phaseTimes, Phase phase): phaseTimes(phaseTimes),
+            phase(phase), start((phaseTimes != NULL) ? PhaseTimes::now() : 0){};
+    ~PhaseTimer(){
+        stop();
+    };
+    /**
+     * Add the time measured so far, before the destruction; nothing more is
+     * added later
+     */
+    void stop(){
+        if(phaseTimes != NULL)
+            phaseTimes->add(phase, PhaseTimes::now() - start);
+        phaseTimes = NULL;
+    };
+
+private:
+    PhaseTimes* phaseTimes;
+    Phase phase;
+    uint64_t start;
+};
+
+
+#endif //FEATUREEXTRACTOR_PHASETIMES_H
@@ -1,14 +1,153 @@
 #include "ProgramArguments.h"
 
+/**
+ * Codes of the options that can only be given in the long form
+ */
+enum LongOnlyOptions {
+    BAND_ROWS_OPTION = 256,
+    FORMAT_OPTION,
+    PRECISION_OPTION,
+    TEXT_LAYOUT_OPTION,
+    PIPELINE_OPTION,
+    VOLUME_OPTION,
+    BATCH_OPTION,
+    CACHE_DIR_OPTION,
+    CACHE_SIZE_OPTION,
+    RESUME_OPTION,
+    SERVE_OPTION,
+    REPORT_OPTION,
+    PERF_OPTION,
+    MEM_BUDGET_OPTION,
+    PROGRESS_OPTION,
+    PROGRESS_FILE_OPTION,
+    NO_STRETCH_OPTION,
+    IMAGE_DEPTH_OPTION
+};
+
+/**
+ * Long form of the options
+ */
+static const struct option longOptions[] = {
+        {"band-rows", required_argument, NULL, BAND_ROWS_OPTION},
+        {"format", required_argument, NULL, FORMAT_OPTION},
+        {"precision", required_argument, NULL, PRECISION_OPTION},
+        {"text-layout", required_argument, NULL, TEXT_LAYOUT_OPTION},
+        {"pipeline", required_argument, NULL, PIPELINE_OPTION},
+        {"3d", no_argument, NULL, VOLUME_OPTION},
+        {"batch", required_argument, NULL, BATCH_OPTION},
+        {"cache-dir", required_argument, NULL, CACHE_DIR_OPTION},
+        {"cache-size", required_argument, NULL, CACHE_SIZE_OPTION},
+        {"resume", no_argument, NULL, RESUME_OPTION},
+        {"serve", required_argument, NULL, SERVE_OPTION},
+        {"report", required_argument, NULL, REPORT_OPTION},
+        {"perf", no_argument, NULL, PERF_OPTION},
+        {"mem-budget", required_argument, NULL, MEM_BUDGET_OPTION},
+        {"progress", no_argument, NULL, PROGRESS_OPTION},
+        {"progress-file", required_argument, NULL, PROGRESS_FILE_OPTION},
+        {"no-stretch", no_argument, NULL, NO_STRETCH_OPTION},
+        {"image-depth", required_argument, NULL, IMAGE_DEPTH_OPTION},
+        {NULL, 0, NULL, 0}
+};
+
+GLCMParameters ProgramArguments::getGLCMParameters() const{
+    GLCMParameters parameters = {windowSize, distance, directionType,
+            symmetric, borderType, quantitize, quantitizationMax};
+    return parameters;
+}
+
 /**
  * Show a visual helper to the user on how to use the tool
  */
 void ProgramArguments::printProgramUsage(){
-    cout << endl << "Usage: FeatureExtractor [<-s>] [<-d distance>] [<-w windowSize>] [<-t directionType>] "
-                    "[<-b borderType>] [<-g>][- i imagePath] [<-o outputFolder>] [<-r maximumGrayLevel>]" << endl;
+    cout << endl << "Usage: FeatureExtractor [<-s>] [<-d distance>] [<-w windowSize[,windowSize...]>] [<-t directionType>] "
+                    "[<-b borderType>] [<-g>][- i imagePath] [<-o outputFolder>] [<-r maximumGrayLevel>] "
+                    "[<-j numberOfThreads>] [<--band-rows rows>] [<--format text,npy>] "
+                    "[<--precision digits>] [<--text-layout line|rows>] [<--pipeline depth>] [<--3d>] [<--batch listOrFolder>] "
+                    "[<--cache-dir folder>] [<--cache-size bytes[K|M|G]>] [<--resume>] "
+                    "[<--serve socketPath>] [<--report report.json>] [<--perf>] "
+                    "[<--mem-budget bytes[K|M|G]|auto>] [<--progress>] "
+                    "[<--progress-file progress.json>] [<--no-stretch>] "
+                    "[<--image-depth 8|16|32>]" << endl;
     exit(2);
 }
 
+/**
+ * Select the formats of the files where feature values will be saved
+ * @param formats: comma separated list of "text" and "npy"
+ * @param progArg: where the formats will be selected
+ */
+void ProgramArguments::parseOutputFormats(const string& formats, ProgramArguments& progArg){
+    progArg.textOutput = false;
+    progArg.npyOutput = false;
+    size_t start = 0;
+    while(start <= formats.size()){
+        size_t end = formats.find(',', start);
+        if(end == string::npos)
+            end = formats.size();
+        string format = formats.substr(start, end - start);
+        if(format == "text")
+            progArg.textOutput = true;
+        else if(format == "npy")
+            progArg.npyOutput = true;
+        else{
+            cerr << "ERROR! Unknown output format (--format): " << format
+                 << "; supported formats are text and npy" << endl;
+            printProgramUsage();
+        }
+        start = end + 1;
+    }
+}
+
+/**
+ * Load the sides of the windows to compute
+ * @param sizes: comma separated list of sides, each between 2 and 10000
+ * @param progArg: where the sides will be put, sorted and without repetitions
+ */
+void ProgramArguments::parseWindowSizes(const string& sizes, ProgramArguments& progArg){
+    progArg.windowSizes.clear();
+    size_t start = 0;
+    while(start <= sizes.size()){
+        size_t end = sizes.find(',', start);
+        if(end == string::npos)
+            end = sizes.size();
+        int windowSize = atoi(sizes.substr(start, end - start).c_str());
+        if ((windowSize < 2) || (windowSize > 10000)) {
+            cerr << "ERROR ! The size of the sub-windows to be extracted option (-w) "
+                    "must have a value between 2 and 10000";
+            printProgramUsage();
+        }
+        progArg.windowSizes.push_back(windowSize);
+        start = end + 1;
+    }
+    sort(progArg.windowSizes.begin(), progArg.windowSizes.end());
+    progArg.windowSizes.erase(unique(progArg.windowSizes.begin(),
+            progArg.windowSizes.end()), progArg.windowSizes.end());
+    // The largest window decides the borders of the image
+    progArg.windowSize = progArg.windowSizes.back();
+}
+
+/**
+ * Load a size in bytes
+ * @param size: number of bytes, optionally followed by K, M or G
+ * @return the bytes; 0 if the size is not valid
+ */
+unsigned long long ProgramArguments::parseByteSize(const string& size){
+    char* end;
+    unsigned long long bytes = strtoull(size.c_str(), &end, 10);
+    if(end == size.c_str())
+        return 0;
+    string unit = end;
+    if((unit == "K") || (unit == "k"))
+        bytes <<= 10;
+    else if((unit == "M") || (unit == "m"))
+        bytes <<= 20;
+    else if((unit == "G") || (unit == "g"))
+        bytes <<= 30;
+    else if(!unit.empty())
+        return 0;
+    return bytes;
+}
+
 /**
  * Function that checks and load into the class ProgramArgument the option
  * given by the user
@@ -19,7 +158,8 @@ void ProgramArguments::printProgramUsage(){
 ProgramArguments ProgramArguments::checkOptions(int argc, char* argv[]){
     ProgramArguments progArg;
     int opt;
-    while((opt = getopt(argc, argv, "gsw:d:n:hct:vo:i:r:b:")) != -1){
+    while((opt = getopt_long(argc, argv, "gsw:d:n:hct:vo:i:r:b:j:",
+            longOptions, NULL)) != -1){
         switch (opt){
             case 'b':{
                 // Choose between no, zero or symmetric padding
@@ -66,6 +206,162 @@ ProgramArguments ProgramArguments::checkOptions(int argc, char* argv[]){
                 progArg.verbose = true;
                 break;
             }
+            case 'j':{
+                // How many threads will compute the windows; 0 = all cores
+                int threads = atoi(optarg);
+                if((threads < 0) || (threads > 1024)){
+                    cerr << "ERROR ! The number of threads (-j) must be a value "
+                            "between 0 (all cores) and 1024" << endl;
+                    printProgramUsage();
+                }
+                progArg.numberOfThreads = threads;
+                break;
+            }
+            case BAND_ROWS_OPTION:{
+                // Compute and save the image a band of rows at a time
+                long bandRows = atol(optarg);
+                if((bandRows < 1) || (bandRows > INT_MAX)){
+                    cerr << "ERROR ! The rows of each band (--band-rows) "
+                            "must be a value >= 1" << endl;
+                    printProgramUsage();
+                }
+                progArg.bandRows = bandRows;
+                break;
+            }
+            case FORMAT_OPTION:{
+                // Which files will contain the feature values
+                parseOutputFormats(optarg, progArg);
+                break;
+            }
+            case PRECISION_OPTION:{
+                // Significant digits of the values in the text files
+                int precision = atoi(optarg);
+                if((precision < 1) || (precision > 17)){
+                    cerr << "ERROR ! The precision of the text values (--precision) "
+                            "must be a value between 1 and 17" << endl;
+                    printProgramUsage();
+                }
+                progArg.textPrecision = precision;
+                break;
+            }
+            case TEXT_LAYOUT_OPTION:{
+                // All the values on one line or a line for each row of windows
+                string layout = optarg;
+                if(layout == "line")
+                    progArg.textRowLayout = false;
+                else if(layout == "rows")
+                    progArg.textRowLayout = true;
+                else{
+                    cerr << "ERROR ! The layout of the text files (--text-layout) "
+                            "must be line or rows" << endl;
+                    printProgramUsage();
+                }
+                break;
+            }
+            case PIPELINE_OPTION:{
+                // Save the computed bands in background threads
+                int depth = atoi(optarg);
+                if((depth < 1) || (depth > 1024)){
+                    cerr << "ERROR ! The bands waiting to be saved (--pipeline) "
+                            "must be a value between 1 and 1024" << endl;
+                    printProgramUsage();
+                }
+                progArg.pipelineDepth = depth;
+                break;
+            }
+            case VOLUME_OPTION:{
+                // The slices of the stack are a volume with cubic windows
+                progArg.volumetric = true;
+                break;
+            }
+            case BATCH_OPTION:{
+                // Many images processed by this run
+                progArg.batchPath = optarg;
+                break;
+            }
+            case CACHE_DIR_OPTION:{
+                // Keep the results for the next runs
+                progArg.cacheFolder = optarg;
+                break;
+            }
+            case CACHE_SIZE_OPTION:{
+                unsigned long long cacheSize = parseByteSize(optarg);
+                if(cacheSize == 0){
+                    cerr << "ERROR ! The size of the cache (--cache-size) must be "
+                            "a number of bytes > 0, optionally followed by K, M or G" << endl;
+                    printProgramUsage();
+                }
+                progArg.cacheSize = cacheSize;
+                break;
+            }
+            case RESUME_OPTION:{
+                // Continue from the checkpoint of a previous run
+                progArg.resume = true;
+                break;
+            }
+            case SERVE_OPTION:{
+                // Server of local clients, or client of a server
+                progArg.servePath = optarg;
+                break;
+            }
+            case REPORT_OPTION:{
+                // Time of each phase of the computation
+                progArg.reportPath = optarg;
+                break;
+            }
+            case PERF_OPTION:{
+                // Hardware events of the windows
+                progArg.perfCounters = true;
+                break;
+            }
+            case MEM_BUDGET_OPTION:{
+                // Memory that the computation can use
+                string budget = optarg;
+                if(budget == "auto"){
+                    // What the system, or the cgroup of the job, has left
+                    progArg.memoryBudget = Utils::getAvailableMemory();
+                    if(progArg.memoryBudget == 0){
+                        cerr << "ERROR ! The available memory can't be read; "
+                                "give the budget (--mem-budget) in bytes" << endl;
+                        printProgramUsage();
+                    }
+                    break;
+                }
+                progArg.memoryBudget = parseByteSize(budget);
+                if(progArg.memoryBudget == 0){
+                    cerr << "ERROR ! The memory budget (--mem-budget) must be a "
+                            "number of bytes > 0, optionally followed by K, M or G, "
+                            "or auto" << endl;
+                    printProgramUsage();
+                }
+                break;
+            }
+            case PROGRESS_OPTION:{
+                // Progress of the windows printed while computing
+                progArg.progress = true;
+                break;
+            }
+            case PROGRESS_FILE_OPTION:{
+                // Progress of the windows written while computing
+                progArg.progressPath = optarg;
+                break;
+            }
+            case NO_STRETCH_OPTION:{
+                // Feature images with the contrast of the values
+                progArg.stretchImages = false;
+                break;
+            }
+            case IMAGE_DEPTH_OPTION:{
+                // 8/16 bit PNG or float TIFF feature images
+                int depth = atoi(optarg);
+                if((depth != 8) && (depth != 16) && (depth != 32)){
+                    cerr << "ERROR ! The bits of each pixel of the feature images "
+                            "(--image-depth) must be 8, 16 or 32" << endl;
+                    printProgramUsage();
+                }
+                progArg.imageDepth = depth;
+                break;
+            }
             case 'd': {
                 int distance = atoi(optarg);
                 if (distance < 1) {
@@ -77,21 +373,16 @@ ProgramArguments ProgramArguments::checkOptions(int argc, char* argv[]){
             }
             case 'w': {
                 // Decide what the size of each sub-window of the image will be
-                short int windowSize = atoi(optarg);
-                if ((windowSize < 2) || (windowSize > 10000)) {
-                    cerr << "ERROR ! The size of the sub-windows to be extracted option (-w) "
-                            "must have a value between 2 and 10000";
-                    printProgramUsage();
-                }
-                progArg.windowSize = windowSize;
+                parseWindowSizes(optarg, progArg);
                 break;
             }
             case 't':{
-                // Decide how many of the 4 directions will be computed
+                // Decide which of the 4 (13 in volumes) directions will be computed
                 short int dirType = atoi(optarg);
-                if(dirType > 4 || dirType <1){
+                if(dirType > Direction::VOLUME_DIRECTIONS || dirType <1){
                     cerr << "ERROR ! The type of directions to be computed "
-                            "option (-t) must be a value between 1 and 4" << endl;
+                            "option (-t) must be a value between 1 and 4 "
+                            "(13 with --3d)" << endl;
                     printProgramUsage();
                 }
                 progArg.directionType = dirType;
@@ -122,11 +413,90 @@ ProgramArguments ProgramArguments::checkOptions(int argc, char* argv[]){
 
     }
 
-    if(progArg.distance > progArg.windowSize){
+    // The directions across the slices exist only in volumes
+    if((!progArg.volumetric) && (progArg.directionType > Direction::PLANE_DIRECTIONS)){
+        cerr << "ERROR ! Directions from 5 to 13 (-t) can only be computed "
+                "in volumes (--3d)" << endl;
+        printProgramUsage();
+    }
+
+    // Only the bands of an image have checkpoints
+    if(progArg.resume && ((progArg.bandRows == 0) || progArg.volumetric
+        || !progArg.batchPath.empty() || (progArg.windowSizes.size() > 1))){
+        cerr << "ERROR! Only images computed by bands (--band-rows) can be "
+                "resumed (--resume)" << endl;
+        printProgramUsage();
+    }
+
+    if((progArg.windowSizes.size() > 1) && (progArg.volumetric || !progArg.batchPath.empty())){
+        cerr << "ERROR! Many window sizes (-w) can only be computed for "
+                "single images" << endl;
+        printProgramUsage();
+    }
+
+    // Every window must have at least a pair
+    short int smallestWindow = progArg.windowSizes.empty() ?
+            progArg.windowSize : progArg.windowSizes.front();
+    if(progArg.distance > smallestWindow){
         cout << "WARNING: distance can't be > of each window size; distance value corrected to 1" << endl;
         progArg.distance = 1;
     }
 
+    // Only the windows of plane images are counted one by one
+    if(progArg.perfCounters && (progArg.volumetric || (progArg.windowSizes.size() > 1))){
+        cerr << "ERROR! The hardware counters (--perf) can't be used with "
+                "volumes (--3d) or many window sizes (-w)" << endl;
+        printProgramUsage();
+    }
+
+    // Only the bands of single images can be fitted in the budget
+    if((progArg.memoryBudget > 0) && (progArg.volumetric || (progArg.windowSizes.size() > 1)
+        || !progArg.batchPath.empty() || !progArg.servePath.empty())){
+        cerr << "ERROR! The memory budget (--mem-budget) can only be planned for "
+                "single images; not for volumes (--3d), many window sizes (-w), "
+                "batches (--batch) or the server (--serve)" << endl;
+        printProgramUsage();
+    }
+
+    if(!progArg.servePath.empty()){
+        if(progArg.volumetric || (progArg.windowSizes.size() > 1)
+            || (progArg.bandRows > 0) || progArg.resume){
+            cerr << "ERROR! Only whole images with a single window size can be "
+                    "computed by the server (--serve)" << endl;
+            printProgramUsage();
+        }
+        if(!progArg.reportPath.empty() || progArg.perfCounters
+            || progArg.progress || !progArg.progressPath.empty()){
+            cerr << "ERROR! The server (--serve) prints the time of each job; "
+                    "--report, --perf, --progress and --progress-file can't be "
+                    "used with it" << endl;
+            printProgramUsage();
+        }
+        // The server waits for the images of the clients
+        if(progArg.imagePath.empty() && progArg.batchPath.empty())
+            return progArg;
+    }
+
+    if(!progArg.batchPath.empty()){
+        // The images come from the batch
+        if(!progArg.imagePath.empty()) {
+            cerr << "ERROR! -i and --batch can't be used together" << endl;
+            printProgramUsage();
+        }
+        if(progArg.volumetric) {
+            cerr << "ERROR! Volumes (--3d) can't be processed in batch mode" << endl;
+            printProgramUsage();
+        }
+        if(progArg.outputFolder.empty()){
+            // Named after the list or the folder
+            string batchName = progArg.batchPath;
+            while((batchName.size() > 1) && (batchName[batchName.size() - 1] == '/'))
+                batchName.erase(batchName.size() - 1);
+            progArg.outputFolder = Utils::removeExtension(Utils::basename(batchName));
+        }
+        return progArg;
+    }
+
     // No image provided
     if(progArg.imagePath.empty()) {
         cerr << "ERROR! Missing image path!" << endl;
@@ -4,8 +4,12 @@
 #include <string>
 #include <iostream>
 #include <getopt.h> // For options check
+#include <climits>
+#include <vector>
 
 #include "Utils.h"
+#include "Direction.h"
+#include "GLCMParameters.h"
 
 using namespace std;
 
@@ -18,6 +22,11 @@ public:
      * Side of each squared window that will be generated
      */
     short int windowSize;
+    /**
+     * Sides of the windows, in increasing order, when many are computed
+     * together; windowSize is the largest
+     */
+    vector<short int> windowSizes;
     /**
      *  Optional reduction of gray levels to range [0,Max]
      */
@@ -43,7 +52,8 @@ public:
      */
     short int distance;
     /**
-     * Which direction to compute between 0°, 45°, 90°, 135°
+     * Which direction to compute between 0°, 45°, 90°, 135°; in volumes
+     * also the 9 directions across the slices
      */
     short int directionType;
     /**
@@ -68,6 +78,106 @@ public:
      * Print additional information
      */
     bool verbose;
+    /**
+     * How many threads will compute the windows of the image; 0 means as
+     * many as the cores of the machine
+     */
+    short int numberOfThreads;
+    /**
+     * How many rows of windows are computed and saved at each step; the
+     * memory used is bounded by the size of each band.
+     * 0 means that the whole image is computed at once
+     */
+    int bandRows;
+    /**
+     * Save the feature values as comma separated text files
+     */
+    bool textOutput;
+    /**
+     * Save the feature values as binary NumPy .npy files
+     */
+    bool npyOutput;
+    /**
+     * Significant digits of each value saved in the text files
+     */
+    short int textPrecision;
+    /**
+     * Save each row of windows on its own line of the text files, instead
+     * of all the values on a single line
+     */
+    bool textRowLayout;
+    /**
+     * How many computed bands can wait to be saved while the next one is
+     * computed; 0 means that computing and saving don't overlap
+     */
+    int pipelineDepth;
+    /**
+     * Process the slices of a stack as a volume, with cubic windows and
+     * the 13 directions of the space
+     */
+    bool volumetric;
+    /**
+     * Folder of images or text file with a list of images that are all
+     * processed by this run, each with its own output folder
+     */
+    string batchPath;
+    /**
+     * Folder where the computed features are kept for the next runs with the
+     * same image and parameters; empty means no cache
+     */
+    string cacheFolder;
+    /**
+     * Bytes of the cache above which the least recently used results are
+     * deleted
+     */
+    unsigned long long cacheSize;
+    /**
+     * Continue a computation by bands from the checkpoint left in the
+     * output folder by a previous run
+     */
+    bool resume;
+    /**
+     * Unix domain socket of the server (--serve): FeatureExtractor listens
+     * on it, FeatureClient sends its images to it; empty if not used
+     */
+    string servePath;
+    /**
+     * JSON file where the time of each phase of the computation, the
+     * windows computed per second and the bytes written are saved; empty
+     * if not measured
+     */
+    string reportPath;
+    /**
+     * Count the hardware events (cycles, instructions, cache and branch
+     * misses) of the windows
+     */
+    bool perfCounters;
+    /**
+     * Bytes of memory that the computation of an image can use: the
+     * threads, the rows of each band and the bands waiting to be saved are
+     * chosen to fit in them. 0 means that the memory is not planned
+     */
+    unsigned long long memoryBudget;
+    /**
+     * Print the percentage of the windows computed, the windows per second
+     * and the time to the end on stderr while computing
+     */
+    bool progress;
+    /**
+     * JSON file rewritten with the same progress while computing; empty if
+     * not written
+     */
+    string progressPath;
+    /**
+     * Enhance the contrast of the feature images (CLAHE)
+     */
+    bool stretchImages;
+    /**
+     * Bits of each pixel of the feature images: 8 or 16 for PNG images
+     * spread on all the gray levels, 32 for TIFF images with the values as
+     * floats
+     */
+    short int imageDepth;
 
     /**
      * Constructor of the class that embeds all the parameters of the problem
@@ -82,6 +192,24 @@ public:
      * @param border: type of border applied to the orginal image
      * @param verbose: print additional info
      * @param outFolder: where to put results
+     * @param threads: how many threads will compute the windows
+     * @param bandRows: rows of windows computed and saved at each step;
+     * 0 for the whole image at once
+     * @param textOutput: save the feature values as text files
+     * @param npyOutput: save the feature values as .npy files
+     * @param textPrecision: significant digits of each value in text files
+     * @param textRowLayout: each row of windows on its own line of text
+     * @param pipelineDepth: computed bands that can wait to be saved;
+     * 0 for saving each band before computing the next
+     * @param volumetric: the slices of a stack are a volume
+     * @param cacheSize: bytes of the cache of the results
+     * @param resume: continue from the checkpoint of a previous run
+     * @param perfCounters: count the hardware events of the windows
+     * @param memoryBudget: bytes of memory that the computation can use;
+     * 0 for not planning it
+     * @param progress: print the progress on stderr while computing
+     * @param stretchImages: enhance the contrast of the feature images
+     * @param imageDepth: bits of each pixel of the feature images
      */
     ProgramArguments(short int windowSize = 4,
                      bool quantitize = false,
@@ -92,11 +220,38 @@ public:
                      bool createImages = false,
                      short int border = 1,
                      bool verbose = false,
-                     string outFolder = "")
+                     string outFolder = "",
+                     short int threads = 1,
+                     int bandRows = 0,
+                     bool textOutput = true,
+                     bool npyOutput = false,
+                     short int textPrecision = 6,
+                     bool textRowLayout = false,
+                     int pipelineDepth = 0,
+                     bool volumetric = false,
+                     unsigned long long cacheSize = 1ull << 30,
+                     bool resume = false,
+                     bool perfCounters = false,
+                     unsigned long long memoryBudget = 0,
+                     bool progress = false,
+                     bool stretchImages = true,
+                     short int imageDepth = 8)
             : windowSize(windowSize), borderType(border), quantitize(quantitize), symmetric(symmetric), distance(distance),
               directionType(dirType), directionsNumber(dirNumber),
               createImages(createImages), outputFolder(outFolder),
-              verbose(verbose){};
+              verbose(verbose), numberOfThreads(threads), bandRows(bandRows),
+              textOutput(textOutput), npyOutput(npyOutput),
+              textPrecision(textPrecision), textRowLayout(textRowLayout),
+              pipelineDepth(pipelineDepth), volumetric(volumetric),
+              cacheSize(cacheSize), resume(resume), perfCounters(perfCounters),
+              memoryBudget(memoryBudget), progress(progress),
+              stretchImages(stretchImages), imageDepth(imageDepth){};
+    /**
+     * Utility method
+     * @return the options that decide the values of the features, in the
+     * form used by the glcmfeatures library
+     */
+    GLCMParameters getGLCMParameters() const;
     /**
      * Show the user how to use the program and its options
      */
@@ -108,6 +263,25 @@ public:
      * @return
      */
     static ProgramArguments checkOptions(int argc, char* argv[]);
+private:
+    /**
+     * Load the comma separated list of output formats given with --format
+     * @param formats: list of formats among "text" and "npy"
+     * @param progArg: where the formats will be selected
+     */
+    static void parseOutputFormats(const string& formats, ProgramArguments& progArg);
+    /**
+     * Load the comma separated list of window sides given with -w
+     * @param sizes: list of sides, each between 2 and 10000
+     * @param progArg: where the sides will be put
+     */
+    static void parseWindowSizes(const string& sizes, ProgramArguments& progArg);
+    /**
+     * Load a size in bytes given with --cache-size
+     * @param size: number of bytes, optionally followed by K, M or G
+     * @return the bytes; 0 if the size is not valid
+     */
+    static unsigned long long parseByteSize(const string& size);
 };
 
 
@@ -0,0 +1,144 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+#include "ProgressReporter.h"
+#include "PhaseTimes.h"
+
+/* Weight of the speed of the last interval in the smoothed speed; the
+ * estimated time follows changes of speed without jumping at each report */
+#define SPEED_SMOOTHING 0.3
+
+ProgressReporter::ProgressReporter(const bool printed, const string& filePath,
+        const double intervalSeconds): printed(printed), filePath(filePath),
+        intervalSeconds(intervalSeconds), computedWindows(0), totalWindows(0),
+        stopping(false), terminal(isatty(STDERR_FILENO)), startNanoseconds(0),
+        lastWindows(0), lastNanoseconds(0), windowsPerSecond(0){
+}
+
+ProgressReporter::~ProgressReporter(){
+    stop();
+}
+
+void ProgressReporter::start(){
+    startNanoseconds = PhaseTimes::now();
+    lastNanoseconds = startNanoseconds;
+    lastWindows = computedWindows.load(memory_order_relaxed);
+    stopping = false;
+    reporter = thread(&ProgressReporter::run, this);
+}
+
+void ProgressReporter::stop(){
+    if(!reporter.joinable())
+        return;
+    {
+        lock_guard<mutex> lock(reporterLock);
+        stopping = true;
+    }
+    stopRequested.notify_one();
+    reporter.join();
+    report(true);
+}
+
+void ProgressReporter::addTotalWindows(const uint64_t windows){
+    totalWindows.fetch_add(windows, memory_order_relaxed);
+}
+
+void ProgressReporter::run(){
+    unique_lock<mutex> lock(reporterLock);
+    chrono::duration<double> interval(intervalSeconds);
+    while(!stopRequested.wait_for(lock, interval, [this]{ return stopping; })){
+        report(false);
+    }
+}
+
+void ProgressReporter::report(const bool finished){
+    uint64_t computed = computedWindows.load(memory_order_relaxed);
+    uint64_t total = totalWindows.load(memory_order_relaxed);
+    uint64_t now = PhaseTimes::now();
+    double elapsedSeconds = (now - startNanoseconds) / 1e9;
+
+    double intervalSpeed = (now > lastNanoseconds) ?
+            (computed - lastWindows) / ((now - lastNanoseconds) / 1e9) : 0;
+    if(lastWindows == 0)
+        windowsPerSecond = intervalSpeed;
+    else
+        windowsPerSecond = SPEED_SMOOTHING * intervalSpeed
+                + (1 - SPEED_SMOOTHING) * windowsPerSecond;
+    lastWindows = computed;
+    lastNanoseconds = now;
+    if(finished && (elapsedSeconds > 0))
+        windowsPerSecond = computed / elapsedSeconds;
+
+    // Unknown until the total and the speed are
+    double etaSeconds = -1;
+    if(finished)
+        etaSeconds = 0;
+    else if((total > 0) && (windowsPerSecond > 0))
+        etaSeconds = (computed < total) ? (total - computed) / windowsPerSecond : 0;
+
+    if(printed){
+        ostringstream line;
+        line << "Progress: ";
+        if(total > 0)
+            line << fixed << setprecision(1) << (100.0 * computed / total) << "% ("
+                 << computed << "/" << total << " windows)";
+        else
+            line << computed << " windows";
+        line << fixed << setprecision(0) << ", " << windowsPerSecond << " windows/s";
+        if(finished)
+            line << ", took " << formatTime(elapsedSeconds);
+        else if(etaSeconds >= 0)
+            line << ", ETA " << formatTime(etaSeconds);
+        // On terminals the line replaces the previous one
+        if(terminal)
+            cerr << "\r" << left << setw(80) << line.str() << (finished ? "\n" : "") << flush;
+        else
+            cerr << line.str() << endl;
+    }
+    if(!filePath.empty())
+        writeFile(computed, total, elapsedSeconds, etaSeconds, finished);
+}
+
+void ProgressReporter::writeFile(const uint64_t computed, const uint64_t total,
+        const double elapsedSeconds, const double etaSeconds,
+        const bool finished) const{
+    string temporaryPath = filePath + ".tmp";
+    ofstream file(temporaryPath.c_str());
+    if(!file){
+        cerr << "Couldn't write the progress to file: " << filePath << endl;
+        return;
+    }
+    file << fixed << setprecision(3) << "{" << endl;
+    file << "  \"computedWindows\": " << computed << "," << endl;
+    if(total > 0){
+        file << "  \"totalWindows\": " << total << "," << endl;
+        file << "  \"percent\": " << (100.0 * computed / total) << "," << endl;
+    }
+    else{
+        file << "  \"totalWindows\": null," << endl;
+        file << "  \"percent\": null," << endl;
+    }
+    file << "  \"windowsPerSecond\": " << windowsPerSecond << "," << endl;
+    file << "  \"elapsedSeconds\": " << elapsedSeconds << "," << endl;
+    if(etaSeconds >= 0)
+        file << "  \"etaSeconds\": " << etaSeconds << "," << endl;
+    else
+        file << "  \"etaSeconds\": null," << endl;
+    file << "  \"finished\": " << (finished ? "true" : "false") << endl;
+    file << "}" << endl;
+    file.close();
+    if(rename(temporaryPath.c_str(), filePath.c_str()) != 0)
+        cerr << "Couldn't write the progress to file: " << filePath << endl;
+}
+
+string ProgressReporter::formatTime(const double seconds){
+    long long wholeSeconds = (long long) (seconds + 0.5);
+    ostringstream text;
+    text << (wholeSeconds / 3600) << ":" << setfill('0') << setw(2)
+         << (wholeSeconds / 60 % 60) << ":" << setw(2) << (wholeSeconds % 60);
+    return text.str();
+}
@@ -0,0 +1,106 @@
+#ifndef FEATUREEXTRACTOR_PROGRESSREPORTER_H
+#define FEATUREEXTRACTOR_PROGRESSREPORTER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+/**
+ * Reports the progress of a long computation: percentage of the windows
+ * computed, windows per second and estimated time to the end. The workers
+ * only add their windows to a counter, without locks or system calls; a
+ * thread of its own wakes up at a low frequency and is the only one that
+ * prints to stderr or writes the progress file
+ */
+class ProgressReporter {
+public:
+    /**
+     * Initialize the class; nothing is reported before start()
+     * @param printed: print a line of progress on stderr
+     * @param filePath: JSON file rewritten at every report; empty for none
+     * @param intervalSeconds: time between two reports
+     */
+    ProgressReporter(bool printed, const string& filePath,
+            double intervalSeconds = 1);
+    ~ProgressReporter();
+    /**
+     * Start the thread that reports the progress
+     */
+    void start();
+    /**
+     * Stop the thread and make the last report, with the whole duration
+     */
+    void stop();
+    /**
+     * Add windows that will be computed; the percentage and the time to the
+     * end aren't known while there are none
+     * @param windows: how many windows will be computed
+     */
+    void addTotalWindows(uint64_t windows);
+    /**
+     * Add computed windows; it can be called by many threads at the same
+     * time and costs a single atomic addition
+     * @param windows: how many were computed
+     */
+    void addWindows(uint64_t windows){
+        computedWindows.fetch_add(windows, memory_order_relaxed);
+    };
+
+private:
+    bool printed;
+    string filePath;
+    double intervalSeconds;
+    atomic<uint64_t> computedWindows;
+    atomic<uint64_t> totalWindows;
+    /**
+     * Only the reporter thread and stop() use them
+     */
+    thread reporter;
+    mutex reporterLock;
+    condition_variable stopRequested;
+    bool stopping;
+    /**
+     * The lines are rewritten in place on terminals, appended otherwise
+     */
+    bool terminal;
+    uint64_t startNanoseconds;
+    /**
+     * Windows and time of the previous report, for the recent speed
+     */
+    uint64_t lastWindows;
+    uint64_t lastNanoseconds;
+    /**
+     * Windows per second, smoothed over the recent reports
+     */
+    double windowsPerSecond;
+
+    /**
+     * Body of the reporter thread
+     */
+    void run();
+    /**
+     * Print and write the actual progress
+     * @param finished: the computation is over
+     */
+    void report(bool finished);
+    /**
+     * Write the progress in the file, replacing it only once it is complete
+     * so that readers never see half of it
+     */
+    void writeFile(uint64_t computed, uint64_t total, double elapsedSeconds,
+            double etaSeconds, bool finished) const;
+    /**
+     * Utility method
+     * @param seconds
+     * @return the time as hours:minutes:seconds
+     */
+    static string formatTime(double seconds);
+};
+
+
+#endif //FEATUREEXTRACTOR_PROGRESSREPORTER_H
@@ -0,0 +1,21 @@
+#include "QuantizationTable.h"
+
+QuantizationTable::QuantizationTable(): maxGrayLevel(-1), quantizationMax(-1){
+}
+
+shared_ptr<const vector<unsigned int>> QuantizationTable::getLevels(
+        const int maxGrayLevel, const int quantizationMax){
+    lock_guard<mutex> lock(tableLock);
+    if((maxGrayLevel == this->maxGrayLevel) && (quantizationMax == this->quantizationMax))
+        return levels;
+
+    // Readers of the previous levels keep them until they are done
+    shared_ptr<vector<unsigned int>> table = make_shared<vector<unsigned int>>(maxGrayLevel + 1);
+    for (unsigned int intensity = 0; intensity <= (unsigned int) maxGrayLevel; ++intensity) {
+        (*table)[intensity] = intensity * quantizationMax / maxGrayLevel;
+    }
+    levels = table;
+    this->maxGrayLevel = maxGrayLevel;
+    this->quantizationMax = quantizationMax;
+    return levels;
+}
@@ -0,0 +1,40 @@
+#ifndef FEATUREEXTRACTOR_QUANTIZATIONTABLE_H
+#define FEATUREEXTRACTOR_QUANTIZATIONTABLE_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+
+using namespace std;
+
+/**
+ * Quantized level of every intensity of the pixels, built once and reused
+ * by all the images and bands read with the same gray levels, instead of
+ * filling up to 65536 levels at each read. Many threads can read with it at
+ * the same time: the levels handed out are never changed, a different
+ * quantization gets new ones
+ */
+class QuantizationTable {
+public:
+    QuantizationTable();
+    /**
+     * Levels of a quantization, built only when it differs from the last one
+     * @param maxGrayLevel: maximum intensity of the pixels read
+     * @param quantizationMax: maximum quantized level; <= maxGrayLevel
+     * @return the quantized level of each intensity in [0, maxGrayLevel]
+     */
+    shared_ptr<const vector<unsigned int>> getLevels(int maxGrayLevel,
+            int quantizationMax);
+
+private:
+    mutex tableLock;
+    shared_ptr<const vector<unsigned int>> levels;
+    /**
+     * Quantization of the actual levels; -1 before the first one
+     */
+    int maxGrayLevel;
+    int quantizationMax;
+};
+
+
+#endif //FEATUREEXTRACTOR_QUANTIZATIONTABLE_H
@@ -0,0 +1,166 @@
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <thread>
+#include <functional>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#include "ResultCache.h"
+#include "Utils.h"
+
+// Changes whenever the values or the layout of the entries change
+#define CACHE_MAGIC "GLCMRC01"
+#define CACHE_MAGIC_LENGTH 8
+#define CACHE_EXTENSION ".glcm"
+
+ResultCache::ResultCache(const string& folder, const uint64_t maxBytes)
+        : folder(folder), maxBytes(maxBytes){
+    Utils::createFolder(folder);
+}
+
+string ResultCache::computeKey(const ImageView& pixels, const ImageData& img,
+        const ProgramArguments& progArg){
+    uint64_t hash = Utils::HASH_OFFSET_BASIS;
+    hash = Utils::hashBytes(hash, CACHE_MAGIC, CACHE_MAGIC_LENGTH);
+    unsigned int dimensions[] = {img.getRows(), img.getColumns(),
+                                 img.getMaxGrayLevel()};
+    hash = Utils::hashBytes(hash, dimensions, sizeof(dimensions));
+    // Row after row, so the key of the same pixels doesn't depend on the stride
+    for (unsigned int i = 0; i < pixels.rows; ++i) {
+        hash = Utils::hashBytes(hash, pixels.pixels + i * pixels.stride,
+                pixels.columns * sizeof(unsigned int));
+    }
+
+    // Every parameter that changes the values of the features
+    int parameters[] = {progArg.distance, progArg.windowSize,
+                        progArg.directionType, progArg.symmetric,
+                        progArg.borderType, progArg.quantitize,
+                        progArg.quantitize ? progArg.quantitizationMax : 0};
+    hash = Utils::hashBytes(hash, parameters, sizeof(parameters));
+
+    return Utils::hashToString(hash);
+}
+
+string ResultCache::getEntryPath(const string& key) const{
+    return folder + "/" + key + CACHE_EXTENSION;
+}
+
+bool ResultCache::load(const string& key, FeaturePlanes& featurePlanes){
+    string entryPath = getEntryPath(key);
+    FILE* file = fopen(entryPath.c_str(), "rb");
+    if(file == NULL)
+        return false;
+
+    // The entry must have the planes that were allocated
+    char magic[CACHE_MAGIC_LENGTH];
+    int32_t dimensions[4];
+    int32_t expected[4] = {featurePlanes.getRows(), featurePlanes.getColumns(),
+                           featurePlanes.getNumberOfDirections(),
+                           Features::getSupportedFeaturesCount()};
+    bool valid = (fread(magic, 1, CACHE_MAGIC_LENGTH, file) == CACHE_MAGIC_LENGTH)
+            && (memcmp(magic, CACHE_MAGIC, CACHE_MAGIC_LENGTH) == 0)
+            && (fread(dimensions, sizeof(int32_t), 4, file) == 4)
+            && (memcmp(dimensions, expected, sizeof(expected)) == 0);
+
+    size_t planeSize = featurePlanes.getPlaneSize();
+    for (int f = 0; valid && (f < expected[3]); ++f) {
+        for (int d = 0; valid && (d < expected[2]); ++d) {
+            valid = (fread(featurePlanes.getPlane((FeatureNames) f, d),
+                    sizeof(double), planeSize, file) == planeSize);
+        }
+    }
+    fclose(file);
+
+    // Recently used entries are the last to be evicted
+    if(valid)
+        utime(entryPath.c_str(), NULL);
+    return valid;
+}
+
+void ResultCache::store(const string& key, const FeaturePlanes& featurePlanes){
+    /* Written with a temporary name and then renamed, so that other runs
+     * never read a partial entry */
+    string entryPath = getEntryPath(key);
+    string temporaryPath = entryPath + "." + to_string(getpid()) + "."
+            + to_string(hash<thread::id>()(this_thread::get_id())) + ".tmp";
+    FILE* file = fopen(temporaryPath.c_str(), "wb");
+    if(file == NULL){
+        cerr << "Couldn't save the features to the cache: " << temporaryPath << endl;
+        return;
+    }
+
+    int32_t dimensions[4] = {featurePlanes.getRows(), featurePlanes.getColumns(),
+                             featurePlanes.getNumberOfDirections(),
+                             Features::getSupportedFeaturesCount()};
+    bool written = (fwrite(CACHE_MAGIC, 1, CACHE_MAGIC_LENGTH, file) == CACHE_MAGIC_LENGTH)
+            && (fwrite(dimensions, sizeof(int32_t), 4, file) == 4);
+    size_t planeSize = featurePlanes.getPlaneSize();
+    for (int f = 0; written && (f < dimensions[3]); ++f) {
+        for (int d = 0; written && (d < dimensions[2]); ++d) {
+            written = (fwrite(featurePlanes.getPlane((FeatureNames) f, d),
+                    sizeof(double), planeSize, file) == planeSize);
+        }
+    }
+    written = (fclose(file) == 0) && written;
+
+    if(!written || (rename(temporaryPath.c_str(), entryPath.c_str()) != 0)){
+        cerr << "Couldn't save the features to the cache: " << entryPath << endl;
+        remove(temporaryPath.c_str());
+        return;
+    }
+    evict();
+}
+
+/**
+ * Entry of the cache, for choosing the ones to delete
+ */
+struct CacheEntry {
+    string path;
+    uint64_t size;
+    /**
+     * Nanoseconds of the last modification, written by each use
+     */
+    int64_t lastUse;
+};
+
+void ResultCache::evict(){
+    lock_guard<mutex> lock(evictionLock);
+    DIR* cacheFolder = opendir(folder.c_str());
+    if(cacheFolder == NULL)
+        return;
+
+    vector<CacheEntry> entries;
+    uint64_t totalSize = 0;
+    size_t extensionLength = strlen(CACHE_EXTENSION);
+    struct dirent* item;
+    while((item = readdir(cacheFolder)) != NULL){
+        string name = item->d_name;
+        if((name.size() <= extensionLength) ||
+           (name.compare(name.size() - extensionLength, extensionLength, CACHE_EXTENSION) != 0))
+            continue;
+        CacheEntry entry;
+        entry.path = folder + "/" + name;
+        struct stat info;
+        // Another run could have deleted it meanwhile
+        if(stat(entry.path.c_str(), &info) != 0)
+            continue;
+        entry.size = info.st_size;
+        entry.lastUse = (int64_t) info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+        entries.push_back(entry);
+        totalSize += entry.size;
+    }
+    closedir(cacheFolder);
+
+    // Least recently used first
+    sort(entries.begin(), entries.end(), [](const CacheEntry& a, const CacheEntry& b){
+        return a.lastUse < b.lastUse;
+    });
+    for (size_t i = 0; (i < entries.size()) && (totalSize > maxBytes); ++i) {
+        if((remove(entries[i].path.c_str()) == 0) || (errno == ENOENT))
+            totalSize -= entries[i].size;
+    }
+}
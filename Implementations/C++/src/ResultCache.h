@@ -0,0 +1,77 @@
+#ifndef FEATUREEXTRACTOR_RESULTCACHE_H
+#define FEATUREEXTRACTOR_RESULTCACHE_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include "FeaturePlanes.h"
+#include "ProgramArguments.h"
+#include "Image.h"
+#include "ImageData.h"
+
+using namespace std;
+
+/**
+ * This class keeps on disk the feature planes already computed, so that
+ * running again the same image with the same parameters skips the
+ * computation.
+ * Each entry is named after a hash of the pixels of the image and of every
+ * parameter that changes the values; when the entries exceed the size of
+ * the cache, the least recently used ones are deleted
+ */
+class ResultCache {
+public:
+    /**
+     * Initialize the cache
+     * @param folder: where the entries are kept; created if missing
+     * @param maxBytes: size of the entries above which the least recently
+     * used ones are deleted
+     */
+    ResultCache(const string& folder, uint64_t maxBytes);
+    /**
+     * Compute the name of the entry of an image
+     * @param pixels: pixels intensities of the image, as read and
+     * transformed (borders, quantization)
+     * @param img: image metadata (dimensions with borders, gray levels)
+     * @param progArg: parameters of the computation
+     * @return the hash of pixels and parameters, as hexadecimal digits
+     */
+    static string computeKey(const ImageView& pixels, const ImageData& img,
+            const ProgramArguments& progArg);
+    /**
+     * Read the values of an entry
+     * @param key: name of the entry
+     * @param featurePlanes: allocated planes where the values are read
+     * @return false if the entry is missing or has different dimensions
+     */
+    bool load(const string& key, FeaturePlanes& featurePlanes);
+    /**
+     * Save the values of an entry, then delete the least recently used
+     * entries if the cache became too big
+     * @param key: name of the entry
+     * @param featurePlanes: the values computed
+     */
+    void store(const string& key, const FeaturePlanes& featurePlanes);
+
+private:
+    string folder;
+    uint64_t maxBytes;
+    /**
+     * Workers that compute different images can store at the same time
+     */
+    mutex evictionLock;
+    /**
+     * Utility method
+     * @param key: name of the entry
+     * @return path of the file of the entry
+     */
+    string getEntryPath(const string& key) const;
+    /**
+     * Delete the least recently used entries until the cache fits its size
+     */
+    void evict();
+};
+
+
+#endif //FEATUREEXTRACTOR_RESULTCACHE_H
@@ -0,0 +1,492 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <getopt.h>
+#include "GLCMFeatures.h"
+#include "GLCMFeaturesC.h"
+#include "WindowSweepComputer.h"
+#include "VolumeFeatureComputer.h"
+#include "DenseReference.h"
+
+using namespace std;
+
+/*
+ * Differential check of every computer of the features against the dense
+ * reference (DenseReference): random images and volumes, with random
+ * windows, distances, directions, symmetry, borders and quantization, go
+ * through each of them and every value must match the reference within
+ * the tolerance of its rounding errors.
+ * Usage: GLCMCheck [-n cases] [-s seed] [-j threads] [--backend name] [-v]
+ */
+
+/**
+ * Largest difference allowed from the reference, relative to the sum of the
+ * absolute values of the terms of each value: different orders of the sums
+ * only change the last digits
+ */
+const double RELATIVE_TOLERANCE = 1e-9;
+const double ABSOLUTE_TOLERANCE = 1e-12;
+/**
+ * Mismatches printed for each backend; the others are only counted
+ */
+const int PRINTED_MISMATCHES = 5;
+
+struct CheckOptions {
+    int cases;
+    unsigned int seed;
+    int threads;
+    string backend;
+    bool verbose;
+};
+
+/**
+ * Random image or volume, with the parameters of its windows
+ */
+struct CheckCase {
+    int index;
+    int bitsPerPixel;
+    int slices;
+    int rows;
+    int columns;
+    /**
+     * Gray levels, slice after slice
+     */
+    vector<unsigned int> voxels;
+    GLCMParameters parameters;
+    bool volumetric;
+    /**
+     * Window sides computed together by the sweep, in increasing order;
+     * the last is the window side of the parameters
+     */
+    vector<short int> sweepSizes;
+
+    /**
+     * Pixels in their compact (8/16 bit) representation
+     */
+    vector<unsigned char> getBytes() const {
+        int bytesPerPixel = bitsPerPixel / 8;
+        vector<unsigned char> bytes(voxels.size() * bytesPerPixel);
+        for (size_t k = 0; k < voxels.size(); ++k) {
+            if(bitsPerPixel == 16)
+                reinterpret_cast<uint16_t*>(bytes.data())[k] = (uint16_t) voxels[k];
+            else
+                bytes[k] = (unsigned char) voxels[k];
+        }
+        return bytes;
+    }
+
+    string describe() const {
+        ostringstream text;
+        text << "case " << index << " (" << bitsPerPixel << " bit ";
+        if(volumetric)
+            text << slices << "x";
+        text << rows << "x" << columns << ", window " << parameters.windowSize
+             << ", distance " << parameters.distance << ", direction "
+             << parameters.directionType << ", "
+             << (parameters.symmetric ? "symmetric" : "asymmetric")
+             << ", border " << parameters.borderType;
+        if(parameters.quantitize)
+            text << ", quantized to " << parameters.quantitizationMax;
+        text << ")";
+        return text.str();
+    }
+};
+
+/**
+ * Outcome of the checks of a backend
+ */
+struct BackendResult {
+    string name;
+    int cases;
+    size_t values;
+    size_t mismatches;
+    /**
+     * Largest difference from the reference, in units of its tolerance
+     */
+    double worstError;
+};
+
+/**
+ * Compare the values of a backend with the ones of the reference
+ * @param result: outcome of the backend, updated
+ * @param checkCase: the image and the parameters computed
+ * @param actual: planes computed by the backend, (slices * rows) x columns
+ * values each
+ * @param expected: planes computed by the reference
+ * @param magnitudes: sum of the absolute values of the terms of each value
+ * of the reference
+ * @param planeSize: values of each plane
+ */
+void compareValues(BackendResult& result, const CheckCase& checkCase,
+        const double* actual, const vector<double>& expected,
+        const vector<double>& magnitudes, const size_t planeSize){
+    static const vector<string> featureNames = Features::getAllFeaturesFileNames();
+    result.cases++;
+    for (int f = 0; f <= IMOC; ++f) {
+        for (size_t k = 0; k < planeSize; ++k) {
+            size_t index = f * planeSize + k;
+            double value = actual[index];
+            double reference = expected[index];
+            result.values++;
+            // Not defined in the window, or 0/0 in both
+            if(isinf(magnitudes[index]) || (!isfinite(value) && !isfinite(reference)))
+                continue;
+            double tolerance = RELATIVE_TOLERANCE * magnitudes[index] + ABSOLUTE_TOLERANCE;
+            double error = fabs(value - reference);
+            if(isfinite(value) && isfinite(reference) && (error <= tolerance)){
+                result.worstError = max(result.worstError, error / tolerance);
+                continue;
+            }
+            if(result.mismatches < PRINTED_MISMATCHES){
+                size_t slice = k / ((size_t) checkCase.rows * checkCase.columns);
+                size_t row = (k / checkCase.columns) % checkCase.rows;
+                size_t column = k % checkCase.columns;
+                cerr << "MISMATCH " << result.name << " " << checkCase.describe()
+                     << ": " << featureNames[f] << " of the window at ";
+                if(checkCase.volumetric)
+                    cerr << "slice " << slice << ", ";
+                cerr << "row " << row << ", column " << column << " is "
+                     << setprecision(17) << value << " instead of " << reference
+                     << setprecision(6) << endl;
+            }
+            result.mismatches++;
+        }
+    }
+}
+
+/**
+ * Generate a random image, or volume, and the parameters of its windows
+ * @param index: number of the case
+ * @param volumetric: generate a volume and its cubic windows
+ * @param random: source of every choice
+ */
+CheckCase generateCase(const int index, const bool volumetric, mt19937& random){
+    auto pick = [&](int lowest, int highest){
+        return uniform_int_distribution<int>(lowest, highest)(random);
+    };
+    CheckCase checkCase;
+    checkCase.index = index;
+    checkCase.volumetric = volumetric;
+    checkCase.bitsPerPixel = pick(0, 1) ? 16 : 8;
+    checkCase.slices = volumetric ? pick(2, 7) : 1;
+    checkCase.rows = volumetric ? pick(4, 12) : pick(6, 28);
+    checkCase.columns = volumetric ? pick(4, 12) : pick(6, 28);
+
+    // Few levels give repeated pairs, many levels give sparse matrices
+    int maxGrayLevel = (checkCase.bitsPerPixel == 16) ? 65535 : 255;
+    const int levelCounts[] = {2, 5, 16, 256, 4096, 65536};
+    int levels = min(levelCounts[pick(0, 5)], maxGrayLevel + 1);
+    int base = pick(0, maxGrayLevel + 1 - levels);
+    bool smooth = pick(0, 1);
+    for (int z = 0; z < checkCase.slices; ++z) {
+        for (int y = 0; y < checkCase.rows; ++y) {
+            for (int x = 0; x < checkCase.columns; ++x) {
+                int level = smooth ? (z + y / 3 + x / 4 + pick(0, 1)) % levels
+                        : pick(0, levels - 1);
+                checkCase.voxels.push_back(base + level);
+            }
+        }
+    }
+
+    GLCMParameters& parameters = checkCase.parameters;
+    int smallestSide = min(checkCase.rows, checkCase.columns);
+    if(volumetric)
+        smallestSide = min(smallestSide, checkCase.slices);
+    parameters.windowSize = pick(2, min(smallestSide, volumetric ? 5 : 9));
+    parameters.distance = pick(1, parameters.windowSize - 1);
+    parameters.directionType = pick(1, volumetric ? Direction::VOLUME_DIRECTIONS
+            : Direction::PLANE_DIRECTIONS);
+    parameters.symmetric = pick(0, 1);
+    parameters.borderType = pick(0, 2);
+    parameters.quantitize = (pick(0, 3) == 0);
+    parameters.quantitizationMax = pick(1, 64);
+
+    // Smaller windows nested in the one of the parameters
+    for (int side = parameters.distance + 1; side < parameters.windowSize; ++side) {
+        if(pick(0, 2) == 0)
+            checkCase.sweepSizes.push_back(side);
+    }
+    checkCase.sweepSizes.push_back(parameters.windowSize);
+    return checkCase;
+}
+
+/**
+ * Utility method
+ * @param checkCase: image and parameters
+ * @param windowSize: side of the windows of the sweep or volume
+ * @return the options of the computers of the tool for the case
+ */
+ProgramArguments getProgramArguments(const CheckCase& checkCase, const int windowSize){
+    const GLCMParameters& parameters = checkCase.parameters;
+    ProgramArguments progArg;
+    progArg.windowSize = windowSize;
+    progArg.distance = parameters.distance;
+    progArg.directionType = parameters.directionType;
+    progArg.symmetric = parameters.symmetric;
+    progArg.borderType = parameters.borderType;
+    progArg.quantitize = parameters.quantitize;
+    progArg.quantitizationMax = parameters.quantitizationMax;
+    progArg.volumetric = checkCase.volumetric;
+    return progArg;
+}
+
+/**
+ * Utility method
+ * @return the applied border of windows of the given side
+ */
+int getBorderSize(const CheckCase& checkCase, const int windowSize){
+    return (checkCase.parameters.borderType == 0) ? 0 : windowSize;
+}
+
+/**
+ * Check the computers of plane images: the library on 1 and many threads,
+ * its C interface, the bands of rows and the sweep of many window sides
+ */
+void checkImage(const CheckOptions& options, const CheckCase& checkCase,
+        GLCMFeatures& single, GLCMFeatures& multi, mt19937& random,
+        vector<BackendResult>& results){
+    DenseReference reference(checkCase.voxels, 1, checkCase.rows,
+            checkCase.columns, checkCase.bitsPerPixel, checkCase.parameters, false);
+    vector<double> expected;
+    vector<double> magnitudes;
+    reference.computeAllFeatures(expected, magnitudes);
+
+    vector<unsigned char> bytes = checkCase.getBytes();
+    PixelBuffer input = {bytes.data(), checkCase.bitsPerPixel, checkCase.rows,
+                         checkCase.columns,
+                         (size_t) checkCase.columns * (checkCase.bitsPerPixel / 8)};
+    size_t planeSize = (size_t) checkCase.rows * checkCase.columns;
+    vector<double> output(GLCMFeatures::getOutputSize(input));
+
+    // The library, on the calling thread and on all the workers
+    if(options.backend.empty() || (options.backend == results[0].name)){
+        single.extract(input, checkCase.parameters, output.data());
+        compareValues(results[0], checkCase, output.data(), expected, magnitudes, planeSize);
+    }
+    if(options.backend.empty() || (options.backend == results[1].name)){
+        multi.extract(input, checkCase.parameters, output.data());
+        compareValues(results[1], checkCase, output.data(), expected, magnitudes, planeSize);
+    }
+
+    // The C interface
+    if(options.backend.empty() || (options.backend == results[2].name)){
+        const GLCMParameters& parameters = checkCase.parameters;
+        glcm_parameters cParameters = {parameters.windowSize, parameters.distance,
+                parameters.directionType, parameters.symmetric, parameters.borderType,
+                parameters.quantitize, parameters.quantitizationMax, options.threads};
+        glcm_dimensions dims = {checkCase.rows, checkCase.columns,
+                checkCase.bitsPerPixel, input.stride};
+        glcm_context* context = glcm_create_context(&cParameters);
+        fill(output.begin(), output.end(), -1.0);
+        glcm_compute(context, bytes.data(), &dims, output.data());
+        glcm_destroy_context(context);
+        compareValues(results[2], checkCase, output.data(), expected, magnitudes, planeSize);
+    }
+
+    /* Bands of rows of windows, as --band-rows reads and computes them;
+     * their borders are virtual, as the tool reads them, or copied */
+    if(options.backend.empty() || (options.backend == results[3].name)){
+        int bandRows = uniform_int_distribution<int>(1, checkCase.rows)(random);
+        bool virtualBorders = uniform_int_distribution<int>(0, 1)(random) == 1;
+        int borderSize = virtualBorders ? 0
+                : getBorderSize(checkCase, checkCase.parameters.windowSize);
+        fill(output.begin(), output.end(), 0.0);
+        for (int firstRow = 0; firstRow < checkCase.rows; firstRow += bandRows) {
+            int lastRow = min(firstRow + bandRows, checkCase.rows);
+            Image band = GLCMFeatures::readBand(input, firstRow, lastRow,
+                    checkCase.parameters.windowSize, checkCase.parameters.borderType,
+                    borderSize, checkCase.parameters.quantitize,
+                    checkCase.parameters.quantitizationMax);
+            ImageData bandData(band, borderSize);
+            const unsigned int* pixels = band.getPixels();
+            FeaturePlanes bandPlanes(lastRow - firstRow, checkCase.columns, 1);
+            multi.computeAllFeatures(pixels, bandData, checkCase.parameters,
+                    bandPlanes);
+            for (int f = 0; f <= IMOC; ++f) {
+                const double* plane = bandPlanes.getPlane((FeatureNames) f, 0);
+                copy(plane, plane + bandPlanes.getPlaneSize(),
+                     output.begin() + f * planeSize + (size_t) firstRow * checkCase.columns);
+            }
+        }
+        compareValues(results[3], checkCase, output.data(), expected, magnitudes, planeSize);
+    }
+
+    // Many window sides in a single sweep, bordered for the largest
+    if(options.backend.empty() || (options.backend == results[4].name)){
+        int largest = checkCase.sweepSizes.back();
+        int borderSize = getBorderSize(checkCase, largest);
+        vector<unsigned int> pixels = reference.getBorderedVoxels(borderSize);
+        ImageData imgData(checkCase.rows + 2 * borderSize,
+                checkCase.columns + 2 * borderSize, borderSize,
+                reference.getMaxGrayLevel());
+        WindowSweepComputer sweepComputer(getProgramArguments(checkCase, largest),
+                checkCase.sweepSizes, multi.getWorkers());
+        vector<FeaturePlanes> sweepPlanes = sweepComputer.computeAllFeatures(
+                pixels.data(), imgData);
+        for (size_t k = 0; k < checkCase.sweepSizes.size(); ++k) {
+            GLCMParameters parameters = checkCase.parameters;
+            parameters.windowSize = checkCase.sweepSizes[k];
+            DenseReference sizeReference(checkCase.voxels, 1, checkCase.rows,
+                    checkCase.columns, checkCase.bitsPerPixel, parameters, false);
+            vector<double> sizeExpected;
+            vector<double> sizeMagnitudes;
+            sizeReference.computeAllFeatures(sizeExpected, sizeMagnitudes);
+            for (int f = 0; f <= IMOC; ++f) {
+                const double* plane = sweepPlanes[k].getPlane((FeatureNames) f, 0);
+                copy(plane, plane + planeSize, output.begin() + f * planeSize);
+            }
+            compareValues(results[4], checkCase, output.data(), sizeExpected,
+                    sizeMagnitudes, planeSize);
+        }
+    }
+}
+
+/**
+ * Check the computer of the cubic windows of volumes (--3d)
+ */
+void checkVolume(const CheckOptions& options, const CheckCase& checkCase,
+        GLCMFeatures& multi, vector<BackendResult>& results){
+    if(!options.backend.empty() && (options.backend != results[5].name))
+        return;
+    DenseReference reference(checkCase.voxels, checkCase.slices, checkCase.rows,
+            checkCase.columns, checkCase.bitsPerPixel, checkCase.parameters, true);
+    vector<double> expected;
+    vector<double> magnitudes;
+    reference.computeAllFeatures(expected, magnitudes);
+
+    int borderSize = getBorderSize(checkCase, checkCase.parameters.windowSize);
+    vector<unsigned int> voxels = reference.getBorderedVoxels(borderSize);
+    ImageData volumeData(checkCase.rows + 2 * borderSize,
+            checkCase.columns + 2 * borderSize, borderSize,
+            reference.getMaxGrayLevel(), checkCase.slices + 2 * borderSize);
+    VolumeFeatureComputer volumeComputer(getProgramArguments(checkCase,
+            checkCase.parameters.windowSize), multi.getWorkers());
+    FeaturePlanes featurePlanes = volumeComputer.computeAllFeatures(voxels.data(),
+            volumeData);
+    size_t planeSize = featurePlanes.getPlaneSize();
+    vector<double> output(planeSize * (IMOC + 1));
+    for (int f = 0; f <= IMOC; ++f) {
+        const double* plane = featurePlanes.getPlane((FeatureNames) f, 0);
+        copy(plane, plane + planeSize, output.begin() + f * planeSize);
+    }
+    compareValues(results[5], checkCase, output.data(), expected, magnitudes, planeSize);
+}
+
+void printCheckUsage(){
+    cout << "Usage: GLCMCheck [-n cases] [-s seed] [-j threads] [--backend name] [-v]" << endl
+         << "  -n: random images and volumes checked (default 200)" << endl
+         << "  -s: seed of the first case; the same seed checks the same cases (default 1)" << endl
+         << "  -j: threads of the multithreaded backends (default 4)" << endl
+         << "  --backend: check only one of extract, extract-threads, c-api, "
+            "bands, sweep, volume" << endl
+         << "  -v: print each case" << endl;
+    exit(2);
+}
+
+CheckOptions parseCheckOptions(int argc, char* argv[]){
+    CheckOptions options = {200, 1, 4, "", false};
+    enum LongOnlyOptions {
+        BACKEND_OPTION = 1000
+    };
+    static struct option longOptions[] = {
+            {"backend", required_argument, NULL, BACKEND_OPTION},
+            {NULL, 0, NULL, 0}
+    };
+    int opt;
+    while((opt = getopt_long(argc, argv, "n:s:j:vh", longOptions, NULL)) != -1){
+        switch(opt){
+            case 'n':
+                options.cases = atoi(optarg);
+                if(options.cases < 1){
+                    cerr << "ERROR! The cases must be >= 1" << endl;
+                    printCheckUsage();
+                }
+                break;
+            case 's':
+                options.seed = strtoul(optarg, NULL, 10);
+                break;
+            case 'j':
+                options.threads = atoi(optarg);
+                if(options.threads < 2){
+                    cerr << "ERROR! The multithreaded backends need >= 2 threads" << endl;
+                    printCheckUsage();
+                }
+                break;
+            case BACKEND_OPTION:
+                options.backend = optarg;
+                break;
+            case 'v':
+                options.verbose = true;
+                break;
+            default:
+                printCheckUsage();
+        }
+    }
+    if(optind < argc)
+        printCheckUsage();
+    return options;
+}
+
+int main(int argc, char* argv[]) {
+    CheckOptions options = parseCheckOptions(argc, argv);
+    const char* backends[] = {"extract", "extract-threads", "c-api", "bands",
+                              "sweep", "volume"};
+    vector<BackendResult> results;
+    for (int b = 0; b < 6; ++b) {
+        BackendResult result = {backends[b], 0, 0, 0, 0};
+        results.push_back(result);
+        if(options.backend == backends[b])
+            options.backend = result.name;
+    }
+    bool knownBackend = options.backend.empty();
+    for (size_t b = 0; b < results.size(); ++b) {
+        knownBackend = knownBackend || (options.backend == results[b].name);
+    }
+    if(!knownBackend){
+        cerr << "ERROR! Unknown backend: " << options.backend << endl;
+        printCheckUsage();
+    }
+
+    // The instances are reused by all the cases, as by the tool
+    GLCMFeatures single(1);
+    GLCMFeatures multi(options.threads);
+    cout << "* Checking " << options.cases << " cases (seed " << options.seed
+         << ") against the dense reference *" << endl;
+    for (int i = 0; i < options.cases; ++i) {
+        // Each case only depends on its own seed, so it can be run again alone
+        mt19937 random(options.seed + i);
+        bool volumetric = (i % 4 == 3);
+        CheckCase checkCase = generateCase(options.seed + i, volumetric, random);
+        if(options.verbose)
+            cout << "- " << checkCase.describe() << endl;
+        if(volumetric)
+            checkVolume(options, checkCase, multi, results);
+        else
+            checkImage(options, checkCase, single, multi, random, results);
+    }
+
+    size_t mismatches = 0;
+    cout << endl << "\t" << left << setw(18) << "backend" << right << setw(8)
+         << "cases" << setw(12) << "values" << setw(12) << "mismatches"
+         << setw(14) << "worst error" << endl;
+    for (size_t b = 0; b < results.size(); ++b) {
+        const BackendResult& result = results[b];
+        if(result.cases == 0)
+            continue;
+        cout << "\t" << left << setw(18) << result.name << right << setw(8)
+             << result.cases << setw(12) << result.values << setw(12)
+             << result.mismatches << setw(14) << setprecision(3)
+             << result.worstError << endl;
+        mismatches += result.mismatches;
+    }
+    cout << "- Worst error in units of the tolerance of each value" << endl;
+    if(mismatches > 0){
+        cerr << "ERROR! " << mismatches << " values don't match the reference" << endl;
+        return 1;
+    }
+    cout << "- All the values match the reference" << endl;
+    return 0;
+}
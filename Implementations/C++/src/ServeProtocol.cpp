@@ -0,0 +1,35 @@
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "ServeProtocol.h"
+
+bool ServeProtocol::sendMessage(const int socket, const void* message,
+        const size_t length){
+    const char* bytes = (const char*) message;
+    size_t sent = 0;
+    while(sent < length){
+        // A closed peer is an error, not a SIGPIPE
+        ssize_t written = send(socket, bytes + sent, length - sent, MSG_NOSIGNAL);
+        if(written < 0 && errno == EINTR)
+            continue;
+        if(written <= 0)
+            return false;
+        sent += written;
+    }
+    return true;
+}
+
+bool ServeProtocol::receiveMessage(const int socket, void* message,
+        const size_t length){
+    char* bytes = (char*) message;
+    size_t received = 0;
+    while(received < length){
+        ssize_t read = recv(socket, bytes + received, length - received, 0);
+        if(read < 0 && errno == EINTR)
+            continue;
+        if(read <= 0)
+            return false;
+        received += read;
+    }
+    return true;
+}
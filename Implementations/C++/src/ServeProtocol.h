@@ -0,0 +1,114 @@
+#ifndef FEATUREEXTRACTOR_SERVEPROTOCOL_H
+#define FEATUREEXTRACTOR_SERVEPROTOCOL_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Messages exchanged on the Unix domain socket of the server (--serve).
+ * Pixels and results don't travel on the socket: the client puts them in a
+ * POSIX shared memory object and the messages only say where they are.
+ * Both sides are on the same machine, so the structs are sent as they are;
+ * their fields are ordered so that they have no padding
+ */
+namespace ServeProtocol {
+    /**
+     * First field of every message: "GLCM"
+     */
+    const uint32_t MAGIC = 0x474C434D;
+    /**
+     * Longest name of a shared memory object, terminator included
+     */
+    const int SHM_NAME_LENGTH = 64;
+
+    enum RequestType {
+        /**
+         * Compute the features of an image
+         */
+        JOB_REQUEST = 1,
+        /**
+         * Stop the server after replying
+         */
+        SHUTDOWN_REQUEST = 2
+    };
+
+    enum ReplyStatus {
+        JOB_DONE = 0,
+        /**
+         * The parameters or the layout of the job are not valid
+         */
+        JOB_INVALID = -1,
+        /**
+         * The shared memory object could not be opened, or is too small
+         */
+        JOB_MEMORY_ERROR = -2,
+        /**
+         * The server had not enough memory for computing the job
+         */
+        JOB_OUT_OF_MEMORY = -3
+    };
+
+    struct Request {
+        uint32_t magic;
+        uint32_t type;
+        /**
+         * Shared memory object with the pixels and room for the results
+         */
+        char shmName[SHM_NAME_LENGTH];
+        uint64_t shmSize;
+        /**
+         * Bytes from the start of the object to the first pixel
+         */
+        uint64_t pixelsOffset;
+        /**
+         * Bytes from the start of the object to the first result; the
+         * planes of the features, rows x columns doubles each
+         */
+        uint64_t outputOffset;
+        /**
+         * Bytes from the start of a row of pixels to the start of the next
+         */
+        uint64_t stride;
+        int32_t rows;
+        int32_t columns;
+        int32_t bitsPerPixel;
+        // Parameters of the features, as in GLCMParameters
+        int32_t windowSize;
+        int32_t distance;
+        int32_t directionType;
+        int32_t symmetric;
+        int32_t borderType;
+        int32_t quantitize;
+        int32_t quantitizationMax;
+    };
+
+    struct Reply {
+        uint32_t magic;
+        int32_t status;
+        /**
+         * Time the server spent on the job, from the request read to the
+         * results written
+         */
+        uint64_t microseconds;
+    };
+
+    /**
+     * Write the whole message on the socket
+     * @param socket: connected socket
+     * @param message: bytes to write
+     * @param length: size of the message
+     * @return false if the connection was closed or broken
+     */
+    bool sendMessage(int socket, const void* message, size_t length);
+    /**
+     * Read a whole message from the socket
+     * @param socket: connected socket
+     * @param message: where the bytes are put
+     * @param length: size of the message
+     * @return false if the connection was closed or broken
+     */
+    bool receiveMessage(int socket, void* message, size_t length);
+}
+
+
+#endif //FEATUREEXTRACTOR_SERVEPROTOCOL_H
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "SharedMemory.h"
+
+SharedMemory::SharedMemory(): data(NULL), size(0), owner(false){}
+
+SharedMemory::~SharedMemory(){
+    close();
+}
+
+bool SharedMemory::create(const string& objectName, const size_t objectSize){
+    if(owner && (objectName == name) && (objectSize <= size))
+        return true;
+    close();
+    int descriptor = shm_open(objectName.c_str(), O_CREAT | O_RDWR, 0600);
+    if(descriptor < 0){
+        cerr << "ERROR! Can't create the shared memory " << objectName << ": "
+             << strerror(errno) << endl;
+        return false;
+    }
+    // Owned from now on, so that a failure below still removes it
+    name = objectName;
+    owner = true;
+    if(ftruncate(descriptor, objectSize) != 0){
+        cerr << "ERROR! Can't resize the shared memory " << objectName << ": "
+             << strerror(errno) << endl;
+        ::close(descriptor);
+        close();
+        return false;
+    }
+    void* mapping = mmap(NULL, objectSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+            descriptor, 0);
+    ::close(descriptor);
+    if(mapping == MAP_FAILED){
+        cerr << "ERROR! Can't map the shared memory " << objectName << ": "
+             << strerror(errno) << endl;
+        close();
+        return false;
+    }
+    data = (char*) mapping;
+    size = objectSize;
+    return true;
+}
+
+bool SharedMemory::open(const string& objectName, const size_t objectSize){
+    if(!owner && (data != NULL) && (objectName == name) && (objectSize <= size))
+        return true;
+    close();
+    int descriptor = shm_open(objectName.c_str(), O_RDWR, 0);
+    if(descriptor < 0){
+        cerr << "ERROR! Can't open the shared memory " << objectName << ": "
+             << strerror(errno) << endl;
+        return false;
+    }
+    // A mapping beyond the end of the object would crash when touched
+    struct stat status;
+    if((fstat(descriptor, &status) != 0) || ((size_t) status.st_size < objectSize)){
+        cerr << "ERROR! The shared memory " << objectName << " is smaller than "
+             << objectSize << " bytes" << endl;
+        ::close(descriptor);
+        return false;
+    }
+    void* mapping = mmap(NULL, status.st_size, PROT_READ | PROT_WRITE,
+            MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    if(mapping == MAP_FAILED){
+        cerr << "ERROR! Can't map the shared memory " << objectName << ": "
+             << strerror(errno) << endl;
+        return false;
+    }
+    name = objectName;
+    data = (char*) mapping;
+    size = status.st_size;
+    return true;
+}
+
+void SharedMemory::close(){
+    if(data != NULL)
+        munmap(data, size);
+    if(owner)
+        shm_unlink(name.c_str());
+    name.clear();
+    data = NULL;
+    size = 0;
+    owner = false;
+}
+
+char* SharedMemory::getData() const{
+    return data;
+}
+
+size_t SharedMemory::getSize() const{
+    return size;
+}
+
+const string& SharedMemory::getName() const{
+    return name;
+}
@@ -0,0 +1,72 @@
+#ifndef FEATUREEXTRACTOR_SHAREDMEMORY_H
+#define FEATUREEXTRACTOR_SHAREDMEMORY_H
+
+#include <string>
+
+using namespace std;
+
+/**
+ * POSIX shared memory object mapped in the address space of the process,
+ * used by the server (--serve) and its clients to hand over pixels and
+ * results without copying them through the socket
+ */
+class SharedMemory {
+public:
+    SharedMemory();
+    /**
+     * Unmap the object; the creator also removes its name
+     */
+    ~SharedMemory();
+    /**
+     * Create a new object, or resize the one already created by this
+     * instance, and map it
+     * @param name: name of the object, starting with '/'
+     * @param size: bytes of the object
+     * @return false, after printing why, if it can't be created
+     */
+    bool create(const string& name, size_t size);
+    /**
+     * Map an object created by another process; nothing is done when it is
+     * already the mapped one
+     * @param name: name of the object
+     * @param size: bytes that will be used; the object must be at least as
+     * large
+     * @return false, after printing why, if it can't be mapped
+     */
+    bool open(const string& name, size_t size);
+    /**
+     * Unmap the object; the creator also removes its name
+     */
+    void close();
+    /**
+     * Getter
+     * @return first byte of the mapping; NULL if nothing is mapped
+     */
+    char* getData() const;
+    /**
+     * Getter
+     * @return bytes mapped
+     */
+    size_t getSize() const;
+    /**
+     * Getter
+     * @return name of the object mapped
+     */
+    const string& getName() const;
+
+private:
+    // The mapping belongs to a single instance
+    SharedMemory(const SharedMemory& other);
+    SharedMemory& operator=(const SharedMemory& other);
+
+    string name;
+    char* data;
+    size_t size;
+    /**
+     * The object was created by this instance, that removes it
+     */
+    bool owner;
+};
+
+
+#endif //FEATUREEXTRACTOR_SHAREDMEMORY_H
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <assert.h>
+#include "SlidingGLCM.h"
+
+SlidingGLCM::SlidingGLCM(const int maxPairs, const bool symmetric)
+        : symmetric(symmetric){
+    // At most half full, so that searches stay short
+    sizeBits = 4;
+    while((1 << sizeBits) < 2 * maxPairs)
+        sizeBits++;
+    slots.resize(1 << sizeBits);
+    mask = (1 << sizeBits) - 1;
+    clear();
+}
+
+void SlidingGLCM::clear(){
+    Slot empty = {0, 0};
+    fill(slots.begin(), slots.end(), empty);
+}
+
+inline uint32_t SlidingGLCM::getKey(const grayLevelType reference,
+        const grayLevelType neighbor) const{
+    if(symmetric && (reference > neighbor))
+        return ((uint32_t) neighbor << 16) | reference;
+    return ((uint32_t) reference << 16) | neighbor;
+}
+
+inline uint32_t SlidingGLCM::getHomeSlot(const uint32_t key) const{
+    // Fibonacci hashing: the high bits of the product are well mixed
+    return (uint32_t) (key * 2654435769u) >> (32 - sizeBits);
+}
+
+void SlidingGLCM::addPair(const grayLevelType reference, const grayLevelType neighbor){
+    uint32_t key = getKey(reference, neighbor);
+    uint32_t position = getHomeSlot(key);
+    while((slots[position].frequency != 0) && (slots[position].key != key))
+        position = (position + 1) & mask;
+    slots[position].key = key;
+    slots[position].frequency++;
+}
+
+void SlidingGLCM::removePair(const grayLevelType reference, const grayLevelType neighbor){
+    uint32_t key = getKey(reference, neighbor);
+    uint32_t position = getHomeSlot(key);
+    while(slots[position].key != key || (slots[position].frequency == 0)){
+        assert(slots[position].frequency != 0);
+        position = (position + 1) & mask;
+    }
+    if(--slots[position].frequency > 0)
+        return;
+
+    /* The slot is free again: the following pairs of the same run are moved
+     * back, if it doesn't put them before their home slot, so that no search
+     * stops at this hole */
+    uint32_t hole = position;
+    uint32_t next = (hole + 1) & mask;
+    while(slots[next].frequency != 0){
+        uint32_t home = getHomeSlot(slots[next].key);
+        // distance from the home slot, along the circular table
+        uint32_t nextDistance = (next - home) & mask;
+        uint32_t holeDistance = (hole - home) & mask;
+        if(holeDistance < nextDistance){
+            slots[hole] = slots[next];
+            slots[next].frequency = 0;
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
+
+int SlidingGLCM::getPairs(GrayPair* output) const{
+    int numberOfPairs = 0;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if(slots[i].frequency == 0)
+            continue;
+        output[numberOfPairs++] = GrayPair((grayLevelType) (slots[i].key >> 16),
+                (grayLevelType) (slots[i].key & 0xFFFF), slots[i].frequency);
+    }
+    sort(output, output + numberOfPairs);
+    return numberOfPairs;
+}
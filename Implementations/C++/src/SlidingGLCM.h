@@ -0,0 +1,82 @@
+#ifndef FEATUREEXTRACTOR_SLIDINGGLCM_H
+#define FEATUREEXTRACTOR_SLIDINGGLCM_H
+
+#include <vector>
+#include <cstdint>
+#include "GrayPair.h"
+
+using namespace std;
+
+/**
+ * This class keeps the frequencies of the gray pairs of a window that moves
+ * one step at a time: the pairs of the slab that leaves the window are
+ * removed and the ones of the slab that enters it are added, instead of
+ * counting again all the pairs of the window.
+ * Pairs are kept in an open addressing hash table, so each update costs
+ * the same regardless of how many different pairs the window has
+ */
+class SlidingGLCM {
+public:
+    /**
+     * Allocate the table
+     * @param maxPairs: pixel pairs of each window (not doubled when
+     * symmetric); the different gray pairs can't be more than these
+     * @param symmetric: pairs <i,j> and <j,i> are the same gray pair
+     */
+    SlidingGLCM(int maxPairs, bool symmetric);
+    /**
+     * Forget all the pairs, before counting the ones of a new window
+     */
+    void clear();
+    /**
+     * Count a pixel pair that entered the window
+     * @param reference: gray level of the reference pixel
+     * @param neighbor: gray level of the neighbor pixel
+     */
+    void addPair(grayLevelType reference, grayLevelType neighbor);
+    /**
+     * Forget a pixel pair that left the window; it must have been added
+     * @param reference: gray level of the reference pixel
+     * @param neighbor: gray level of the neighbor pixel
+     */
+    void removePair(grayLevelType reference, grayLevelType neighbor);
+    /**
+     * Copy the different gray pairs with their frequencies, in the same form
+     * of the GrayPairs of the GLCM. They are sorted by gray levels, so
+     * the result doesn't depend on the order of the updates
+     * @param output: where the pairs will be copied; at least maxPairs
+     * elements
+     * @return how many different gray pairs were copied
+     */
+    int getPairs(GrayPair* output) const;
+
+private:
+    /**
+     * Cell of the table; frequency 0 means available
+     */
+    struct Slot {
+        uint32_t key;
+        frequencyType frequency;
+    };
+    vector<Slot> slots;
+    /**
+     * Table size - 1; the size is a power of 2
+     */
+    uint32_t mask;
+    /**
+     * Bits of the table size, for spreading the keys
+     */
+    int sizeBits;
+    bool symmetric;
+    /**
+     * Both gray levels in a single value; the smaller first when symmetric
+     */
+    uint32_t getKey(grayLevelType reference, grayLevelType neighbor) const;
+    /**
+     * Slot where the search of a key starts
+     */
+    uint32_t getHomeSlot(uint32_t key) const;
+};
+
+
+#endif //FEATUREEXTRACTOR_SLIDINGGLCM_H
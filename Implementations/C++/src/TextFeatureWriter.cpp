@@ -0,0 +1,204 @@
+#include <cstdio>
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+#include "TextFeatureWriter.h"
+
+const int TextFeatureWriter::WRITE_CHUNK_SIZE;
+const int TextFeatureWriter::MAX_VALUE_LENGTH;
+const int TextFeatureWriter::MAX_PRECISION;
+const int TextFeatureWriter::DEFAULT_PRECISION;
+
+TextFeatureWriter::TextFeatureWriter(const int precision, const bool rowLayout)
+        : precision(precision), rowLayout(rowLayout),
+          buffer(getBufferSize()), writtenBytes(0){}
+
+size_t TextFeatureWriter::getBufferSize(){
+    return WRITE_CHUNK_SIZE + 2 * MAX_VALUE_LENGTH;
+}
+
+/**
+ * Powers of ten that a long double represents exactly (5^27 < 2^64)
+ */
+static const int EXACT_POWERS = 28;
+
+/**
+ * Table of the exact powers of ten; built once, thread safe
+ */
+struct PowersOfTen {
+    long double values[EXACT_POWERS];
+    PowersOfTen(){
+        long double power = 1;
+        for (int i = 0; i < EXACT_POWERS; ++i) {
+            values[i] = power;
+            power *= 10;
+        }
+    }
+};
+
+static long double powerOfTen(int exponent){
+    static const PowersOfTen powers;
+    int absExponent = exponent < 0 ? -exponent : exponent;
+    long double result = 1;
+    while(absExponent >= EXACT_POWERS){
+        result *= powers.values[EXACT_POWERS - 1];
+        absExponent -= (EXACT_POWERS - 1);
+    }
+    result *= powers.values[absExponent];
+    return exponent < 0 ? (1 / result) : result;
+}
+
+// Fallback for the values the fast path can't round with certainty
+static size_t formatWithPrintf(const double value, const int precision, char* output){
+    char temp[TextFeatureWriter::MAX_VALUE_LENGTH + 1];
+    int length = snprintf(temp, sizeof(temp), "%.*g", precision, value);
+    for (int i = 0; i < length; ++i) {
+        output[i] = temp[i];
+    }
+    return length;
+}
+
+static size_t writeUnsigned(uint64_t number, char* output){
+    char reversed[24];
+    int length = 0;
+    do{
+        reversed[length++] = (char) ('0' + (number % 10));
+        number /= 10;
+    } while(number > 0);
+    for (int i = 0; i < length; ++i) {
+        output[i] = reversed[length - 1 - i];
+    }
+    return length;
+}
+
+/**
+ * The value is scaled to an integer of "precision" digits using extended
+ * precision; the result is identical to printf because the rounding is
+ * accepted only when the scaled value is far enough from a tie to absorb
+ * the error of the scaling
+ */
+size_t TextFeatureWriter::formatValue(const double value, int precision, char* output){
+    if(precision < 1)
+        precision = 1;
+    if((LDBL_MANT_DIG < 64) || (precision > MAX_PRECISION) || !std::isfinite(value))
+        return formatWithPrintf(value, precision, output);
+
+    char* position = output;
+    if(std::signbit(value))
+        *(position++) = '-';
+    if(value == 0){
+        *(position++) = '0';
+        return position - output;
+    }
+
+    long double absValue = fabsl((long double) value);
+    int exponent = (int) floor(log10(fabs(value)));
+    uint64_t lowerBound = (uint64_t) powerOfTen(precision - 1);
+    uint64_t upperBound = lowerBound * 10;
+
+    // Scale to [10^(p-1), 10^p); the estimated exponent can be off by one
+    uint64_t digits = 0;
+    bool scaled = false;
+    for (int attempt = 0; (attempt < 3) && !scaled; ++attempt) {
+        int scaleExponent = precision - 1 - exponent;
+        long double scaledValue = (scaleExponent >= 0)
+                ? absValue * powerOfTen(scaleExponent)
+                : absValue / powerOfTen(-scaleExponent);
+        long double floorValue = floorl(scaledValue);
+        long double fraction = scaledValue - floorValue;
+        // A few roundings of the extended representation happened
+        long double tolerance = scaledValue * 16 * LDBL_EPSILON;
+        if(fabsl(fraction - 0.5L) <= tolerance)
+            return formatWithPrintf(value, precision, output);
+        digits = (uint64_t) floorValue + (fraction > 0.5L ? 1 : 0);
+        if(digits >= upperBound)
+            exponent++;
+        else if(digits < lowerBound)
+            exponent--;
+        else
+            scaled = true;
+    }
+    if(!scaled)
+        return formatWithPrintf(value, precision, output);
+
+    char digitChars[24];
+    writeUnsigned(digits, digitChars);
+    // %g never shows trailing zeros
+    int significantDigits = precision;
+    while((significantDigits > 1) && (digitChars[significantDigits - 1] == '0'))
+        significantDigits--;
+
+    if((exponent < -4) || (exponent >= precision)){
+        // Scientific notation d.ddde+XX
+        *(position++) = digitChars[0];
+        if(significantDigits > 1){
+            *(position++) = '.';
+            for (int i = 1; i < significantDigits; ++i) {
+                *(position++) = digitChars[i];
+            }
+        }
+        *(position++) = 'e';
+        *(position++) = exponent < 0 ? '-' : '+';
+        int absExponent = exponent < 0 ? -exponent : exponent;
+        if(absExponent < 10)
+            *(position++) = '0';
+        position += writeUnsigned(absExponent, position);
+    }
+    else if(exponent >= 0){
+        // Integer part, then the remaining significant digits
+        for (int i = 0; i <= exponent; ++i) {
+            *(position++) = digitChars[i];
+        }
+        if(significantDigits > exponent + 1){
+            *(position++) = '.';
+            for (int i = exponent + 1; i < significantDigits; ++i) {
+                *(position++) = digitChars[i];
+            }
+        }
+    }
+    else{
+        // 0.000ddd
+        *(position++) = '0';
+        *(position++) = '.';
+        for (int i = 0; i < -exponent - 1; ++i) {
+            *(position++) = '0';
+        }
+        for (int i = 0; i < significantDigits; ++i) {
+            *(position++) = digitChars[i];
+        }
+    }
+    return position - output;
+}
+
+bool TextFeatureWriter::savePlane(const string& filePath, const double* values,
+        const size_t numberOfValues, const int columns, const bool append){
+    FILE* file = fopen((filePath + ".txt").c_str(), append ? "ab" : "wb");
+    if(file == NULL)
+        return false;
+
+    bool written = true;
+    char* chunk = buffer.data();
+    size_t chunkLength = 0;
+    for (size_t i = 0; i < numberOfValues; ++i) {
+        chunkLength += formatValue(values[i], precision, chunk + chunkLength);
+        // Rows end with a newline, otherwise each value is followed by a comma
+        if(rowLayout && (columns > 0) && (((i + 1) % columns) == 0))
+            chunk[chunkLength++] = '\n';
+        else
+            chunk[chunkLength++] = ',';
+
+        if(chunkLength >= WRITE_CHUNK_SIZE){
+            written &= (fwrite(chunk, 1, chunkLength, file) == chunkLength);
+            writtenBytes += chunkLength;
+            chunkLength = 0;
+        }
+    }
+    written &= (fwrite(chunk, 1, chunkLength, file) == chunkLength);
+    writtenBytes += chunkLength;
+    written &= (fclose(file) == 0);
+    return written;
+}
+
+size_t TextFeatureWriter::getWrittenBytes() const{
+    return writtenBytes;
+}
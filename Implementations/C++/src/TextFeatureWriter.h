@@ -0,0 +1,85 @@
+#ifndef FEATUREEXTRACTOR_TEXTFEATUREWRITER_H
+#define FEATUREEXTRACTOR_TEXTFEATUREWRITER_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * This class saves planes of feature values as text.
+ * Values are formatted like printf("%.Ng") would do, but without going
+ * through the stream/locale machinery, into a large buffer that is written
+ * to the file in big chunks
+ */
+class TextFeatureWriter {
+public:
+    /**
+     * Initialize the writer
+     * @param precision: significant digits of each value; 17 digits are
+     * always enough to read back exactly the same double
+     * @param rowLayout: end each row of windows with a newline instead of
+     * putting all the values on a single comma separated line
+     */
+    TextFeatureWriter(int precision, bool rowLayout);
+    /**
+     * Save a plane, or a band of rows of it, in the text file
+     * @param filePath: path of the file, without extension
+     * @param values: the values to save, row after row
+     * @param numberOfValues: how many values to save
+     * @param columns: how many values each row has
+     * @param append: add the values at the end of the file already present
+     * @return false if the file couldn't be written
+     */
+    bool savePlane(const string& filePath, const double* values,
+            size_t numberOfValues, int columns, bool append);
+    /**
+     * Write the textual representation of a value, same as
+     * snprintf("%.*g", precision, value)
+     * @param value: value to represent
+     * @param precision: significant digits, between 1 and 17
+     * @param output: where to put the characters; at least
+     * MAX_VALUE_LENGTH of space; no terminator is added
+     * @return how many characters were written
+     */
+    static size_t formatValue(double value, int precision, char* output);
+    /**
+     * Getter
+     * @return bytes written by all the invocations of savePlane
+     */
+    size_t getWrittenBytes() const;
+    /**
+     * Utility method
+     * @return bytes of the buffer of each writer
+     */
+    static size_t getBufferSize();
+
+    /**
+     * Characters formatted before each write to the file
+     */
+    static const int WRITE_CHUNK_SIZE = 1024 * 1024;
+    static const int MAX_VALUE_LENGTH = 32;
+    static const int MAX_PRECISION = 17;
+    static const int DEFAULT_PRECISION = 6;
+
+private:
+    /**
+     * Significant digits of each value
+     */
+    int precision;
+    /**
+     * Newline at the end of each row of windows
+     */
+    bool rowLayout;
+    /**
+     * Where values are formatted before being written; reused for each plane
+     */
+    vector<char> buffer;
+    /**
+     * Bytes written in the files so far
+     */
+    size_t writtenBytes;
+};
+
+
+#endif //FEATUREEXTRACTOR_TEXTFEATUREWRITER_H
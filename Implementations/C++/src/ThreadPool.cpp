@@ -0,0 +1,96 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int numberOfThreads)
+        : actualJob(nullptr), jobGeneration(0), pendingWorkers(0), stopping(false){
+    if(numberOfThreads < 1)
+        numberOfThreads = getAvailableCores();
+    // The calling thread will be worker 0
+    for (int i = 1; i < numberOfThreads; ++i) {
+        workers.push_back(thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        unique_lock<mutex> guard(poolLock);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+}
+
+int ThreadPool::getNumberOfThreads() const{
+    return workers.size() + 1;
+}
+
+int ThreadPool::getAvailableCores(){
+    int cores = thread::hardware_concurrency();
+    if(cores < 1)
+        cores = 1;
+    return cores;
+}
+
+void ThreadPool::run(const function<void(int)>& job){
+    {
+        unique_lock<mutex> guard(poolLock);
+        actualJob = &job;
+        pendingWorkers = workers.size();
+        jobGeneration++;
+    }
+    jobAvailable.notify_all();
+
+    // The calling thread works too
+    try{
+        job(0);
+    }
+    catch (...) {
+        keepJobError();
+    }
+
+    unique_lock<mutex> guard(poolLock);
+    jobCompleted.wait(guard, [this]{ return pendingWorkers == 0; });
+    actualJob = nullptr;
+    if(jobError){
+        exception_ptr error = jobError;
+        jobError = nullptr;
+        rethrow_exception(error);
+    }
+}
+
+void ThreadPool::keepJobError(){
+    unique_lock<mutex> guard(poolLock);
+    if(!jobError)
+        jobError = current_exception();
+}
+
+void ThreadPool::workerLoop(const int workerIndex){
+    unsigned long lastExecutedGeneration = 0;
+    while(true){
+        const function<void(int)>* job;
+        {
+            unique_lock<mutex> guard(poolLock);
+            jobAvailable.wait(guard, [this, lastExecutedGeneration]{
+                return stopping || (jobGeneration != lastExecutedGeneration);
+            });
+            if(stopping)
+                return;
+            lastExecutedGeneration = jobGeneration;
+            job = actualJob;
+        }
+
+        try{
+            (*job)(workerIndex);
+        }
+        catch (...) {
+            keepJobError();
+        }
+
+        {
+            unique_lock<mutex> guard(poolLock);
+            pendingWorkers--;
+        }
+        jobCompleted.notify_one();
+    }
+}
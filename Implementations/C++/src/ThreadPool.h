@@ -0,0 +1,83 @@
+#ifndef FEATUREEXTRACTOR_THREADPOOL_H
+#define FEATUREEXTRACTOR_THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+using namespace std;
+
+/**
+ * Fixed set of worker threads that are created once and reused for every
+ * parallel job, so that nothing has to be spawned for each image/window.
+ * The calling thread takes part in every job as worker 0
+ */
+class ThreadPool {
+public:
+    /**
+     * Create the pool
+     * @param numberOfThreads: total workers, calling thread included;
+     * values < 1 mean "as many as the cores of the machine"
+     */
+    explicit ThreadPool(int numberOfThreads);
+    ~ThreadPool();
+    /**
+     * Execute the job on every worker and wait for all of them to finish
+     * @param job: function that receives the index of the worker that is
+     * running it, in [0, getNumberOfThreads())
+     * @throws the first exception thrown by the job in any worker, once all
+     * of them finished
+     */
+    void run(const function<void(int)>& job);
+    /**
+     * Getter
+     * @return how many workers execute each job
+     */
+    int getNumberOfThreads() const;
+    /**
+     * Utility method
+     * @return how many hardware threads the machine offers (at least 1)
+     */
+    static int getAvailableCores();
+
+private:
+    /**
+     * Threads other than the calling one
+     */
+    vector<thread> workers;
+    mutex poolLock;
+    condition_variable jobAvailable;
+    condition_variable jobCompleted;
+    /**
+     * Job actually executing; valid only while run() is active
+     */
+    const function<void(int)>* actualJob;
+    /**
+     * Incremented at every run() so that sleeping workers detect a new job
+     */
+    unsigned long jobGeneration;
+    /**
+     * How many workers didn't finish the actual job yet
+     */
+    int pendingWorkers;
+    /**
+     * First exception thrown by the actual job, given back by run()
+     */
+    exception_ptr jobError;
+    bool stopping;
+    /**
+     * Body of each spawned thread
+     * @param workerIndex: index passed to each job executed by this thread
+     */
+    void workerLoop(int workerIndex);
+    /**
+     * Keep the exception being handled, if it is the first of the job
+     */
+    void keepJobError();
+};
+
+
+#endif //FEATUREEXTRACTOR_THREADPOOL_H
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include "TileScheduler.h"
+
+const int TileScheduler::DEFAULT_TILE_SIDE;
+
+TileScheduler::TileScheduler(const int rows, const int columns,
+        int numberOfWorkers, const int tileSide): queues(max(numberOfWorkers, 1)){
+    numberOfWorkers = queues.size();
+    // Linearize the tiles in row-major order
+    vector<Tile> allTiles;
+    for (int i = 0; i < rows; i += tileSide) {
+        for (int j = 0; j < columns; j += tileSide) {
+            Tile tile = {i, min(i + tileSide, rows), j, min(j + tileSide, columns)};
+            allTiles.push_back(tile);
+        }
+    }
+    numberOfTiles = allTiles.size();
+
+    // Each worker gets a contiguous run of tiles to preserve locality
+    for (int w = 0; w < numberOfWorkers; ++w) {
+        size_t first = (allTiles.size() * w) / numberOfWorkers;
+        size_t last = (allTiles.size() * (w + 1)) / numberOfWorkers;
+        queues[w].tiles.assign(allTiles.begin() + first, allTiles.begin() + last);
+    }
+}
+
+int TileScheduler::getNumberOfTiles() const{
+    return numberOfTiles;
+}
+
+bool TileScheduler::getNextTile(const int workerIndex, Tile& tile){
+    if(popOwnTile(workerIndex, tile))
+        return true;
+    return stealTile(workerIndex, tile);
+}
+
+bool TileScheduler::popOwnTile(const int workerIndex, Tile& tile){
+    WorkerQueue& own = queues[workerIndex];
+    lock_guard<mutex> guard(own.queueLock);
+    if(own.tiles.empty())
+        return false;
+    tile = own.tiles.front();
+    own.tiles.pop_front();
+    return true;
+}
+
+bool TileScheduler::stealTile(const int thiefIndex, Tile& tile){
+    int numberOfWorkers = queues.size();
+    // Visit the other workers starting from the next one
+    for (int k = 1; k < numberOfWorkers; ++k) {
+        WorkerQueue& victim = queues[(thiefIndex + k) % numberOfWorkers];
+        lock_guard<mutex> guard(victim.queueLock);
+        if(!victim.tiles.empty()){
+            tile = victim.tiles.back();
+            victim.tiles.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
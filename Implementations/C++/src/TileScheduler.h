@@ -0,0 +1,73 @@
+#ifndef FEATUREEXTRACTOR_TILESCHEDULER_H
+#define FEATUREEXTRACTOR_TILESCHEDULER_H
+
+#include <vector>
+#include <deque>
+#include <mutex>
+
+using namespace std;
+
+/**
+ * Rectangular block of windows of the image, identified by the first
+ * (included) and last (excluded) row and column of the windows that belong
+ * to it
+ */
+struct Tile {
+    int firstRow;
+    int lastRow;
+    int firstColumn;
+    int lastColumn;
+};
+
+/**
+ * This class splits the grid of windows of the image into tiles and hands
+ * them out to the workers.
+ * Each worker initially owns a contiguous run of tiles; when it runs out of
+ * them it steals from the other workers, so that workers that got cheap
+ * tiles (ex. flat background) help the ones that got textured areas
+ */
+class TileScheduler {
+public:
+    /**
+     * Split the grid and assign the tiles to the workers
+     * @param rows: how many rows of windows need to be computed
+     * @param columns: how many columns of windows need to be computed
+     * @param numberOfWorkers: how many workers will ask for tiles
+     * @param tileSide: side of each tile, in windows
+     */
+    TileScheduler(int rows, int columns, int numberOfWorkers,
+            int tileSide = DEFAULT_TILE_SIDE);
+    /**
+     * Give the worker the next tile to compute; first from its own tiles
+     * then stealing from the other workers
+     * @param workerIndex: which worker is asking
+     * @param tile: where the tile will be put
+     * @return false when every tile of the grid was already assigned
+     */
+    bool getNextTile(int workerIndex, Tile& tile);
+    /**
+     * Getter
+     * @return how many tiles the grid was split into
+     */
+    int getNumberOfTiles() const;
+
+    static const int DEFAULT_TILE_SIDE = 32;
+
+private:
+    /**
+     * Tiles still owned by a worker; the owner pops from the front, thieves
+     * from the back, so they don't contend for the same tiles
+     */
+    struct WorkerQueue {
+        mutex queueLock;
+        deque<Tile> tiles;
+    };
+    vector<WorkerQueue> queues;
+    int numberOfTiles;
+
+    bool popOwnTile(int workerIndex, Tile& tile);
+    bool stealTile(int thiefIndex, Tile& tile);
+};
+
+
+#endif //FEATUREEXTRACTOR_TILESCHEDULER_H
@@ -1,4 +1,5 @@
 
+#include <unistd.h>
 #include "Utils.h"
 
 /* Support code for putting the results in the right output folder */
@@ -31,4 +32,158 @@ string Utils::removeExtension( std::string const& filename ){
     return pivot == filename.rend()
            ? filename
            : std::string( filename.begin(), pivot.base() - 1 );
-}
\ No newline at end of file
+}
+bool Utils::isDirectory(const string& path){
+    struct stat info;
+    return (stat(path.c_str(), &info) == 0) && S_ISDIR(info.st_mode);
+}
+
+size_t Utils::getFileSize(const string& path){
+    struct stat info;
+    if(stat(path.c_str(), &info) != 0)
+        return 0;
+    return info.st_size;
+}
+
+// images of a folder or paths listed in a text file
+vector<string> Utils::listBatchImages(const string& batchPath){
+    vector<string> imagePaths;
+    if(isDirectory(batchPath)){
+        // Only the files with the extension of an image format
+        const char* imageExtensions[] = {".tif", ".tiff", ".png", ".jpg",
+                ".jpeg", ".bmp", ".pgm", ".pnm", ".ppm", ".dcm"};
+        DIR* folder = opendir(batchPath.c_str());
+        if(folder == NULL){
+            cerr << "cannot open the batch folder: " << batchPath << endl
+                 << "error:" << strerror(errno) << endl;
+            return imagePaths;
+        }
+        struct dirent* entry;
+        while((entry = readdir(folder)) != NULL){
+            string fileName = entry->d_name;
+            size_t dot = fileName.rfind('.');
+            if(dot == string::npos)
+                continue;
+            string extension = fileName.substr(dot);
+            transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+            for (size_t i = 0; i < sizeof(imageExtensions) / sizeof(imageExtensions[0]); ++i) {
+                if(extension == imageExtensions[i]){
+                    imagePaths.push_back(batchPath + "/" + fileName);
+                    break;
+                }
+            }
+        }
+        closedir(folder);
+        sort(imagePaths.begin(), imagePaths.end());
+        return imagePaths;
+    }
+
+    ifstream listFile(batchPath.c_str());
+    if(!listFile.is_open()){
+        cerr << "cannot open the batch list: " << batchPath << endl;
+        return imagePaths;
+    }
+    string line;
+    while(getline(listFile, line)){
+        // Trim the spaces around the path
+        size_t first = line.find_first_not_of(" \t\r");
+        if((first == string::npos) || (line[first] == '#'))
+            continue;
+        size_t last = line.find_last_not_of(" \t\r");
+        imagePaths.push_back(line.substr(first, last - first + 1));
+    }
+    return imagePaths;
+}
+
+/**
+ * Utility method
+ * @param path: file that starts with a number, like the ones of /sys
+ * @param value: where the number is put
+ * @return false if the file can't be read or doesn't start with a number
+ * (ex. "max", no limit, in the files of the cgroups v2)
+ */
+static bool readNumberFile(const string& path, unsigned long long& value){
+    ifstream file(path.c_str());
+    return (bool) (file >> value);
+}
+
+unsigned long long Utils::getAvailableMemory(){
+    unsigned long long available = 0;
+    ifstream memoryInfo("/proc/meminfo");
+    string key;
+    unsigned long long kilobytes;
+    string unit;
+    while(memoryInfo >> key >> kilobytes >> unit){
+        if(key == "MemAvailable:"){
+            available = kilobytes << 10;
+            break;
+        }
+    }
+
+    // Limit of the cgroup of a container or a job, and what it already uses
+    const char* limitFiles[] = {"/sys/fs/cgroup/memory.max",
+                                "/sys/fs/cgroup/memory/memory.limit_in_bytes"};
+    const char* usageFiles[] = {"/sys/fs/cgroup/memory.current",
+                                "/sys/fs/cgroup/memory/memory.usage_in_bytes"};
+    for (int i = 0; i < 2; ++i) {
+        unsigned long long limit;
+        unsigned long long usage;
+        if(!readNumberFile(limitFiles[i], limit) || !readNumberFile(usageFiles[i], usage))
+            continue;
+        // Without a limit, v1 reports a number near 2^63
+        if(limit >= (1ull << 62))
+            continue;
+        unsigned long long left = (limit > usage) ? limit - usage : 0;
+        if((available == 0) || (left < available))
+            available = left;
+        break;
+    }
+    return available;
+}
+
+unsigned long long Utils::getResidentMemory(){
+    // Pages of the whole program, then the resident ones
+    ifstream status("/proc/self/statm");
+    unsigned long long pages;
+    unsigned long long residentPages;
+    if(!(status >> pages >> residentPages))
+        return 0;
+    return residentPages * sysconf(_SC_PAGESIZE);
+}
+
+// 64 bit FNV-1a
+uint64_t Utils::hashBytes(uint64_t hash, const void* data, const size_t length){
+    const uint64_t fnvPrime = 1099511628211ull;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= fnvPrime;
+    }
+    return hash;
+}
+
+string Utils::hashToString(const uint64_t hash){
+    char digits[17];
+    snprintf(digits, sizeof(digits), "%016llx", (unsigned long long) hash);
+    return digits;
+}
+
+string Utils::toJsonString(const string& text){
+    string escaped = "\"";
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char character = text[i];
+        if((character == '"') || (character == '\\')){
+            escaped += '\\';
+            escaped += character;
+        }
+        else if(character < 0x20){
+            // Control characters only as their code
+            char code[7];
+            snprintf(code, sizeof(code), "\\u%04x", character);
+            escaped += code;
+        }
+        else
+            escaped += character;
+    }
+    return escaped + "\"";
+}
@@ -6,7 +6,11 @@
 #include <iostream>
 #include <cstring>
 #include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <fstream>
 #include <sys/stat.h> // file system interaction
+#include <dirent.h>
 
 
 using namespace std;
@@ -40,6 +44,69 @@ public:
      * @return
      */
     static string removeExtension( std::string const& filename );
+    /**
+     * Tells if the path is an existing folder
+     * @param path
+     * @return
+     */
+    static bool isDirectory(const string& path);
+    /**
+     * Size of a file
+     * @param path
+     * @return bytes of the file; 0 if it can't be read
+     */
+    static size_t getFileSize(const string& path);
+    /**
+     * Find the images to process in batch mode
+     * @param batchPath: a folder, whose image files are taken in
+     * alphabetical order, or a text file with the path of an image on each
+     * line; empty lines and lines starting with # are skipped
+     * @return the paths of the images
+     */
+    static vector<string> listBatchImages(const string& batchPath);
+
+    // System resources
+    /**
+     * Memory that this process can still allocate: the smallest between
+     * the memory available on the system (MemAvailable of /proc/meminfo)
+     * and what is left of the limit of its cgroup (v2 or v1), when it has one
+     * @return the bytes; 0 if they can't be read
+     */
+    static unsigned long long getAvailableMemory();
+    /**
+     * Memory used by this process: code, libraries and allocated data
+     * @return the resident bytes; 0 if they can't be read
+     */
+    static unsigned long long getResidentMemory();
+
+    // Identification of contents
+    /**
+     * Initial value of the hashes computed with hashBytes
+     */
+    static const uint64_t HASH_OFFSET_BASIS = 14695981039346656037ull;
+    /**
+     * Add some bytes to a 64 bit FNV-1a hash
+     * @param hash: value of the hash of the previous bytes
+     * @param data: bytes to add
+     * @param length: how many bytes
+     * @return the updated value of the hash
+     */
+    static uint64_t hashBytes(uint64_t hash, const void* data, size_t length);
+    /**
+     * Representation of a hash usable in file names
+     * @param hash
+     * @return the 16 hexadecimal digits of the hash
+     */
+    static string hashToString(uint64_t hash);
+
+    // Output formats
+    /**
+     * Text value of a JSON file
+     * @param text: any text, ex. a path
+     * @return the text between quotes, with quotes, backslashes and
+     * control characters escaped
+     */
+    static string toJsonString(const string& text);
 };
 
 
@@ -0,0 +1,159 @@
+#include <cstdlib>
+#include "VolumeFeatureComputer.h"
+#include "FeatureComputer.h"
+#include "TileScheduler.h"
+
+VolumeFeatureComputer::VolumeFeatureComputer(const ProgramArguments& progArg,
+        ThreadPool& workers, PhaseTimes* phaseTimes, ProgressReporter* progress):
+        progArg(progArg), workers(workers), phaseTimes(phaseTimes),
+        progress(progress), direction(progArg.directionType){
+    sliceSpan = progArg.distance * abs(direction.shiftSlices);
+    rowSpan = progArg.distance * abs(direction.shiftRows);
+    columnSpan = progArg.distance * abs(direction.shiftColumns);
+}
+
+int VolumeFeatureComputer::getNumberOfPairsInWindow() const{
+    int side = progArg.windowSize;
+    int numberOfPairs = (side - sliceSpan) * (side - rowSpan) * (side - columnSpan);
+    if(progArg.symmetric)
+        numberOfPairs *= 2;
+    return numberOfPairs;
+}
+
+/**
+ * A pair belongs to a window when its lowest corner (the smallest
+ * coordinates of its 2 voxels on each axis) is in a box as big as the window
+ * minus the span of the pair; the reference voxel is at the corner or, on
+ * the axes where the direction is negative, at the opposite side of the span
+ */
+void VolumeFeatureComputer::updatePairs(SlidingGLCM& glcm,
+        const unsigned int* voxels, const ImageData& volumeData,
+        const int firstSlice, const int firstRow, const int firstColumn,
+        const int slices, const int rows, const int columns, const bool add) const{
+    size_t rowSize = volumeData.getColumns();
+    size_t sliceSize = rowSize * volumeData.getRows();
+    int distance = progArg.distance;
+    size_t referenceShift = ((direction.shiftSlices < 0) ? sliceSpan : 0) * sliceSize
+            + ((direction.shiftRows < 0) ? rowSpan : 0) * rowSize
+            + ((direction.shiftColumns < 0) ? columnSpan : 0);
+    ptrdiff_t neighborShift = distance * (direction.shiftSlices * (ptrdiff_t) sliceSize
+            + direction.shiftRows * (ptrdiff_t) rowSize + direction.shiftColumns);
+
+    for (int z = firstSlice; z < firstSlice + slices; ++z) {
+        for (int y = firstRow; y < firstRow + rows; ++y) {
+            const unsigned int* reference = voxels + z * sliceSize + y * rowSize
+                    + firstColumn + referenceShift;
+            for (int x = 0; x < columns; ++x) {
+                // Application limit: only up to 2^16 gray levels
+                grayLevelType referenceGrayLevel = reference[x];
+                grayLevelType neighborGrayLevel = reference[x + neighborShift];
+                if(add)
+                    glcm.addPair(referenceGrayLevel, neighborGrayLevel);
+                else
+                    glcm.removePair(referenceGrayLevel, neighborGrayLevel);
+            }
+        }
+    }
+}
+
+FeaturePlanes VolumeFeatureComputer::computeAllFeatures(const unsigned int* voxels,
+        const ImageData& volumeData){
+    int borders = volumeData.getBorderSize();
+    int slices = volumeData.getSlices() - 2 * borders;
+    int rows = volumeData.getRows() - 2 * borders;
+    int columns = volumeData.getColumns() - 2 * borders;
+    int side = progArg.windowSize;
+
+    // The volume of each feature is a plane with the slices one below the other
+    FeaturePlanes featurePlanes(slices * rows, columns, 1);
+
+    /* If no border is applied, windows on the borders need to be excluded
+     * because no pixel pair are available, as it happens for images */
+    int computedSlices = slices;
+    int computedRows = rows;
+    int computedColumns = columns;
+    if(progArg.borderType == 0){
+        computedSlices = max(0, slices - side);
+        computedRows = max(0, rows - side);
+        computedColumns = max(0, columns - side);
+    }
+
+    // Size of the box of the lowest corners of the pairs of a window
+    int boxSlices = side - sliceSpan;
+    int boxRows = side - rowSpan;
+    int boxColumns = side - columnSpan;
+    int numberOfPairs = getNumberOfPairsInWindow();
+    int numberOfCountedPairs = boxSlices * boxRows * boxColumns;
+
+    // Each row of tiles is a row of windows of a slice
+    TileScheduler scheduler(computedSlices * computedRows, computedColumns,
+            workers.getNumberOfThreads());
+
+    workers.run([&](int workerIndex){
+        WorkArea wa = WorkArea::allocate(numberOfPairs, &featurePlanes);
+        SlidingGLCM slidingGlcm(numberOfCountedPairs, progArg.symmetric);
+        vector<GrayPair> countedPairs(numberOfCountedPairs);
+        Window windowData(side, progArg.distance, progArg.directionType, progArg.symmetric);
+        windowData.setDirectionShifts(direction.shiftRows, direction.shiftColumns,
+                direction.shiftSlices);
+        bool timed = (phaseTimes != NULL);
+        uint64_t glcmNanoseconds = 0;
+        uint64_t featuresNanoseconds = 0;
+
+        Tile tile;
+        while(scheduler.getNextTile(workerIndex, tile)){
+            for (int i = tile.firstRow; i < tile.lastRow; ++i) {
+                int z = i / computedRows;
+                int y = i % computedRows;
+                for (int x = tile.firstColumn; x < tile.lastColumn; ++x) {
+                    uint64_t start = timed ? PhaseTimes::now() : 0;
+                    if(x == tile.firstColumn){
+                        // First window of the row: all its pairs
+                        slidingGlcm.clear();
+                        updatePairs(slidingGlcm, voxels, volumeData, z + borders,
+                                y + borders, x + borders, boxSlices, boxRows,
+                                boxColumns, true);
+                    }
+                    else{
+                        // The first column of pairs leaves, a new last one enters
+                        updatePairs(slidingGlcm, voxels, volumeData, z + borders,
+                                y + borders, x - 1 + borders, boxSlices, boxRows,
+                                1, false);
+                        updatePairs(slidingGlcm, voxels, volumeData, z + borders,
+                                y + borders, x + borders + boxColumns - 1,
+                                boxSlices, boxRows, 1, true);
+                    }
+                    windowData.setSpacialOffsets(y + borders, x + borders, z + borders);
+
+                    // Same extraction of the features of the images
+                    int differentPairs = slidingGlcm.getPairs(countedPairs.data());
+                    GLCM glcm(countedPairs.data(), differentPairs, numberOfPairs,
+                            volumeData, windowData, wa);
+                    uint64_t built = timed ? PhaseTimes::now() : 0;
+                    double features[IMOC + 1];
+                    FeatureComputer::extractFeatures(glcm, features);
+
+                    size_t outputOffset = ((size_t) z * rows + y) * columns + x;
+                    for (int f = 0; f <= IMOC; ++f) {
+                        featurePlanes.getPlane((FeatureNames) f, 0)[outputOffset] = features[f];
+                    }
+                    if(timed){
+                        glcmNanoseconds += built - start;
+                        featuresNanoseconds += PhaseTimes::now() - built;
+                    }
+                }
+                if(progress != NULL)
+                    progress->addWindows(tile.lastColumn - tile.firstColumn);
+            }
+        }
+        wa.release();
+        if(timed){
+            phaseTimes->add(GLCM_PHASE, glcmNanoseconds);
+            phaseTimes->add(FEATURES_PHASE, featuresNanoseconds);
+        }
+    });
+    if(phaseTimes != NULL)
+        phaseTimes->addWindows((uint64_t) computedSlices * computedRows * computedColumns);
+
+    return featurePlanes;
+}
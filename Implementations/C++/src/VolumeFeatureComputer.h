@@ -0,0 +1,82 @@
+#ifndef FEATUREEXTRACTOR_VOLUMEFEATURECOMPUTER_H
+#define FEATUREEXTRACTOR_VOLUMEFEATURECOMPUTER_H
+
+#include "ProgramArguments.h"
+#include "ImageData.h"
+#include "FeaturePlanes.h"
+#include "SlidingGLCM.h"
+#include "ThreadPool.h"
+#include "Direction.h"
+#include "PhaseTimes.h"
+#include "ProgressReporter.h"
+
+using namespace std;
+
+/**
+ * This class computes the features of every cubic window of a volume (the
+ * slices of a MRI study), in 1 of the 13 directions of the space.
+ * Windows of the same row are visited left to right and their GLCM is
+ * updated incrementally: moving the window by 1 column only the pairs of the
+ * slab that leaves it and of the slab that enters it are processed, instead
+ * of all the pairs of the cube
+ */
+class VolumeFeatureComputer {
+public:
+    /**
+     * Initialize the class
+     * @param progArg: parameters of the problem; directionType in [1, 13]
+     * @param workers: threads that will compute the windows
+     * @param phaseTimes: where the time of the windows is added; NULL when
+     * not measured
+     * @param progress: where the computed windows are added, row after row;
+     * NULL when not reported
+     */
+    VolumeFeatureComputer(const ProgramArguments& progArg, ThreadPool& workers,
+            PhaseTimes* phaseTimes = NULL, ProgressReporter* progress = NULL);
+    /**
+     * This method will compute all the features for every cubic window of
+     * the volume
+     * @param voxels: intensities of the bordered volume, slice after slice
+     * @param volumeData: metadata of the bordered volume (rows and columns of
+     * each slice, slices, borders)
+     * @return the planes of (slices * rows) x columns values: each is the
+     * volume of 1 feature, slice after slice
+     */
+    FeaturePlanes computeAllFeatures(const unsigned int* voxels,
+            const ImageData& volumeData);
+    /**
+     * Utility method
+     * @return how many pixel pairs each cubic window has (doubled if
+     * symmetric)
+     */
+    int getNumberOfPairsInWindow() const;
+
+private:
+    ProgramArguments progArg;
+    ThreadPool& workers;
+    PhaseTimes* phaseTimes;
+    ProgressReporter* progress;
+    Direction direction;
+    /**
+     * Span of each pair on the 3 axes (slices, rows, columns)
+     */
+    int sliceSpan;
+    int rowSpan;
+    int columnSpan;
+    /**
+     * Add (or remove) to the GLCM the pairs whose lowest corner is in the
+     * given box of the volume
+     * @param glcm: where the pairs are counted
+     * @param voxels: intensities of the bordered volume
+     * @param volumeData: metadata of the bordered volume
+     * @param firstSlice, firstRow, firstColumn: corner of the box
+     * @param slices, rows, columns: size of the box
+     * @param add: true for adding the pairs, false for removing them
+     */
+    void updatePairs(SlidingGLCM& glcm, const unsigned int* voxels,
+            const ImageData& volumeData, int firstSlice, int firstRow,
+            int firstColumn, int slices, int rows, int columns, bool add) const;
+};
+
+
+#endif //FEATUREEXTRACTOR_VOLUMEFEATURECOMPUTER_H
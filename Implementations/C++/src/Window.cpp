@@ -6,14 +6,21 @@ Window::Window(const short int dimension, const short int distance,
 	this->distance = distance;
 	this->symmetric = symmetric;
 	this->directionType = dirNumber;
+	// Planes have a single slice
+	this->shiftSlices = 0;
+	this->imageSlicesOffset = 0;
 }
 
-void Window::setDirectionShifts(const int shiftRows, const int shiftColumns){
+void Window::setDirectionShifts(const int shiftRows, const int shiftColumns,
+		const int shiftSlices){
 	this->shiftRows = shiftRows;
 	this->shiftColumns = shiftColumns;
+	this->shiftSlices = shiftSlices;
 }
 
-void Window::setSpacialOffsets(const int rowOffset, const int columnOffset){
+void Window::setSpacialOffsets(const int rowOffset, const int columnOffset,
+		const int sliceOffset){
 	this->imageRowsOffset = rowOffset;
 	this->imageColumnsOffset = columnOffset;
+	this->imageSlicesOffset = sliceOffset;
 }
@@ -48,10 +48,15 @@ public:
      */
     int shiftColumns;
     /**
-     * Acquire both shifts on the x and y axis to locate the neighbor pixel of
-     * the pair
+     * shift on the z axis to locate the neighbor pixel; only volumes
+     * have it
      */
-    void setDirectionShifts(int shiftRows, int shiftColumns);
+    int shiftSlices;
+    /**
+     * Acquire both shifts on the x and y axis, and the one on the z axis of
+     * volumes, to locate the neighbor pixel of the pair
+     */
+    void setDirectionShifts(int shiftRows, int shiftColumns, int shiftSlices = 0);
 
     // Offset to locate the starting point of the window inside the entire image
     /**
@@ -63,9 +68,14 @@ public:
      */
     int imageColumnsOffset;
     /**
-     * Acquire both shift that tells the window starting point in the image
+     * First slice of the volume that belongs to this cubic window
+     */
+    int imageSlicesOffset;
+    /**
+     * Acquire both shift that tells the window starting point in the image;
+     * volumes also tell the starting slice
      */
-    void setSpacialOffsets(int rowOffset, int columnOffset);
+    void setSpacialOffsets(int rowOffset, int columnOffset, int sliceOffset = 0);
 };
 
 
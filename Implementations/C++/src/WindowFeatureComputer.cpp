@@ -1,6 +1,6 @@
 #include "WindowFeatureComputer.h"
 
-WindowFeatureComputer::WindowFeatureComputer(unsigned int * pxls,
+WindowFeatureComputer::WindowFeatureComputer(const unsigned int * pxls,
 		const ImageData& img, const Window& wd, WorkArea& wa): pixels(pxls),
 		image(img), windowData(wd), workArea(wa){
 	computeWindowFeatures();
@@ -14,6 +14,7 @@ void WindowFeatureComputer::computeWindowFeatures() {
     // Get shift vector for each direction of interest
     Direction actualDir = Direction(windowData.directionType);
     // create the autonomous thread of computation
+    // Only 1 direction is computed at this release; it has the first planes
     FeatureComputer fc(pixels, image, actualDir.shiftRows, actualDir.shiftColumns,
-						   windowData, workArea);
+						   windowData, workArea, 0);
 }
@@ -4,17 +4,6 @@
 #include "FeatureComputer.h"
 #include "Direction.h"
 
-/**
- * Array of all the features that can be extracted simultaneously from a
- * window
- */
-typedef vector<double> WindowFeatures;
-/**
- * Array of all the features that can be extracted simultaneously from a
- * direction in a window
- */
-typedef vector<double> FeatureValues;
-
 using namespace std;
 
 /**
@@ -33,7 +22,7 @@ public:
      * @param wa: memory location where this object will create the arrays of
      * representation needed for computing its features
      */
-    WindowFeatureComputer(unsigned int * pixels, const ImageData& img, const Window& wd, WorkArea& wa);
+    WindowFeatureComputer(const unsigned int * pixels, const ImageData& img, const Window& wd, WorkArea& wa);
     /**
      * Computed features in the direction specified
      */
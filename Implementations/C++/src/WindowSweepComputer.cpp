@@ -0,0 +1,183 @@
+#include <cstdlib>
+#include "WindowSweepComputer.h"
+#include "FeatureComputer.h"
+#include "TileScheduler.h"
+
+WindowSweepComputer::WindowSweepComputer(const ProgramArguments& progArg,
+        const vector<short int>& windowSizes, ThreadPool& workers,
+        PhaseTimes* phaseTimes, ProgressReporter* progress): progArg(progArg),
+        windowSizes(windowSizes), workers(workers), phaseTimes(phaseTimes),
+        progress(progress), direction(progArg.directionType){
+    int rowSpan = progArg.distance * abs(direction.shiftRows);
+    int columnSpan = progArg.distance * abs(direction.shiftColumns);
+    for (size_t k = 0; k < windowSizes.size(); ++k) {
+        boxRows.push_back(max(0, windowSizes[k] - rowSpan));
+        boxColumns.push_back(max(0, windowSizes[k] - columnSpan));
+    }
+}
+
+/**
+ * A pair belongs to a window when its lowest corner (the smallest
+ * coordinates of its 2 pixels) is in an area as big as the window minus the
+ * span of the pair; the reference pixel is at the corner or, on the axes
+ * where the direction is negative, at the opposite side of the span
+ */
+void WindowSweepComputer::updatePairs(SlidingGLCM& glcm,
+        const unsigned int* pixels, const ImageData& img, const int firstRow,
+        const int firstColumn, const int rows, const int columns,
+        const bool add) const{
+    size_t rowSize = img.getColumns();
+    int distance = progArg.distance;
+    size_t referenceShift = ((direction.shiftRows < 0) ? distance : 0) * rowSize
+            + ((direction.shiftColumns < 0) ? distance : 0);
+    ptrdiff_t neighborShift = distance * (direction.shiftRows * (ptrdiff_t) rowSize
+            + direction.shiftColumns);
+
+    for (int y = firstRow; y < firstRow + rows; ++y) {
+        const unsigned int* reference = pixels + y * rowSize + firstColumn
+                + referenceShift;
+        for (int x = 0; x < columns; ++x) {
+            // Application limit: only up to 2^16 gray levels
+            grayLevelType referenceGrayLevel = reference[x];
+            grayLevelType neighborGrayLevel = reference[x + neighborShift];
+            if(add)
+                glcm.addPair(referenceGrayLevel, neighborGrayLevel);
+            else
+                glcm.removePair(referenceGrayLevel, neighborGrayLevel);
+        }
+    }
+}
+
+vector<FeaturePlanes> WindowSweepComputer::computeAllFeatures(
+        const unsigned int* pixels, const ImageData& img){
+    int borders = img.getBorderSize();
+    int rows = img.getRows() - 2 * borders;
+    int columns = img.getColumns() - 2 * borders;
+    int numberOfSizes = windowSizes.size();
+
+    vector<FeaturePlanes> featurePlanes;
+    for (int k = 0; k < numberOfSizes; ++k) {
+        featurePlanes.push_back(FeaturePlanes(rows, columns, 1));
+    }
+
+    /* If no border is applied, windows on the borders need to be excluded
+     * because no pixel pair are available; the smallest windows reach
+     * farther than the others */
+    int computedRows = rows;
+    int computedColumns = columns;
+    if(progArg.borderType == 0){
+        computedRows = max(0, rows - windowSizes[0]);
+        computedColumns = max(0, columns - windowSizes[0]);
+    }
+
+    int largestPairs = boxRows.back() * boxColumns.back();
+    TileScheduler scheduler(computedRows, computedColumns,
+            workers.getNumberOfThreads());
+
+    workers.run([&](int workerIndex){
+        // Each size has its own work area, as small as its windows
+        vector<WorkArea> workAreas;
+        for (int k = 0; k < numberOfSizes; ++k) {
+            workAreas.push_back(WorkArea::allocate(boxRows[k] * boxColumns[k]
+                    * (progArg.symmetric ? 2 : 1), NULL));
+        }
+        // All the tables have room for the largest window, so they can be copied
+        vector<SlidingGLCM> slidingGlcms(numberOfSizes,
+                SlidingGLCM(largestPairs, progArg.symmetric));
+        vector<GrayPair> countedPairs(largestPairs);
+        bool timed = (phaseTimes != NULL);
+        uint64_t glcmNanoseconds = 0;
+        uint64_t featuresNanoseconds = 0;
+        uint64_t computedWindows = 0;
+
+        Tile tile;
+        while(scheduler.getNextTile(workerIndex, tile)){
+            for (int y = tile.firstRow; y < tile.lastRow; ++y) {
+                int firstRow = y + borders;
+                uint64_t rowStartWindows = computedWindows;
+                /* Without borders, the larger windows stop fitting in the
+                 * image before the smaller ones */
+                int fittingSizes = numberOfSizes;
+                for (int x = tile.firstColumn; x < tile.lastColumn; ++x) {
+                    // The updates of the pairs are part of the glcm of the windows
+                    uint64_t mark = timed ? PhaseTimes::now() : 0;
+                    int firstColumn = x + borders;
+                    if(progArg.borderType == 0){
+                        while((fittingSizes > 0)
+                              && ((y >= rows - windowSizes[fittingSizes - 1])
+                                  || (x >= columns - windowSizes[fittingSizes - 1])))
+                            fittingSizes--;
+                    }
+
+                    if(x == tile.firstColumn){
+                        // Smallest window, then the ring around each next one
+                        slidingGlcms[0].clear();
+                        updatePairs(slidingGlcms[0], pixels, img, firstRow,
+                                firstColumn, boxRows[0], boxColumns[0], true);
+                        for (int k = 1; k < fittingSizes; ++k) {
+                            slidingGlcms[k] = slidingGlcms[k - 1];
+                            updatePairs(slidingGlcms[k], pixels, img, firstRow,
+                                    firstColumn + boxColumns[k - 1], boxRows[k],
+                                    boxColumns[k] - boxColumns[k - 1], true);
+                            updatePairs(slidingGlcms[k], pixels, img,
+                                    firstRow + boxRows[k - 1], firstColumn,
+                                    boxRows[k] - boxRows[k - 1], boxColumns[k - 1], true);
+                        }
+                    }
+                    else{
+                        // The first column of pairs leaves, a new last one enters
+                        for (int k = 0; k < fittingSizes; ++k) {
+                            updatePairs(slidingGlcms[k], pixels, img, firstRow,
+                                    firstColumn - 1, boxRows[k], 1, false);
+                            updatePairs(slidingGlcms[k], pixels, img, firstRow,
+                                    firstColumn + boxColumns[k] - 1, boxRows[k], 1, true);
+                        }
+                    }
+
+                    size_t outputOffset = (size_t) y * columns + x;
+                    for (int k = 0; k < fittingSizes; ++k) {
+                        Window windowData(windowSizes[k], progArg.distance,
+                                progArg.directionType, progArg.symmetric);
+                        windowData.setDirectionShifts(direction.shiftRows,
+                                direction.shiftColumns);
+                        windowData.setSpacialOffsets(firstRow, firstColumn);
+
+                        // Same extraction of the features of the single windows
+                        int differentPairs = slidingGlcms[k].getPairs(countedPairs.data());
+                        GLCM glcm(countedPairs.data(), differentPairs,
+                                workAreas[k].numberOfElements, img, windowData,
+                                workAreas[k]);
+                        if(timed){
+                            uint64_t built = PhaseTimes::now();
+                            glcmNanoseconds += built - mark;
+                            mark = built;
+                        }
+                        double features[IMOC + 1];
+                        FeatureComputer::extractFeatures(glcm, features);
+                        for (int f = 0; f <= IMOC; ++f) {
+                            featurePlanes[k].getPlane((FeatureNames) f, 0)[outputOffset] = features[f];
+                        }
+                        if(timed){
+                            uint64_t extracted = PhaseTimes::now();
+                            featuresNanoseconds += extracted - mark;
+                            mark = extracted;
+                        }
+                    }
+                    computedWindows += fittingSizes;
+                }
+                if(progress != NULL)
+                    progress->addWindows(computedWindows - rowStartWindows);
+            }
+        }
+        for (int k = 0; k < numberOfSizes; ++k) {
+            workAreas[k].release();
+        }
+        if(timed){
+            phaseTimes->add(GLCM_PHASE, glcmNanoseconds);
+            phaseTimes->add(FEATURES_PHASE, featuresNanoseconds);
+            phaseTimes->addWindows(computedWindows);
+        }
+    });
+
+    return featurePlanes;
+}
@@ -0,0 +1,80 @@
+#ifndef FEATUREEXTRACTOR_WINDOWSWEEPCOMPUTER_H
+#define FEATUREEXTRACTOR_WINDOWSWEEPCOMPUTER_H
+
+#include <vector>
+#include "ProgramArguments.h"
+#include "ImageData.h"
+#include "FeaturePlanes.h"
+#include "SlidingGLCM.h"
+#include "ThreadPool.h"
+#include "Direction.h"
+#include "PhaseTimes.h"
+#include "ProgressReporter.h"
+
+using namespace std;
+
+/**
+ * This class computes the features of an image for many window sizes with a
+ * single traversal of its windows.
+ * The windows of all the sizes that start at the same pixel are nested:
+ * the GLCM of each size is built from the one of the previous size adding
+ * the pairs of the ring between the 2 windows. Moving right by 1 column,
+ * each GLCM is then updated with only the pairs that leave and enter its
+ * window
+ */
+class WindowSweepComputer {
+public:
+    /**
+     * Initialize the class
+     * @param progArg: parameters of the problem
+     * @param windowSizes: sides of the windows, in increasing order
+     * @param workers: threads that will compute the windows
+     * @param phaseTimes: where the time of the windows is added; NULL when
+     * not measured
+     * @param progress: where the computed windows are added, row after row;
+     * NULL when not reported
+     */
+    WindowSweepComputer(const ProgramArguments& progArg,
+            const vector<short int>& windowSizes, ThreadPool& workers,
+            PhaseTimes* phaseTimes = NULL, ProgressReporter* progress = NULL);
+    /**
+     * This method will compute all the features for every window of every
+     * size
+     * @param pixels: pixels intensities of the image provided, bordered for
+     * the largest window
+     * @param img: image metadata
+     * @return the planes of the values of all the windows, for each size
+     */
+    vector<FeaturePlanes> computeAllFeatures(const unsigned int* pixels,
+            const ImageData& img);
+
+private:
+    ProgramArguments progArg;
+    vector<short int> windowSizes;
+    ThreadPool& workers;
+    PhaseTimes* phaseTimes;
+    ProgressReporter* progress;
+    Direction direction;
+    /**
+     * Size of the area of the lowest corners of the pairs of a window, for
+     * each window size
+     */
+    vector<int> boxRows;
+    vector<int> boxColumns;
+    /**
+     * Add (or remove) to the GLCM the pairs whose lowest corner is in the
+     * given area of the image
+     * @param glcm: where the pairs are counted
+     * @param pixels: pixels intensities of the bordered image
+     * @param img: image metadata
+     * @param firstRow, firstColumn: corner of the area
+     * @param rows, columns: size of the area
+     * @param add: true for adding the pairs, false for removing them
+     */
+    void updatePairs(SlidingGLCM& glcm, const unsigned int* pixels,
+            const ImageData& img, int firstRow, int firstColumn, int rows,
+            int columns, bool add) const;
+};
+
+
+#endif //FEATUREEXTRACTOR_WINDOWSWEEPCOMPUTER_H
@@ -1,6 +1,32 @@
 #include <cstdlib>
+#include <new>
 #include "WorkArea.h"
 
+WorkArea WorkArea::allocate(const int numberOfPairsInWindow, FeaturePlanes* out){
+    GrayPair* elements = (GrayPair*) malloc(sizeof(GrayPair)
+            * numberOfPairsInWindow);
+    AggregatedGrayPair* summedPairs = (AggregatedGrayPair*) malloc(sizeof(AggregatedGrayPair)
+            * numberOfPairsInWindow );
+    AggregatedGrayPair* subtractedPairs = (AggregatedGrayPair*) malloc(sizeof(AggregatedGrayPair)
+            * numberOfPairsInWindow);
+    AggregatedGrayPair* xMarginalPairs = (AggregatedGrayPair*) malloc(sizeof(AggregatedGrayPair)
+            * numberOfPairsInWindow);
+    AggregatedGrayPair* yMarginalPairs = (AggregatedGrayPair*) malloc(sizeof(AggregatedGrayPair)
+            * numberOfPairsInWindow);
+    if((elements == NULL) || (summedPairs == NULL) || (subtractedPairs == NULL)
+        || (xMarginalPairs == NULL) || (yMarginalPairs == NULL)){
+        free(elements);
+        free(summedPairs);
+        free(subtractedPairs);
+        free(xMarginalPairs);
+        free(yMarginalPairs);
+        throw bad_alloc();
+    }
+
+    return WorkArea(numberOfPairsInWindow, elements, summedPairs,
+                    subtractedPairs, xMarginalPairs, yMarginalPairs, out);
+}
+
 /*
  * This method is necessary because, at the start of the computation,
  * some of the functions of GLCM class could mistake dirty cells in
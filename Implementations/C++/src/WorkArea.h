@@ -1,8 +1,12 @@
 #ifndef PRE_CUDA_WORKAREA_H
 #define PRE_CUDA_WORKAREA_H
 
+#include <cstdint>
+#include <vector>
 #include "GrayPair.h"
 #include "AggregatedGrayPair.h"
+#include "FeaturePlanes.h"
+#include "PerfCounters.h"
 
 using namespace std;
 
@@ -28,7 +32,7 @@ public:
      * is created for each window of the image
      * @param yMarginalPairs: memory space where the array of y-marginalGrayPairs
      * is created for each window of the image
-     * @param out: memory space where all the features values will be put
+     * @param out: planes where all the features values will be put
      */
     WorkArea(int length,
             GrayPair* grayPairs,
@@ -36,10 +40,21 @@ public:
             AggregatedGrayPair* subtractedPairs,
             AggregatedGrayPair* xMarginalPairs,
             AggregatedGrayPair* yMarginalPairs,
-            double* out):
+            FeaturePlanes* out):
             numberOfElements(length), grayPairs(grayPairs), summedPairs(summedPairs),
             subtractedPairs(subtractedPairs), xMarginalPairs(xMarginalPairs),
-            yMarginalPairs(yMarginalPairs), output(out){};
+            yMarginalPairs(yMarginalPairs), output(out), timed(false),
+            glcmNanoseconds(0), featuresNanoseconds(0), perfCounters(NULL),
+            perfCounts(), countedWindows(0), countedPairs(0){};
+    /**
+     * Allocate the memory that 1 worker needs for computing the glcm of its
+     * windows
+     * @param numberOfPairsInWindow: worst case number of pairs in each window
+     * @param out: planes where the worker will save the results
+     * @return the work area of the worker; release it when done
+     * @throws bad_alloc if the memory is not available
+     */
+    static WorkArea allocate(int numberOfPairsInWindow, FeaturePlanes* out);
     /**
      * Get the arrays to initial state so another window can be processed
      */
@@ -69,13 +84,48 @@ public:
      */
     AggregatedGrayPair* yMarginalPairs;
     /**
-     * memory space where all the features values will be put
+     * planes where all the features values will be put
      */
-    double* output;
+    FeaturePlanes* output;
     /**
      * number of pairs of each window
      */
     int numberOfElements;
+    /**
+     * Measure the time spent on each window; the owner of the work area
+     * collects it from the next fields
+     */
+    bool timed;
+    /**
+     * Time spent building the glcm of the windows, when timed
+     */
+    uint64_t glcmNanoseconds;
+    /**
+     * Time spent extracting the features of the windows, when timed
+     */
+    uint64_t featuresNanoseconds;
+    /**
+     * Hardware counters of the thread that uses the work area; NULL when
+     * the events of the windows aren't counted
+     */
+    PerfCounters* perfCounters;
+    /**
+     * Events counted in each phase of the windows, when counted
+     */
+    uint64_t perfCounts[NUMBER_OF_COUNTED_PHASES][NUMBER_OF_PERF_EVENTS];
+    /**
+     * Glcms (a window in a direction) whose events were counted
+     */
+    uint64_t countedWindows;
+    /**
+     * Pairs of pixels of the glcms whose events were counted
+     */
+    uint64_t countedPairs;
+    /**
+     * Pixels of the tiles at the edge of images with virtual borders,
+     * with the border applied; reused by all the tiles of the worker
+     */
+    vector<unsigned int> haloPixels;
 
 };
 
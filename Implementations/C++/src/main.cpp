@@ -3,16 +3,31 @@
 #include <assert.h>
 #include <fstream>
 #include <chrono> // Performance monitor
+#include <new>
+#include <exception>
 #include "ImageFeatureComputer.h"
+#include "FeatureServer.h"
 
 using namespace std;
 using namespace chrono;
 
 
-int main(int argc, char* argv[]) {
-    cout << argv[0] << endl;
-
-    ProgramArguments pa = ProgramArguments::checkOptions(argc, argv);
+/**
+ * Compute what the options ask for
+ * @param pa: options of the user
+ */
+void run(const ProgramArguments& pa) {
+    if(!pa.servePath.empty()){
+        if(!pa.imagePath.empty() || !pa.batchPath.empty()){
+            cerr << "ERROR! The server (--serve) receives the images from the "
+                    "clients; send them with FeatureClient" << endl;
+            exit(-1);
+        }
+        // Warm workers for the jobs of the local clients
+        FeatureServer server(pa);
+        server.serve();
+        return;
+    }
 
     typedef high_resolution_clock Clock;
     Clock::time_point t1 = high_resolution_clock::now();
@@ -24,6 +39,25 @@ int main(int argc, char* argv[]) {
     Clock::time_point t2 = high_resolution_clock::now();
     duration<double> time_span = duration_cast<duration<double>>(t2 - t1);
     cout << endl << endl << "* Processing took " << time_span.count() << " seconds." << endl;
+    if(!pa.reportPath.empty() || pa.perfCounters)
+        ifc.reportMeasures(time_span.count());
+}
 
+int main(int argc, char* argv[]) {
+    cout << argv[0] << endl;
+
+    ProgramArguments pa = ProgramArguments::checkOptions(argc, argv);
+    try{
+        run(pa);
+    }
+    catch (bad_alloc& e) {
+        cerr << "FATAL ERROR! Not enough mallocable memory on the system" << endl;
+        exit(3);
+    }
+    catch (exception& e) {
+        // Ex. a feature image that OpenCV could not write
+        cerr << "ERROR! " << e.what() << endl;
+        exit(-1);
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+import subprocess
+import re
+import os
+
+# Measure how the CPU version scales with the number of worker threads (-j)
+
+images = ['brain1.tiff', 'prostate1.tiff']
+windowSizes = [5, 15, 33]
+threadCounts = [1, 2, 4, 8, 16, 32]
+repetitions = 3
+
+program = '../Implementations/C++/bin/./FeatureExtractor'
+optionWindowSize = '-w'
+optionInputFile = '-i'
+optionThreads = '-j'
+
+timePattern = re.compile(r'Processing took ([0-9.eE+-]+) seconds')
+
+maxThreads = os.cpu_count()
+
+with open('CPU_SCALING_RESULT.csv', 'w') as file:
+	file.write('image,windowSize,threads,seconds,speedup,efficiency\n')
+
+	for image in images:
+
+		for optionWindowSizeValue in windowSizes:
+
+			serialTime = None
+
+			for threads in threadCounts:
+				if threads > maxThreads:
+					break
+
+				# Keep the best of the repetitions to filter out noise
+				bestTime = None
+				for repetition in range(repetitions):
+					result = subprocess.run([program, optionInputFile, image, optionWindowSize, str(optionWindowSizeValue),
+											 optionThreads, str(threads)], stdout=subprocess.PIPE)
+					output = result.stdout.decode('utf-8')
+					match = timePattern.search(output)
+					if match is None:
+						print('Could not time: ' + subprocess.list2cmdline(result.args))
+						continue
+					elapsed = float(match.group(1))
+					if bestTime is None or elapsed < bestTime:
+						bestTime = elapsed
+
+				if bestTime is None:
+					continue
+				if threads == 1:
+					serialTime = bestTime
+
+				# Without the time on 1 thread there is nothing to compare with
+				if serialTime is None:
+					line = '%s,%d,%d,%f,,' % (image, optionWindowSizeValue, threads, bestTime)
+				else:
+					speedup = serialTime / bestTime
+					efficiency = speedup / threads
+					line = '%s,%d,%d,%f,%.2f,%.2f' % (image, optionWindowSizeValue, threads, bestTime, speedup, efficiency)
+				print(line)
+				file.write(line + '\n')